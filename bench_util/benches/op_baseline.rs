@@ -5,6 +5,7 @@ use deno_bench_util::{bench_js_async, bench_js_sync};
 use deno_core::error::AnyError;
 use deno_core::op_async;
 use deno_core::op_sync;
+use deno_core::op_sync_fast;
 use deno_core::serialize_op_result;
 use deno_core::Extension;
 use deno_core::Op;
@@ -17,6 +18,9 @@ fn setup() -> Vec<Extension> {
   vec![Extension::builder()
     .ops(vec![
       ("pi_json", op_sync(|_, _: (), _: ()| Ok(314159))),
+      ("pi_fast", op_sync_fast(|_, _: (), _: ()| Ok(314159u32))),
+      ("add_json", op_sync(|_, a: u32, b: u32| Ok(a + b))),
+      ("add_fast", op_sync_fast(|_, a: u32, b: u32| Ok(a + b))),
       ("pi_async", op_async(op_pi_async)),
       (
         "nop",
@@ -39,6 +43,18 @@ fn bench_op_pi_json(b: &mut Bencher) {
   bench_js_sync(b, r#"Deno.core.opSync("pi_json", null);"#, setup);
 }
 
+fn bench_op_pi_fast(b: &mut Bencher) {
+  bench_js_sync(b, r#"Deno.core.opSync("pi_fast", null);"#, setup);
+}
+
+fn bench_op_add_json(b: &mut Bencher) {
+  bench_js_sync(b, r#"Deno.core.opSync("add_json", 1, 2);"#, setup);
+}
+
+fn bench_op_add_fast(b: &mut Bencher) {
+  bench_js_sync(b, r#"Deno.core.opSync("add_fast", 1, 2);"#, setup);
+}
+
 fn bench_op_nop(b: &mut Bencher) {
   bench_js_sync(b, r#"Deno.core.opSync("nop", null, null, null);"#, setup);
 }
@@ -47,5 +63,13 @@ fn bench_op_async(b: &mut Bencher) {
   bench_js_async(b, r#"Deno.core.opAsync("pi_async", null);"#, setup);
 }
 
-benchmark_group!(benches, bench_op_pi_json, bench_op_nop, bench_op_async);
+benchmark_group!(
+  benches,
+  bench_op_pi_json,
+  bench_op_pi_fast,
+  bench_op_add_json,
+  bench_op_add_fast,
+  bench_op_nop,
+  bench_op_async
+);
 bench_or_profile!(benches);
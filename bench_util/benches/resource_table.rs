@@ -0,0 +1,84 @@
+use deno_bench_util::bench_or_profile;
+use deno_bench_util::bencher::{benchmark_group, black_box, Bencher};
+
+use deno_core::Resource;
+use deno_core::ResourceId;
+use deno_core::ResourceTable;
+
+// About as many resources as a server with that many open connections has.
+const LIVE_RESOURCES: usize = 50_000;
+const LOOKUPS: usize = 1_000;
+
+struct ConnResource;
+
+impl Resource for ConnResource {}
+
+struct OtherResource;
+
+impl Resource for OtherResource {}
+
+// A table with `LIVE_RESOURCES` resources, after lots of resources have come
+// and gone, and the rids of the live ones in an order that jumps around the
+// table.
+fn setup() -> (ResourceTable, Vec<ResourceId>) {
+  let mut table = ResourceTable::default();
+  let mut rids = Vec::with_capacity(LIVE_RESOURCES);
+  for i in 0..LIVE_RESOURCES * 2 {
+    let rid = table.add(ConnResource);
+    if i % 2 == 0 {
+      table.close(rid);
+    } else {
+      rids.push(rid);
+    }
+  }
+  let rids = (0..LOOKUPS)
+    .map(|i| rids[i * 7919 % LIVE_RESOURCES])
+    .collect();
+  (table, rids)
+}
+
+fn bench_get(b: &mut Bencher) {
+  let (table, rids) = setup();
+  b.iter(|| {
+    for &rid in &rids {
+      black_box(table.get::<ConnResource>(rid));
+    }
+  });
+}
+
+fn bench_get_wrong_type(b: &mut Bencher) {
+  let (table, rids) = setup();
+  b.iter(|| {
+    for &rid in &rids {
+      black_box(table.get::<OtherResource>(rid));
+    }
+  });
+}
+
+fn bench_get_any(b: &mut Bencher) {
+  let (table, rids) = setup();
+  b.iter(|| {
+    for &rid in &rids {
+      black_box(table.get_any(rid));
+    }
+  });
+}
+
+fn bench_add_close(b: &mut Bencher) {
+  let (mut table, _) = setup();
+  b.iter(|| {
+    for _ in 0..LOOKUPS {
+      let rid = table.add(ConnResource);
+      table.close(black_box(rid));
+    }
+  });
+}
+
+benchmark_group!(
+  benches,
+  bench_get,
+  bench_get_wrong_type,
+  bench_get_any,
+  bench_add_close
+);
+bench_or_profile!(benches);
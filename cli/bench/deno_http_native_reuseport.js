@@ -0,0 +1,48 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+
+// Like `deno_http_native.js`, but served by a number of workers that each
+// listen on the same address with `reusePort`, so that the kernel spreads
+// the connections over them.
+
+const WORKER_NAME = "deno_http_native_reuseport";
+
+async function serve(addr) {
+  const [hostname, port] = addr.split(":");
+  const listener = Deno.listen({
+    hostname,
+    port: Number(port),
+    reusePort: true,
+  });
+
+  const encoder = new TextEncoder();
+  const body = encoder.encode("Hello World");
+
+  for await (const conn of listener) {
+    (async () => {
+      const requests = Deno.serveHttp(conn);
+      for await (const { respondWith } of requests) {
+        try {
+          respondWith(new Response(body));
+        } catch {
+          // Ignore.
+        }
+      }
+    })();
+  }
+}
+
+if (self.name === WORKER_NAME) {
+  self.onmessage = (e) => serve(e.data);
+} else {
+  const addr = Deno.args[0] || "127.0.0.1:4500";
+  const workers = Number(Deno.args[1] || 1);
+  for (let i = 0; i < workers; i++) {
+    const worker = new Worker(import.meta.url, {
+      name: WORKER_NAME,
+      type: "module",
+      deno: { namespace: true },
+    });
+    worker.postMessage(addr);
+  }
+  console.log("Server listening on", addr, "with", workers, "workers");
+}
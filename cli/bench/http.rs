@@ -12,6 +12,8 @@ pub use test_util::{parse_wrk_output, WrkOutput as HttpBenchmarkResult};
 
 const DURATION: &str = "20s";
 
+const REUSEPORT_WORKERS: &[usize] = &[1, 2, 4];
+
 pub(crate) fn benchmark(
   target_path: &Path,
 ) -> Result<HashMap<String, HttpBenchmarkResult>> {
@@ -31,6 +33,14 @@ pub(crate) fn benchmark(
   // res.insert("deno_udp".to_string(), deno_udp(deno_exe)?);
   res.insert("deno_http".to_string(), deno_http(deno_exe)?);
   res.insert("deno_http_native".to_string(), deno_http_native(deno_exe)?);
+  // Shows how the native http server scales with the number of workers that
+  // share the listening address.
+  for workers in REUSEPORT_WORKERS {
+    res.insert(
+      format!("deno_http_native_reuseport_{}", workers),
+      deno_http_native_reuseport(deno_exe, *workers)?,
+    );
+  }
   // TODO(ry) deno_proxy disabled to make fetch() standards compliant.
   // res.insert("deno_proxy".to_string(), deno_http_proxy(deno_exe) hyper_hello_exe))
   res.insert(
@@ -194,6 +204,33 @@ fn deno_http(deno_exe: &str) -> Result<HttpBenchmarkResult> {
   )
 }
 
+fn deno_http_native_reuseport(
+  deno_exe: &str,
+  workers: usize,
+) -> Result<HttpBenchmarkResult> {
+  let port = get_port();
+  println!(
+    "http_benchmark testing DENO using native bindings with {} workers.",
+    workers
+  );
+  run(
+    &[
+      deno_exe,
+      "run",
+      "--allow-net",
+      "--allow-read",
+      "--reload",
+      "--unstable",
+      "cli/bench/deno_http_native_reuseport.js",
+      &server_addr(port),
+      &workers.to_string(),
+    ],
+    port,
+    None,
+    None,
+  )
+}
+
 fn deno_http_native(deno_exe: &str) -> Result<HttpBenchmarkResult> {
   let port = get_port();
   println!("http_benchmark testing DENO using native bindings.");
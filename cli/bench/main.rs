@@ -50,6 +50,21 @@ const EXEC_TIME_BENCHMARKS: &[(&str, &[&str], Option<i32>)] = &[
     &["run", "cli/tests/003_relative_import.ts"],
     None,
   ),
+  // Same as the two above, but without the V8 code cache, to track how much
+  // of warm startup is spent compiling emitted JS.
+  (
+    "hello_no_code_cache",
+    &["run", "--no-code-cache", "cli/tests/002_hello.ts"],
+    None,
+  ),
+  (
+    "relative_import_no_code_cache",
+    &["run", "--no-code-cache", "cli/tests/003_relative_import.ts"],
+    None,
+  ),
+  // Loads the lazy WebGPU extension, so that comparing it to "hello" shows
+  // the startup time and memory that loading it lazily saves.
+  ("hello_webgpu", &["run", "cli/tests/webgpu_load.js"], None),
   ("error_001", &["run", "cli/tests/error_001.ts"], Some(1)),
   (
     "no_check_hello",
@@ -70,6 +85,26 @@ const EXEC_TIME_BENCHMARKS: &[(&str, &[&str], Option<i32>)] = &[
     ],
     None,
   ),
+  (
+    "workers_pool_round_robin",
+    &[
+      "run",
+      "--allow-read",
+      "--unstable",
+      "cli/tests/workers/bench_pool_round_robin.ts",
+    ],
+    None,
+  ),
+  (
+    "workers_shared_channel",
+    &[
+      "run",
+      "--allow-read",
+      "--unstable",
+      "cli/tests/workers/bench_shared_channel.ts",
+    ],
+    None,
+  ),
   (
     "workers_large_message",
     &[
@@ -129,12 +164,94 @@ const EXEC_TIME_BENCHMARKS: &[(&str, &[&str], Option<i32>)] = &[
   ),
 ];
 
+/// The number of modules in the synthetic graph of the `*_large_graph`
+/// benchmarks.
+const LARGE_GRAPH_MODULES: usize = 3000;
+
+/// Writes a graph of `LARGE_GRAPH_MODULES` TypeScript modules to `dir` and
+/// returns the path of its root. Module `n` imports modules `2n + 1` and
+/// `2n + 2`, so the graph is a balanced tree.
+fn generate_large_graph(dir: &Path) -> Result<PathBuf> {
+  fs::create_dir_all(dir)?;
+  for n in 0..LARGE_GRAPH_MODULES {
+    let mut source = String::new();
+    for child in &[2 * n + 1, 2 * n + 2] {
+      if *child < LARGE_GRAPH_MODULES {
+        source.push_str(&format!(
+          "import {{ Value{0} }} from \"./mod_{0}.ts\";\nexport {{ Value{0} }};\n",
+          child
+        ));
+      }
+    }
+    source.push_str(&format!(
+      r#"
+export interface Shape{n} {{
+  readonly id: number;
+  name?: string;
+}}
+
+export class Value{n}<T extends Shape{n}> {{
+  #items: T[] = [];
+  constructor(private readonly label: string) {{}}
+
+  add(item: T): this {{
+    this.#items.push(item);
+    return this;
+  }}
+
+  find(id: number): T | undefined {{
+    return this.#items.find((item) => item.id === id);
+  }}
+
+  get description(): string {{
+    return `${{this.label}}: ${{this.#items.length}} items`;
+  }}
+}}
+
+export enum Kind{n} {{
+  A = "a",
+  B = "b",
+}}
+"#,
+      n = n
+    ));
+    fs::write(dir.join(format!("mod_{}.ts", n)), source)?;
+  }
+  let root = dir.join("mod.ts");
+  fs::write(
+    &root,
+    "import { Value0 } from \"./mod_0.ts\";\nconsole.log(Value0.name);\n",
+  )?;
+  Ok(root)
+}
+
 const RESULT_KEYS: &[&str] =
   &["mean", "stddev", "user", "system", "min", "max"];
 fn run_exec_time(
   deno_exe: &Path,
   target_dir: &Path,
 ) -> Result<HashMap<String, HashMap<String, f64>>> {
+  // Transpiling a large graph, cold and then with all the emits cached.
+  let large_graph = generate_large_graph(&target_dir.join("large_graph"))?;
+  let large_graph = large_graph.to_str().unwrap();
+  let large_graph_benchmarks = vec![
+    (
+      "cold_no_check_large_graph",
+      vec!["cache", "--reload", "--no-check", large_graph],
+      None,
+    ),
+    (
+      "no_check_large_graph",
+      vec!["cache", "--no-check", large_graph],
+      None,
+    ),
+  ];
+  let benchmarks: Vec<(&str, Vec<&str>, Option<i32>)> = EXEC_TIME_BENCHMARKS
+    .iter()
+    .map(|(name, args, return_code)| (*name, args.to_vec(), *return_code))
+    .chain(large_graph_benchmarks)
+    .collect();
+
   let hyperfine_exe = test_util::prebuilt_tool_path("hyperfine");
 
   let benchmark_file = target_dir.join("hyperfine_results.json");
@@ -151,7 +268,7 @@ fn run_exec_time(
   .map(|s| s.to_string())
   .collect::<Vec<_>>();
 
-  for (_, args, return_code) in EXEC_TIME_BENCHMARKS {
+  for (_, args, return_code) in &benchmarks {
     let ret_code_test = if let Some(code) = return_code {
       // Bash test which asserts the return code value of the previous command
       // $? contains the return code of the previous command
@@ -177,7 +294,7 @@ fn run_exec_time(
 
   let mut results = HashMap::<String, HashMap<String, f64>>::new();
   let hyperfine_results = read_json(benchmark_file)?;
-  for ((name, _, _), data) in EXEC_TIME_BENCHMARKS.iter().zip(
+  for ((name, _, _), data) in benchmarks.iter().zip(
     hyperfine_results
       .as_object()
       .unwrap()
@@ -311,6 +428,14 @@ fn run_throughput(deno_exe: &Path) -> Result<HashMap<String, f64>> {
   m.insert("100M_cat".to_string(), throughput::cat(deno_exe, 100));
   m.insert("10M_tcp".to_string(), throughput::tcp(deno_exe, 10)?);
   m.insert("10M_cat".to_string(), throughput::cat(deno_exe, 10));
+  m.insert(
+    "100M_read_file".to_string(),
+    throughput::read_file(deno_exe, 100, false),
+  );
+  m.insert(
+    "100M_read_text_file".to_string(),
+    throughput::read_file(deno_exe, 100, true),
+  );
 
   Ok(m)
 }
@@ -478,6 +603,14 @@ fn main() -> Result<()> {
   if cfg!(not(target_os = "windows")) {
     new_data.throughput = run_throughput(&deno_exe)?;
     run_http(&target_dir, &mut new_data)?;
+    new_data.max_latency.insert(
+      "timer_under_tcp_load".to_string(),
+      throughput::timer_latency(&deno_exe, None)?,
+    );
+    new_data.max_latency.insert(
+      "timer_under_tcp_load_op_budget".to_string(),
+      throughput::timer_latency(&deno_exe, Some(64))?,
+    );
   }
 
   if cfg!(target_os = "linux") {
@@ -1,6 +1,7 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
 use super::Result;
+use deno_core::serde_json;
 use std::{
   path::Path,
   process::Command,
@@ -28,6 +29,52 @@ pub(crate) fn cat(deno_exe: &Path, megs: usize) -> f64 {
   (end - start).as_secs_f64()
 }
 
+/// Reads a file of `megs` MiB with `Deno.readFile`, or `Deno.readTextFile`
+/// when `text` is set.
+pub(crate) fn read_file(deno_exe: &Path, megs: usize, text: bool) -> f64 {
+  let temp_dir = tempfile::TempDir::new().unwrap();
+  let path = temp_dir.path().join("read_file.txt");
+  std::fs::write(&path, "a".repeat(megs * MB)).unwrap();
+
+  let mut args = vec!["run", "--allow-read", "cli/tests/read_file.ts"];
+  if text {
+    args.push("--text");
+  }
+  args.push(path.to_str().unwrap());
+  println!("{} {}", deno_exe.display(), args.join(" "));
+
+  let start = Instant::now();
+  let status = Command::new(deno_exe).args(&args).status().unwrap();
+  let end = Instant::now();
+  assert!(status.success());
+
+  (end - start).as_secs_f64()
+}
+
+/// Runs a 10ms interval timer while bulk data is sent over loopback TCP, and
+/// returns the 99th percentile of how late it fired, in milliseconds. With
+/// `op_budget`, the number of op completions per event loop turn is capped.
+pub(crate) fn timer_latency(
+  deno_exe: &Path,
+  op_budget: Option<usize>,
+) -> Result<f64> {
+  let mut command = Command::new(deno_exe);
+  command.args(&[
+    "run",
+    "--allow-net",
+    "--unstable",
+    "cli/tests/timer_latency_perf.js",
+  ]);
+  if let Some(op_budget) = op_budget {
+    command.env("DENO_UNSTABLE_OP_BUDGET", op_budget.to_string());
+  }
+  let output = command.output()?;
+  assert!(output.status.success());
+  let stats: serde_json::Value = serde_json::from_slice(&output.stdout)?;
+  println!("timer latency with op budget {:?}: {}", op_budget, stats);
+  Ok(stats["p99"].as_f64().unwrap())
+}
+
 pub(crate) fn tcp(deno_exe: &Path, megs: usize) -> Result<f64> {
   let size = megs * MB;
 
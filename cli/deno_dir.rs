@@ -1,6 +1,7 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
 use crate::disk_cache::DiskCache;
+use crate::packed_cache::PackedCache;
 use std::path::PathBuf;
 
 /// `DenoDir` serves as coordinator for multiple `DiskCache`s containing them
@@ -34,11 +35,12 @@ impl DenoDir {
     };
     assert!(root.is_absolute());
     let gen_path = root.join("gen");
-
-    let deno_dir = Self {
-      root,
-      gen_cache: DiskCache::new(&gen_path),
+    let gen_cache = match PackedCache::from_env(&gen_path) {
+      Some(pack) => DiskCache::new_packed(&gen_path, pack),
+      None => DiskCache::new(&gen_path),
     };
+
+    let deno_dir = Self { root, gen_cache };
     deno_dir.gen_cache.ensure_dir_exists(&gen_path)?;
 
     Ok(deno_dir)
@@ -37,6 +37,7 @@ const UNSTABLE_DENO_PROPS: &[&str] = &[
   "ResolveDnsOptions",
   "SRVRecord",
   "SetRawOptions",
+  "SharedChannel",
   "Signal",
   "SignalStream",
   "StartTlsOptions",
@@ -44,6 +45,8 @@ const UNSTABLE_DENO_PROPS: &[&str] = &[
   "SystemMemoryInfo",
   "UnixConnectOptions",
   "UnixListenOptions",
+  "WorkerPool",
+  "WorkerPoolOptions",
   "applySourceMap",
   "connect",
   "consoleSize",
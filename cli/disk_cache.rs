@@ -2,6 +2,8 @@
 
 use crate::fs_util;
 use crate::http_cache::url_to_filename;
+use crate::packed_cache::PackedCache;
+use deno_core::error::AnyError;
 use deno_core::url::{Host, Url};
 use std::ffi::OsStr;
 use std::fs;
@@ -15,6 +17,8 @@ use std::str;
 #[derive(Clone)]
 pub struct DiskCache {
   pub location: PathBuf,
+  /// If set, files are stored in this packed cache instead of in `location`.
+  maybe_pack: Option<PackedCache>,
 }
 
 fn with_io_context<T: AsRef<str>>(
@@ -24,12 +28,25 @@ fn with_io_context<T: AsRef<str>>(
   std::io::Error::new(e.kind(), format!("{} (for '{}')", e, context.as_ref()))
 }
 
+fn packed_io_error(err: AnyError) -> std::io::Error {
+  io::Error::new(io::ErrorKind::Other, err.to_string())
+}
+
 impl DiskCache {
   /// `location` must be an absolute path.
   pub fn new(location: &Path) -> Self {
     assert!(location.is_absolute());
     Self {
       location: location.to_owned(),
+      maybe_pack: None,
+    }
+  }
+
+  /// Like `new`, but stores the files in `pack` instead of in `location`.
+  pub fn new_packed(location: &Path, pack: PackedCache) -> Self {
+    Self {
+      maybe_pack: Some(pack),
+      ..Self::new(location)
     }
   }
 
@@ -131,13 +148,43 @@ impl DiskCache {
     }
   }
 
+  /// Returns where the cache is stored: `location`, or the database of the
+  /// packed cache.
+  pub fn get_storage_path(&self) -> PathBuf {
+    match &self.maybe_pack {
+      Some(pack) => pack.path().to_owned(),
+      None => self.location.clone(),
+    }
+  }
+
+  /// Returns where the file at `filename` is stored, to show to the user. For
+  /// a packed cache, this is its entry in the database.
+  pub fn get_storage_filename(&self, filename: &Path) -> PathBuf {
+    let path = self.location.join(filename);
+    match &self.maybe_pack {
+      Some(pack) => pack.entry_path(&path),
+      None => path,
+    }
+  }
+
   pub fn get(&self, filename: &Path) -> std::io::Result<Vec<u8>> {
     let path = self.location.join(filename);
+    if let Some(pack) = &self.maybe_pack {
+      return pack
+        .get(&path)
+        .map_err(packed_io_error)?
+        .ok_or_else(|| io::Error::from(io::ErrorKind::NotFound));
+    }
     fs::read(&path)
   }
 
   pub fn set(&self, filename: &Path, data: &[u8]) -> std::io::Result<()> {
     let path = self.location.join(filename);
+    if let Some(pack) = &self.maybe_pack {
+      return pack.set(&[(path.as_path(), data)]).map_err(|e| {
+        with_io_context(&packed_io_error(e), format!("{:#?}", &path))
+      });
+    }
     match path.parent() {
       Some(ref parent) => self.ensure_dir_exists(parent),
       None => Ok(()),
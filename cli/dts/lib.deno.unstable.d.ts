@@ -942,8 +942,86 @@ declare namespace Deno {
 
   export interface Metrics extends OpMetrics {
     ops: Record<string, OpMetrics>;
+    /** Only present when `perOp: true` is passed to `Deno.metrics()`. */
+    perOp?: Record<string, OpHistograms>;
+    eventLoop: EventLoopMetrics;
   }
 
+  /** **UNSTABLE**: new API, yet to be vetted.
+   *
+   * Where the event loop spends its time. Times are in nanoseconds.
+   */
+  export interface EventLoopMetrics {
+    turns: number;
+    /** The duration of each turn of the event loop, which is how long
+     * anything that becomes ready during a turn waits for the loop. */
+    lag: Histogram;
+    /** The total time spent in each phase of the turns. */
+    phases: {
+      v8MessageLoop: number;
+      pollOps: number;
+      opResponses: number;
+      macrotasks: number;
+      promiseExceptions: number;
+      dynImports: number;
+      moduleEvaluation: number;
+    };
+    /** The number of async op completions delivered to JS per turn, for the
+     * turns that delivered any. */
+    opsPerTurn: Histogram;
+    /** The number of turns that left op completions for later turns because
+     * they ran out of the budget set with `DENO_UNSTABLE_OP_BUDGET`. */
+    opBudgetExhaustedTurns: number;
+  }
+
+  /** **UNSTABLE**: new API, yet to be vetted.
+   *
+   * Latency and size distributions of a single op. Times are in nanoseconds.
+   */
+  export interface OpHistograms {
+    syncTime: Histogram;
+    asyncTime: Histogram;
+    bytesSent: Histogram;
+  }
+
+  /** **UNSTABLE**: new API, yet to be vetted.
+   *
+   * A histogram with logarithmic buckets. Percentiles are accurate to within
+   * 12.5% of the recorded values. */
+  export interface Histogram {
+    count: number;
+    min: number;
+    max: number;
+    mean: number;
+    p50: number;
+    p90: number;
+    p99: number;
+    p999: number;
+    /** Non-empty buckets as `[lowerBound, count]` pairs. */
+    buckets: [number, number][];
+  }
+
+  export interface MetricsOptions {
+    /** Also return latency and size histograms for each op. Histograms are
+     * only recorded from the first call with this option onwards, so that
+     * they cost nothing unless they are used. */
+    perOp?: boolean;
+  }
+
+  /** **UNSTABLE**: new option, yet to be vetted.
+   *
+   * Receive metrics from the privileged side of Deno, optionally with
+   * per-op histograms.
+   *
+   * ```ts
+   * Deno.metrics({ perOp: true });
+   * await Deno.readFile("./hello.txt");
+   * const { perOp } = Deno.metrics({ perOp: true });
+   * console.log(perOp!["op_read_async"].asyncTime.p99);
+   * ```
+   */
+  export function metrics(options?: MetricsOptions): Metrics;
+
   export interface OpMetrics {
     opsDispatched: number;
     opsDispatchedSync: number;
@@ -1100,6 +1178,16 @@ declare namespace Deno {
     };
   }
 
+  export interface ServeHttpOptions {
+    /** Streamed response bodies are collected until this many bytes were
+     * written, or the stream ends, before they are sent to the connection.
+     * This saves system calls for bodies that are made of many small chunks,
+     * but delays the chunks until enough of them are there.
+     *
+     * Defaults to 0, which sends every chunk as soon as possible. */
+    responseBodyBufferSize?: number;
+  }
+
   /** **UNSTABLE**: new API, yet to be vetted.
    *
    * Services HTTP requests given a TCP or TLS socket.
@@ -1116,7 +1204,108 @@ declare namespace Deno {
    * If `httpConn.nextRequest()` encounters an error or returns `null`
    * then the underlying HttpConn resource is closed automatically.
    */
-  export function serveHttp(conn: Conn): HttpConn;
+  export function serveHttp(conn: Conn, options?: ServeHttpOptions): HttpConn;
+
+  export interface WorkerPoolOptions extends WorkerOptions {
+    /** The number of workers in the pool. Defaults to 4. */
+    size?: number;
+  }
+
+  /** **UNSTABLE**: new API, yet to be vetted.
+   *
+   * A fixed number of workers that run the same module and are reused across
+   * tasks, so a worker is only created and bootstrapped once. A task is a
+   * message posted to an idle worker, and its result is the data of the next
+   * message that worker posts back. Tasks are queued while all workers are
+   * busy.
+   *
+   * ```ts
+   * // thumbnail_worker.ts
+   * self.onmessage = (e) => {
+   *   self.postMessage(makeThumbnail(e.data));
+   * };
+   *
+   * // mod.ts
+   * const pool = new Deno.WorkerPool(
+   *   new URL("thumbnail_worker.ts", import.meta.url).href,
+   *   { type: "module", size: 8 },
+   * );
+   * const thumbnails = await Promise.all(images.map((i) => pool.run(i)));
+   * pool.terminate();
+   * ```
+   *
+   * A worker that throws an uncaught error rejects its current task and is
+   * replaced. Like workers, a pool keeps the program alive until it is
+   * terminated.
+   */
+  export class WorkerPool {
+    constructor(specifier: string | URL, options?: WorkerPoolOptions);
+    readonly size: number;
+    /** Runs a task on the next idle worker. */
+    run<T = any>(message: any, transfer?: Transferable[]): Promise<T>;
+    /** Terminates all workers and rejects the tasks that haven't finished. */
+    terminate(): void;
+  }
+
+  /** **UNSTABLE**: new API, yet to be vetted.
+   *
+   * A channel of byte messages between workers, backed by a ring buffer in a
+   * `SharedArrayBuffer`. Sending and receiving only touch shared memory and
+   * block with `Atomics.wait`, so messages don't go through the event loop of
+   * either worker. This makes it much faster than `postMessage` for many
+   * small messages, at the cost of blocking the receiving worker while it
+   * waits.
+   *
+   * Any number of workers may send on a channel, but only one may receive.
+   * The other end is opened by posting `buffer` to a worker and passing it to
+   * the constructor there.
+   *
+   * ```ts
+   * // mod.ts
+   * const channel = new Deno.SharedChannel();
+   * worker.postMessage(channel.buffer);
+   * channel.send(new TextEncoder().encode("hello"));
+   * channel.close();
+   *
+   * // worker.ts
+   * self.onmessage = async (e) => {
+   *   const channel = new Deno.SharedChannel(e.data);
+   *   let message;
+   *   while ((message = await channel.recv()) !== null) {
+   *     console.log(new TextDecoder().decode(message));
+   *   }
+   * };
+   * ```
+   */
+  export class SharedChannel {
+    /** Creates a channel with room for `capacity` bytes of messages, which
+     * must be a power of two (64 KiB by default), or opens the channel that
+     * `buffer` belongs to. Each message takes 4 bytes more than its length,
+     * rounded up to a multiple of 4. */
+    constructor(capacityOrBuffer?: number | SharedArrayBuffer);
+    readonly buffer: SharedArrayBuffer;
+    readonly capacity: number;
+    readonly closed: boolean;
+    /** Sends a message, blocking until there is room for it. Returns `false`
+     * if there is still no room after `timeout` milliseconds, and throws if
+     * the channel is closed. */
+    send(data: Uint8Array, timeout?: number): boolean;
+    /** Sends a message if there is room for it right away. */
+    trySend(data: Uint8Array): boolean;
+    /** Receives the next message, waiting until there is one. Resolves with
+     * `null` if the channel is closed and all messages have been received, or
+     * if no message arrives within `timeout` milliseconds. Timers, I/O and
+     * messages are still handled while it waits. */
+    recv(timeout?: number): Promise<Uint8Array | null>;
+    /** Like `recv()`, but blocks the worker until there is a message. This is
+     * faster when messages arrive in quick succession, but nothing else can
+     * run on the worker while it waits. */
+    recvSync(timeout?: number): Uint8Array | null;
+    /** Receives the next message if there is one. */
+    tryRecv(): Uint8Array | null;
+    /** Closes the channel for senders and the receiver on all workers. */
+    close(): void;
+  }
 }
 
 declare function fetch(
@@ -4,9 +4,9 @@ use crate::auth_tokens::AuthTokens;
 use crate::colors;
 use crate::http_cache::HttpCache;
 use crate::http_util::create_http_client;
-use crate::http_util::fetch_once;
 use crate::http_util::FetchOnceArgs;
 use crate::http_util::FetchOnceResult;
+use crate::http_util::HostScheduler;
 use crate::media_type::MediaType;
 use crate::text_encoding;
 use crate::version::get_user_agent;
@@ -16,20 +16,25 @@ use deno_core::error::generic_error;
 use deno_core::error::uri_error;
 use deno_core::error::AnyError;
 use deno_core::futures;
+use deno_core::futures::future::BoxFuture;
 use deno_core::futures::future::FutureExt;
+use deno_core::futures::future::Shared;
 use deno_core::parking_lot::Mutex;
+use deno_core::resolve_import;
 use deno_core::ModuleSpecifier;
 use deno_runtime::deno_fetch::reqwest;
 use deno_runtime::deno_web::BlobStore;
+use deno_runtime::permissions::PermissionState;
 use deno_runtime::permissions::Permissions;
 use log::debug;
 use log::info;
+use regex::Regex;
 use std::borrow::Borrow;
 use std::collections::HashMap;
 use std::env;
+use std::fmt;
 use std::fs;
 use std::future::Future;
-use std::io::Read;
 use std::path::PathBuf;
 use std::pin::Pin;
 use std::sync::Arc;
@@ -38,6 +43,15 @@ static DENO_AUTH_TOKENS: &str = "DENO_AUTH_TOKENS";
 pub const SUPPORTED_SCHEMES: [&str; 5] =
   ["data", "blob", "file", "http", "https"];
 
+lazy_static::lazy_static! {
+  /// Matches the specifiers of static import and export declarations that
+  /// start a line or follow a semicolon. This is a cheap approximation of
+  /// parsing the module, used to decide which modules to prefetch.
+  static ref STATIC_IMPORT_RE: Regex = Regex::new(
+    r#"(?m)(?:^|;)\s*(?:import|export)(?:\s+[^"';]*?\bfrom)?\s*["']([^"'\n]+)["']"#
+  ).unwrap();
+}
+
 /// A structure representing a source file.
 #[derive(Debug, Clone, Eq, PartialEq)]
 pub struct File {
@@ -74,6 +88,38 @@ impl FileCache {
   }
 }
 
+/// The response to a prefetch. It is only logged and written to the HTTP
+/// cache by the `fetch` that claims it, so prefetching a module that ends up
+/// not being imported leaves no trace.
+#[derive(Debug)]
+enum Prefetched {
+  Code(Vec<u8>, HashMap<String, String>),
+  Redirect(ModuleSpecifier, HashMap<String, String>),
+}
+
+type PrefetchFuture = Shared<BoxFuture<'static, Option<Arc<Prefetched>>>>;
+
+/// Remote modules that are being fetched before they have been requested,
+/// because a pre-scan of another module found that it imports them. A
+/// prefetch stays here until `fetch` claims it, or until it fails.
+#[derive(Clone, Default)]
+struct Prefetches(Arc<Mutex<HashMap<ModuleSpecifier, PrefetchFuture>>>);
+
+impl fmt::Debug for Prefetches {
+  fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+    write!(f, "Prefetches {{ }}")
+  }
+}
+
+/// Returns the specifiers of the static imports and re-exports of a module,
+/// as they are written in its source.
+fn scan_imports(source: &str) -> impl Iterator<Item = &str> {
+  STATIC_IMPORT_RE
+    .captures_iter(source)
+    .filter_map(|captures| captures.get(1))
+    .map(|m| m.as_str())
+}
+
 /// Indicates how cached source files should be handled.
 #[derive(Debug, Clone, Eq, PartialEq)]
 pub enum CacheSetting {
@@ -212,6 +258,8 @@ pub struct FileFetcher {
   cache_setting: CacheSetting,
   http_cache: HttpCache,
   http_client: reqwest::Client,
+  host_scheduler: HostScheduler,
+  prefetches: Prefetches,
   blob_store: BlobStore,
 }
 
@@ -230,6 +278,8 @@ impl FileFetcher {
       cache_setting,
       http_cache,
       http_client: create_http_client(get_user_agent(), ca_data)?,
+      host_scheduler: Default::default(),
+      prefetches: Default::default(),
       blob_store,
     })
   }
@@ -244,7 +294,7 @@ impl FileFetcher {
     let local =
       self
         .http_cache
-        .get_cache_filename(specifier)
+        .get_storage_filename(specifier)
         .ok_or_else(|| {
           generic_error("Cannot convert specifier to cached filename.")
         })?;
@@ -281,7 +331,7 @@ impl FileFetcher {
       return Err(custom_error("Http", "Too many redirects."));
     }
 
-    let (mut source_file, headers) = match self.http_cache.get(specifier) {
+    let (bytes, headers) = match self.http_cache.get(specifier) {
       Err(err) => {
         if let Some(err) = err.downcast_ref::<std::io::Error>() {
           if err.kind() == std::io::ErrorKind::NotFound {
@@ -297,8 +347,6 @@ impl FileFetcher {
         deno_core::resolve_import(redirect_to, specifier.as_str())?;
       return self.fetch_cached(&redirect, redirect_limit - 1);
     }
-    let mut bytes = Vec::new();
-    source_file.read_to_end(&mut bytes)?;
     let file = self.build_remote_file(specifier, bytes, &headers)?;
 
     Ok(Some(file))
@@ -342,7 +390,7 @@ impl FileFetcher {
     let local =
       self
         .http_cache
-        .get_cache_filename(specifier)
+        .get_storage_filename(specifier)
         .ok_or_else(|| {
           generic_error("Cannot convert specifier to cached filename.")
         })?;
@@ -403,7 +451,7 @@ impl FileFetcher {
     let local =
       self
         .http_cache
-        .get_cache_filename(specifier)
+        .get_storage_filename(specifier)
         .ok_or_else(|| {
           generic_error("Cannot convert specifier to cached filename.")
         })?;
@@ -476,13 +524,15 @@ impl FileFetcher {
     let file_fetcher = self.clone();
     // A single pass of fetch either yields code or yields a redirect.
     async move {
-      match fetch_once(FetchOnceArgs {
-        client,
-        url: specifier.clone(),
-        maybe_etag,
-        maybe_auth_token,
-      })
-      .await?
+      match file_fetcher
+        .host_scheduler
+        .fetch_once(FetchOnceArgs {
+          client,
+          url: specifier.clone(),
+          maybe_etag,
+          maybe_auth_token,
+        })
+        .await?
       {
         FetchOnceResult::NotModified => {
           let file = file_fetcher.fetch_cached(&specifier, 10)?.unwrap();
@@ -540,7 +590,22 @@ impl FileFetcher {
         format!("A remote specifier was requested: \"{}\", but --no-remote is specified.", specifier),
       ))
     } else {
-      let result = self.fetch_remote(specifier, permissions, 10).await;
+      let maybe_prefetch = self.prefetches.0.lock().get(specifier).cloned();
+      let maybe_prefetched = match maybe_prefetch {
+        Some(prefetch) => prefetch.await,
+        None => None,
+      };
+      // If the prefetch failed, the module is fetched again so that the error
+      // is reported for this request.
+      let result = match maybe_prefetched {
+        Some(prefetched) => {
+          self.prefetches.0.lock().remove(specifier);
+          self
+            .claim_prefetched(specifier, &prefetched, permissions)
+            .await
+        }
+        None => self.fetch_remote(specifier, permissions, 10).await,
+      };
       if let Ok(file) = &result {
         self.cache.insert(specifier.clone(), file.clone());
       }
@@ -548,9 +613,128 @@ impl FileFetcher {
     }
   }
 
+  /// Logs and caches a module that a prefetch downloaded, like
+  /// `fetch_remote` does for the modules it downloads itself.
+  async fn claim_prefetched(
+    &self,
+    specifier: &ModuleSpecifier,
+    prefetched: &Prefetched,
+    permissions: &mut Permissions,
+  ) -> Result<File, AnyError> {
+    info!("{} {}", colors::green("Download"), specifier);
+    match prefetched {
+      Prefetched::Code(bytes, headers) => {
+        self.http_cache.set(specifier, headers.clone(), bytes)?;
+        self.build_remote_file(specifier, bytes.clone(), headers)
+      }
+      Prefetched::Redirect(redirect_url, headers) => {
+        self.http_cache.set(specifier, headers.clone(), &[])?;
+        self.fetch_remote(redirect_url, permissions, 9).await
+      }
+    }
+  }
+
+  /// Starts fetching the remote modules that `file` statically imports in the
+  /// background, found by a cheap scan of its source instead of parsing it,
+  /// so that they are downloaded while the module is being parsed. Prefetched
+  /// modules are prefetched the same way in turn, and are kept in memory
+  /// until `fetch` picks them up.
+  ///
+  /// Only modules from hosts that the permissions already grant access to
+  /// are prefetched, so prefetching never prompts.
+  ///
+  /// Returns the futures of the prefetches that were started or are already
+  /// in flight, which don't have to be awaited.
+  pub fn prefetch_imports(
+    &self,
+    file: &File,
+    permissions: &Permissions,
+  ) -> Vec<PrefetchFuture> {
+    if !self.allow_remote
+      || self.cache_setting == CacheSetting::Only
+      || tokio::runtime::Handle::try_current().is_err()
+    {
+      return Vec::new();
+    }
+    scan_imports(&file.source)
+      .filter_map(|s| resolve_import(s, file.specifier.as_str()).ok())
+      .filter(|s| s.scheme() == "http" || s.scheme() == "https")
+      .filter(|s| permissions.net.query_url(s) == PermissionState::Granted)
+      .filter_map(|s| self.prefetch(s, permissions))
+      .collect()
+  }
+
+  fn prefetch(
+    &self,
+    specifier: ModuleSpecifier,
+    permissions: &Permissions,
+  ) -> Option<PrefetchFuture> {
+    if self.cache.get(&specifier).is_some() {
+      return None;
+    }
+    let mut prefetches = self.prefetches.0.lock();
+    if let Some(prefetch) = prefetches.get(&specifier) {
+      return Some(prefetch.clone());
+    }
+
+    let file_fetcher = self.clone();
+    let permissions = permissions.clone();
+    let requested_specifier = specifier.clone();
+    let prefetch = async move {
+      let specifier = requested_specifier;
+      // A module that `fetch` would load from the disk cache isn't
+      // downloaded, but its imports may not be cached.
+      if file_fetcher.cache_setting.should_use(&specifier) {
+        if let Ok(Some(file)) = file_fetcher.fetch_cached(&specifier, 10) {
+          file_fetcher.prefetch_imports(&file, &permissions);
+          file_fetcher.prefetches.0.lock().remove(&specifier);
+          return None;
+        }
+      }
+      let result = file_fetcher
+        .host_scheduler
+        .fetch_once(FetchOnceArgs {
+          client: file_fetcher.http_client.clone(),
+          url: specifier.clone(),
+          maybe_etag: None,
+          maybe_auth_token: file_fetcher.auth_tokens.get(&specifier),
+        })
+        .await;
+      let maybe_prefetched = match result {
+        Ok(FetchOnceResult::Code(bytes, headers)) => {
+          if let Ok(file) =
+            file_fetcher.build_remote_file(&specifier, bytes.clone(), &headers)
+          {
+            file_fetcher.prefetch_imports(&file, &permissions);
+          }
+          Some(Prefetched::Code(bytes, headers))
+        }
+        Ok(FetchOnceResult::Redirect(redirect_url, headers)) => {
+          Some(Prefetched::Redirect(redirect_url, headers))
+        }
+        // No ETag is sent, so the response can't be "not modified".
+        Ok(FetchOnceResult::NotModified) => None,
+        Err(err) => {
+          debug!("Prefetching {} failed: {}", specifier, err);
+          None
+        }
+      };
+      if maybe_prefetched.is_none() {
+        file_fetcher.prefetches.0.lock().remove(&specifier);
+      }
+      maybe_prefetched.map(Arc::new)
+    }
+    .boxed()
+    .shared();
+    prefetches.insert(specifier, prefetch.clone());
+    tokio::spawn(prefetch.clone());
+    Some(prefetch)
+  }
+
   /// Get the location of the current HTTP cache associated with the fetcher.
+  /// For a packed cache, this is its database.
   pub fn get_http_cache_location(&self) -> PathBuf {
-    self.http_cache.location.clone()
+    self.http_cache.get_storage_path()
   }
 
   /// A synchronous way to retrieve a source file, where if the file has already
@@ -1583,4 +1767,79 @@ mod tests {
                    \u{5E2}\u{5D5}\u{5DC}\u{5DD}\");\u{A}";
     test_fetch_remote_encoded("windows-1255", "windows-1255", expected).await;
   }
+
+  #[test]
+  fn test_scan_imports() {
+    let source = r#"
+      import { a } from "./a.ts";
+      import type {
+        B,
+      } from './b.ts';
+      import "./c.ts"; export * from "./d.ts";
+      export { e } from "https://example.com/e.ts";
+      export const f = "./f.ts";
+      const g = await import("./g.ts");
+      // import "./h.ts";
+    "#;
+    let imports: Vec<&str> = scan_imports(source).collect();
+    assert_eq!(
+      imports,
+      vec![
+        "./a.ts",
+        "./b.ts",
+        "./c.ts",
+        "./d.ts",
+        "https://example.com/e.ts"
+      ]
+    );
+  }
+
+  #[tokio::test]
+  async fn test_prefetch_imports() {
+    let _http_server_guard = test_util::http_server();
+    let (file_fetcher, _) = setup(CacheSetting::ReloadAll, None);
+    let mut permissions = Permissions::allow_all();
+    let specifier =
+      resolve_url("http://localhost:4545/cli/tests/subdir/mod1.ts").unwrap();
+    let file = file_fetcher
+      .fetch(&specifier, &mut permissions)
+      .await
+      .unwrap();
+
+    let prefetches = file_fetcher.prefetch_imports(&file, &permissions);
+    assert_eq!(prefetches.len(), 1);
+    // Prefetching the same imports again joins the prefetch in flight.
+    assert_eq!(file_fetcher.prefetch_imports(&file, &permissions).len(), 1);
+    let prefetched = futures::future::join_all(prefetches).await;
+    assert!(prefetched[0].is_some());
+    let mod2_specifier =
+      resolve_url("http://localhost:4545/cli/tests/subdir/subdir2/mod2.ts")
+        .unwrap();
+
+    // The prefetched module is only cached once it is fetched.
+    assert!(file_fetcher.cache.get(&mod2_specifier).is_none());
+    assert!(file_fetcher.http_cache.get(&mod2_specifier).is_err());
+    let file = file_fetcher
+      .fetch(&mod2_specifier, &mut permissions)
+      .await
+      .unwrap();
+    assert!(file.source.contains("returnsFoo"));
+    assert!(file_fetcher.cache.get(&mod2_specifier).is_some());
+    assert!(file_fetcher.http_cache.get(&mod2_specifier).is_ok());
+
+    let stats = file_fetcher.host_scheduler.stats("localhost:4545").unwrap();
+    assert!(stats.requests >= 2);
+
+    // Nothing is prefetched from a host that net access isn't granted to yet,
+    // since that would prompt.
+    let (file_fetcher, _) = setup(CacheSetting::ReloadAll, None);
+    let file = file_fetcher
+      .fetch(&specifier, &mut permissions)
+      .await
+      .unwrap();
+    let permissions = Permissions::from_options(&Default::default());
+    assert!(file_fetcher
+      .prefetch_imports(&file, &permissions)
+      .is_empty());
+  }
 }
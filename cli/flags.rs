@@ -72,6 +72,7 @@ pub enum DenoSubcommand {
     files: Vec<PathBuf>,
     ignore: Vec<PathBuf>,
     ext: String,
+    no_cache: bool,
   },
   Info {
     json: bool,
@@ -90,6 +91,7 @@ pub enum DenoSubcommand {
     ignore: Vec<PathBuf>,
     rules: bool,
     json: bool,
+    no_cache: bool,
   },
   Repl,
   Run {
@@ -105,6 +107,7 @@ pub enum DenoSubcommand {
     filter: Option<String>,
     shuffle: Option<u64>,
     concurrent_jobs: usize,
+    isolate_files: bool,
   },
   Types,
   Upgrade {
@@ -151,6 +154,7 @@ pub struct Flags {
   pub lock_write: bool,
   pub log_level: Option<Level>,
   pub no_check: bool,
+  pub no_code_cache: bool,
   pub prompt: bool,
   pub no_remote: bool,
   pub reload: bool,
@@ -263,6 +267,9 @@ static ENV_VARIABLES_HELP: &str = r#"ENVIRONMENT VARIABLES:
                          hostnames to use when fetching remote modules from
                          private repositories
                          (e.g. "abcde12345@deno.land;54321edcba@github.com")
+    DENO_CACHE_BACKEND   Set to "packed" to store the cache in a few database
+                         files instead of one file per module. Existing cached
+                         files are imported on first use. Ignored by deno lsp
     DENO_CERT            Load certificate authority from PEM encoded file
     DENO_DIR             Set the cache directory
     DENO_INSTALL_ROOT    Set deno install's output directory
@@ -740,6 +747,11 @@ Ignore formatting a file by adding an ignore comment at the top of the file:
         .help("Check if the source files are formatted")
         .takes_value(false),
     )
+    .arg(
+      Arg::with_name("no-cache")
+        .long("no-cache")
+        .help("Ignore the results of previous runs for unchanged files"),
+    )
     .arg(
       Arg::with_name("ext")
         .long("ext")
@@ -933,6 +945,11 @@ Ignore linting a file by adding an ignore comment at the top of the file:
         .help("Output lint result in JSON format")
         .takes_value(false),
     )
+    .arg(
+      Arg::with_name("no-cache")
+        .long("no-cache")
+        .help("Ignore the results of previous runs for unchanged files"),
+    )
     .arg(
       Arg::with_name("files")
         .takes_value(true)
@@ -1067,6 +1084,13 @@ fn test_subcommand<'a, 'b>() -> App<'a, 'b> {
           Err(_) => Err("jobs should be a number".to_string()),
         }),
     )
+    .arg(
+      Arg::with_name("isolate-files")
+        .long("isolate-files")
+        .requires("jobs")
+        .help("Run each test module in its own worker when using --jobs")
+        .takes_value(false),
+    )
     .arg(
       Arg::with_name("files")
         .help("List of file names to run")
@@ -1091,7 +1115,14 @@ report results to standard output:
 Directory arguments are expanded to all contained files matching the glob
 {*_,*.,}test.{js,mjs,ts,jsx,tsx}:
 
-  deno test src/",
+  deno test src/
+
+With --jobs, tests are run by a pool of workers that each load several test
+modules, and the tests of a module may be spread over several workers. Modules
+loaded by the same worker share their global scope. To run each test module in
+a fresh worker instead, use --isolate-files:
+
+  deno test --jobs=4 --isolate-files src/",
     )
 }
 
@@ -1263,6 +1294,7 @@ fn runtime_args<'a, 'b>(
   };
   app
     .arg(cached_only_arg())
+    .arg(no_code_cache_arg())
     .arg(location_arg())
     .arg(v8_flags_arg())
     .arg(seed_arg())
@@ -1346,6 +1378,12 @@ fn cached_only_arg<'a, 'b>() -> Arg<'a, 'b> {
     .help("Require that remote dependencies are already cached")
 }
 
+fn no_code_cache_arg<'a, 'b>() -> Arg<'a, 'b> {
+  Arg::with_name("no-code-cache")
+    .long("no-code-cache")
+    .help("Do not use or store V8 code cache for modules")
+}
+
 fn location_arg<'a, 'b>() -> Arg<'a, 'b> {
   Arg::with_name("location")
     .long("location")
@@ -1606,6 +1644,7 @@ fn fmt_parse(flags: &mut Flags, matches: &clap::ArgMatches) {
     ext,
     files,
     ignore,
+    no_cache: matches.is_present("no-cache"),
   }
 }
 
@@ -1666,11 +1705,13 @@ fn lint_parse(flags: &mut Flags, matches: &clap::ArgMatches) {
   };
   let rules = matches.is_present("rules");
   let json = matches.is_present("json");
+  let no_cache = matches.is_present("no-cache");
   flags.subcommand = DenoSubcommand::Lint {
     files,
     rules,
     ignore,
     json,
+    no_cache,
   };
 }
 
@@ -1760,6 +1801,8 @@ fn test_parse(flags: &mut Flags, matches: &clap::ArgMatches) {
     1
   };
 
+  let isolate_files = matches.is_present("isolate-files");
+
   let include = if matches.is_present("files") {
     let files: Vec<String> = matches
       .values_of("files")
@@ -1782,6 +1825,7 @@ fn test_parse(flags: &mut Flags, matches: &clap::ArgMatches) {
     shuffle,
     allow_none,
     concurrent_jobs,
+    isolate_files,
   };
 }
 
@@ -1890,6 +1934,7 @@ fn runtime_args_parse(
 ) {
   compile_args_parse(flags, matches);
   cached_only_arg_parse(flags, matches);
+  no_code_cache_arg_parse(flags, matches);
   if include_perms {
     permission_args_parse(flags, matches);
   }
@@ -1952,6 +1997,12 @@ fn cached_only_arg_parse(flags: &mut Flags, matches: &ArgMatches) {
   }
 }
 
+fn no_code_cache_arg_parse(flags: &mut Flags, matches: &ArgMatches) {
+  if matches.is_present("no-code-cache") {
+    flags.no_code_cache = true;
+  }
+}
+
 fn location_arg_parse(flags: &mut Flags, matches: &clap::ArgMatches) {
   flags.location = matches
     .value_of("location")
@@ -2280,7 +2331,8 @@ mod tests {
             PathBuf::from("script_1.ts"),
             PathBuf::from("script_2.ts")
           ],
-          ext: "ts".to_string()
+          ext: "ts".to_string(),
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2295,6 +2347,7 @@ mod tests {
           check: true,
           files: vec![],
           ext: "ts".to_string(),
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2309,6 +2362,7 @@ mod tests {
           check: false,
           files: vec![],
           ext: "ts".to_string(),
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2323,6 +2377,7 @@ mod tests {
           check: false,
           files: vec![],
           ext: "ts".to_string(),
+          no_cache: false,
         },
         watch: true,
         ..Flags::default()
@@ -2345,11 +2400,27 @@ mod tests {
           check: true,
           files: vec![PathBuf::from("foo.ts")],
           ext: "ts".to_string(),
+          no_cache: false,
         },
         watch: true,
         ..Flags::default()
       }
     );
+
+    let r = flags_from_vec(svec!["deno", "fmt", "--check", "--no-cache"]);
+    assert_eq!(
+      r.unwrap(),
+      Flags {
+        subcommand: DenoSubcommand::Fmt {
+          ignore: vec![],
+          check: true,
+          files: vec![],
+          ext: "ts".to_string(),
+          no_cache: true,
+        },
+        ..Flags::default()
+      }
+    );
   }
 
   #[test]
@@ -2366,6 +2437,7 @@ mod tests {
           rules: false,
           json: false,
           ignore: vec![],
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2384,6 +2456,7 @@ mod tests {
             PathBuf::from("script_1.ts"),
             PathBuf::from("script_2.ts")
           ],
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2398,6 +2471,7 @@ mod tests {
           rules: true,
           json: false,
           ignore: vec![],
+          no_cache: false,
         },
         ..Flags::default()
       }
@@ -2412,6 +2486,22 @@ mod tests {
           rules: false,
           json: true,
           ignore: vec![],
+          no_cache: false,
+        },
+        ..Flags::default()
+      }
+    );
+
+    let r = flags_from_vec(svec!["deno", "lint", "--no-cache", "script_1.ts"]);
+    assert_eq!(
+      r.unwrap(),
+      Flags {
+        subcommand: DenoSubcommand::Lint {
+          files: vec![PathBuf::from("script_1.ts")],
+          rules: false,
+          json: false,
+          ignore: vec![],
+          no_cache: true,
         },
         ..Flags::default()
       }
@@ -3305,6 +3395,22 @@ mod tests {
     );
   }
 
+  #[test]
+  fn no_code_cache() {
+    let r =
+      flags_from_vec(svec!["deno", "run", "--no-code-cache", "script.ts"]);
+    assert_eq!(
+      r.unwrap(),
+      Flags {
+        subcommand: DenoSubcommand::Run {
+          script: "script.ts".to_string(),
+        },
+        no_code_cache: true,
+        ..Flags::default()
+      }
+    );
+  }
+
   #[test]
   fn cached_only() {
     let r = flags_from_vec(svec!["deno", "run", "--cached-only", "script.ts"]);
@@ -3418,6 +3524,7 @@ mod tests {
           include: Some(svec!["dir1/", "dir2/"]),
           shuffle: None,
           concurrent_jobs: 1,
+          isolate_files: false,
         },
         unstable: true,
         coverage_dir: Some("cov".to_string()),
@@ -3466,10 +3573,38 @@ mod tests {
           shuffle: None,
           include: None,
           concurrent_jobs: 1,
+          isolate_files: false,
+        },
+        ..Flags::default()
+      }
+    );
+  }
+
+  #[test]
+  fn test_with_jobs() {
+    let r =
+      flags_from_vec(svec!["deno", "test", "--jobs=4", "--isolate-files"]);
+    assert_eq!(
+      r.unwrap(),
+      Flags {
+        subcommand: DenoSubcommand::Test {
+          no_run: false,
+          doc: false,
+          fail_fast: None,
+          filter: None,
+          allow_none: false,
+          quiet: false,
+          shuffle: None,
+          include: None,
+          concurrent_jobs: 4,
+          isolate_files: true,
         },
         ..Flags::default()
       }
     );
+
+    let r = flags_from_vec(svec!["deno", "test", "--isolate-files"]);
+    assert!(r.is_err());
   }
 
   #[test]
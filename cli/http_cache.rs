@@ -5,6 +5,7 @@
 //! at hand.
 use crate::fs_util;
 use crate::http_util::HeadersMap;
+use crate::packed_cache::PackedCache;
 use deno_core::error::generic_error;
 use deno_core::error::AnyError;
 use deno_core::serde::Deserialize;
@@ -13,7 +14,6 @@ use deno_core::serde_json;
 use deno_core::url::Url;
 use log::error;
 use std::fs;
-use std::fs::File;
 use std::io;
 use std::path::Path;
 use std::path::PathBuf;
@@ -75,6 +75,8 @@ pub fn url_to_filename(url: &Url) -> Option<PathBuf> {
 #[derive(Debug, Clone, Default)]
 pub struct HttpCache {
   pub location: PathBuf,
+  /// If set, files are stored in this packed cache instead of in `location`.
+  maybe_pack: Option<PackedCache>,
 }
 
 #[derive(Serialize, Deserialize)]
@@ -113,6 +115,15 @@ impl HttpCache {
     assert!(location.is_absolute());
     Self {
       location: location.to_owned(),
+      maybe_pack: None,
+    }
+  }
+
+  /// Like `new`, but stores the files in `pack` instead of in `location`.
+  pub fn new_packed(location: &Path, pack: PackedCache) -> Self {
+    Self {
+      maybe_pack: Some(pack),
+      ..Self::new(location)
     }
   }
 
@@ -136,19 +147,44 @@ impl HttpCache {
     Some(self.location.join(url_to_filename(url)?))
   }
 
+  /// Returns where the cache is stored: `location`, or the database of the
+  /// packed cache.
+  pub fn get_storage_path(&self) -> PathBuf {
+    match &self.maybe_pack {
+      Some(pack) => pack.path().to_owned(),
+      None => self.location.clone(),
+    }
+  }
+
+  /// Like `get_cache_filename`, but for a packed cache returns the entry in
+  /// the database, to show to the user.
+  pub(crate) fn get_storage_filename(&self, url: &Url) -> Option<PathBuf> {
+    let cache_filename = self.get_cache_filename(url)?;
+    match &self.maybe_pack {
+      Some(pack) => Some(pack.entry_path(&cache_filename)),
+      None => Some(cache_filename),
+    }
+  }
+
   // TODO(bartlomieju): this method should check headers file
   // and validate against ETAG/Last-modified-as headers.
   // ETAG check is currently done in `cli/file_fetcher.rs`.
-  pub fn get(&self, url: &Url) -> Result<(File, HeadersMap), AnyError> {
+  pub fn get(&self, url: &Url) -> Result<(Vec<u8>, HeadersMap), AnyError> {
     let cache_filename = self.location.join(
       url_to_filename(url)
         .ok_or_else(|| generic_error("Can't convert url to filename."))?,
     );
     let metadata_filename = Metadata::filename(&cache_filename);
-    let file = File::open(cache_filename)?;
-    let metadata = fs::read_to_string(metadata_filename)?;
-    let metadata: Metadata = serde_json::from_str(&metadata)?;
-    Ok((file, metadata.headers))
+    let (content, metadata) = if let Some(pack) = &self.maybe_pack {
+      let not_found = || io::Error::from(io::ErrorKind::NotFound);
+      let content = pack.get(&cache_filename)?.ok_or_else(not_found)?;
+      let metadata = pack.get(&metadata_filename)?.ok_or_else(not_found)?;
+      (content, metadata)
+    } else {
+      (fs::read(cache_filename)?, fs::read(metadata_filename)?)
+    };
+    let metadata: Metadata = serde_json::from_slice(&metadata)?;
+    Ok((content, metadata.headers))
   }
 
   pub fn set(
@@ -161,6 +197,18 @@ impl HttpCache {
       url_to_filename(url)
         .ok_or_else(|| generic_error("Can't convert url to filename."))?,
     );
+    let metadata = Metadata {
+      url: url.to_string(),
+      headers: headers_map,
+    };
+    if let Some(pack) = &self.maybe_pack {
+      let metadata_filename = Metadata::filename(&cache_filename);
+      let json = serde_json::to_string_pretty(&metadata)?;
+      return pack.set(&[
+        (cache_filename.as_path(), content),
+        (metadata_filename.as_path(), json.as_bytes()),
+      ]);
+    }
     // Create parent directory
     let parent_filename = cache_filename
       .parent()
@@ -168,11 +216,6 @@ impl HttpCache {
     self.ensure_dir_exists(parent_filename)?;
     // Cache content
     fs_util::atomic_write_file(&cache_filename, content, CACHE_PERM)?;
-
-    let metadata = Metadata {
-      url: url.to_string(),
-      headers: headers_map,
-    };
     metadata.write(&cache_filename)
   }
 }
@@ -181,7 +224,6 @@ impl HttpCache {
 mod tests {
   use super::*;
   use std::collections::HashMap;
-  use std::io::Read;
   use tempfile::TempDir;
 
   #[test]
@@ -228,10 +270,8 @@ mod tests {
     assert!(r.is_ok());
     let r = cache.get(&url);
     assert!(r.is_ok());
-    let (mut file, headers) = r.unwrap();
-    let mut content = String::new();
-    file.read_to_string(&mut content).unwrap();
-    assert_eq!(content, "Hello world");
+    let (content, headers) = r.unwrap();
+    assert_eq!(content, b"Hello world");
     assert_eq!(
       headers.get("content-type").unwrap(),
       "application/javascript"
@@ -240,6 +280,23 @@ mod tests {
     assert_eq!(headers.get("foobar"), None);
   }
 
+  #[test]
+  fn test_get_set_packed() {
+    let dir = TempDir::new().unwrap();
+    let location = dir.path().join("deps");
+    let cache = HttpCache::new_packed(&location, PackedCache::new(&location));
+    let url = Url::parse("https://deno.land/x/welcome.ts").unwrap();
+    assert!(cache.get(&url).is_err());
+    let mut headers = HashMap::new();
+    headers.insert("etag".to_string(), "as5625rqdsfb".to_string());
+    cache.set(&url, headers, b"Hello world").unwrap();
+    let (content, headers) = cache.get(&url).unwrap();
+    assert_eq!(content, b"Hello world");
+    assert_eq!(headers.get("etag").unwrap(), "as5625rqdsfb");
+    // Nothing is stored as a separate file.
+    assert!(!location.exists());
+  }
+
   #[test]
   fn test_url_to_filename() {
     let test_cases = [
@@ -4,6 +4,7 @@ use crate::auth_tokens::AuthToken;
 
 use deno_core::error::generic_error;
 use deno_core::error::AnyError;
+use deno_core::parking_lot::Mutex;
 use deno_core::url::Url;
 use deno_runtime::deno_fetch::reqwest;
 use deno_runtime::deno_fetch::reqwest::header::HeaderMap;
@@ -17,6 +18,14 @@ use deno_runtime::deno_fetch::reqwest::Client;
 use deno_runtime::deno_fetch::reqwest::StatusCode;
 use log::debug;
 use std::collections::HashMap;
+use std::sync::Arc;
+use std::time::Duration;
+use std::time::Instant;
+use tokio::sync::Semaphore;
+
+/// The maximum number of requests for modules that are in flight to a single
+/// host at a time, which matches the connection limit of browsers.
+pub const MAX_REQUESTS_PER_HOST: usize = 6;
 
 /// Create new instance of async reqwest::Client. This client supports
 /// proxies and doesn't follow redirects.
@@ -164,6 +173,111 @@ pub async fn fetch_once(
   Ok(FetchOnceResult::Code(body, headers_))
 }
 
+/// Timings of the requests that have been made to a host.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct HostStats {
+  pub requests: usize,
+  /// The time requests spent waiting for other requests to the host to
+  /// finish before being sent.
+  pub queued: Duration,
+  pub total: Duration,
+  pub max: Duration,
+}
+
+#[derive(Debug)]
+struct HostState {
+  semaphore: Arc<Semaphore>,
+  stats: HostStats,
+}
+
+/// Schedules requests made with `fetch_once`, bounding the number of requests
+/// that are in flight to each host and recording how long they take. Clones
+/// share their limits and timings.
+#[derive(Debug, Clone)]
+pub struct HostScheduler {
+  max_per_host: usize,
+  hosts: Arc<Mutex<HashMap<String, HostState>>>,
+}
+
+impl Default for HostScheduler {
+  fn default() -> Self {
+    Self::new(MAX_REQUESTS_PER_HOST)
+  }
+}
+
+impl HostScheduler {
+  pub fn new(max_per_host: usize) -> Self {
+    assert!(max_per_host > 0);
+    Self {
+      max_per_host,
+      hosts: Default::default(),
+    }
+  }
+
+  /// Like `fetch_once`, but waits until there are fewer than the maximum
+  /// number of requests in flight to the host of the URL.
+  pub async fn fetch_once(
+    &self,
+    args: FetchOnceArgs,
+  ) -> Result<FetchOnceResult, AnyError> {
+    let host = host_key(&args.url);
+    let semaphore = self
+      .hosts
+      .lock()
+      .entry(host.clone())
+      .or_insert_with(|| HostState {
+        semaphore: Arc::new(Semaphore::new(self.max_per_host)),
+        stats: HostStats::default(),
+      })
+      .semaphore
+      .clone();
+
+    let queued_at = Instant::now();
+    let _permit = semaphore.acquire_owned().await?;
+    let started_at = Instant::now();
+    let url = args.url.clone();
+    let result = fetch_once(args).await;
+    let queued = started_at - queued_at;
+    let elapsed = started_at.elapsed();
+
+    let stats = {
+      let mut hosts = self.hosts.lock();
+      let stats = &mut hosts.get_mut(&host).unwrap().stats;
+      stats.requests += 1;
+      stats.queued += queued;
+      stats.total += elapsed;
+      stats.max = stats.max.max(elapsed);
+      *stats
+    };
+    debug!(
+      "Fetched {} in {}ms, queued for {}ms. {}: {} requests, {}ms total, {}ms max, {}ms queued",
+      url,
+      elapsed.as_millis(),
+      queued.as_millis(),
+      host,
+      stats.requests,
+      stats.total.as_millis(),
+      stats.max.as_millis(),
+      stats.queued.as_millis()
+    );
+    result
+  }
+
+  /// Returns the timings of the requests made to `host`, which is formatted
+  /// as `hostname:port`.
+  pub fn stats(&self, host: &str) -> Option<HostStats> {
+    self.hosts.lock().get(host).map(|state| state.stats)
+  }
+}
+
+fn host_key(url: &Url) -> String {
+  format!(
+    "{}:{}",
+    url.host_str().unwrap_or_default(),
+    url.port_or_known_default().unwrap_or_default()
+  )
+}
+
 #[cfg(test)]
 mod tests {
   use super::*;
@@ -538,4 +652,30 @@ mod tests {
     // Check that the error message contains the original URL
     assert!(err.to_string().contains(url_str));
   }
+
+  #[tokio::test]
+  async fn test_host_scheduler() {
+    let _g = test_util::http_server();
+    let scheduler = HostScheduler::new(1);
+    let client = create_test_client(None);
+    let fetches = (0..3).map(|_| {
+      scheduler.fetch_once(FetchOnceArgs {
+        client: client.clone(),
+        url: Url::parse("http://127.0.0.1:4545/cli/tests/fixture.json")
+          .unwrap(),
+        maybe_etag: None,
+        maybe_auth_token: None,
+      })
+    });
+    let results = deno_core::futures::future::join_all(fetches).await;
+    for result in results {
+      assert!(matches!(result, Ok(FetchOnceResult::Code(..))));
+    }
+    let stats = scheduler.stats("127.0.0.1:4545").unwrap();
+    assert_eq!(stats.requests, 3);
+    assert!(stats.max <= stats.total);
+    // Only one request may be in flight at a time, so the others had to wait.
+    assert!(stats.queued > Duration::from_secs(0));
+    assert_eq!(scheduler.stats("localhost:4545"), None);
+  }
 }
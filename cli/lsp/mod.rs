@@ -1,8 +1,11 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
+use crate::packed_cache::DENO_CACHE_BACKEND;
 use deno_core::error::AnyError;
+use log::warn;
 use lspower::LspService;
 use lspower::Server;
+use std::env;
 
 mod analysis;
 mod capabilities;
@@ -24,6 +27,17 @@ mod tsc;
 mod urls;
 
 pub async fn start() -> Result<(), AnyError> {
+  // The language server reads cached modules from the files in DENO_DIR, so
+  // it can't use the packed backend, and neither can the caching it does on
+  // behalf of the editor.
+  if env::var_os(DENO_CACHE_BACKEND).is_some() {
+    warn!(
+      "{} is not supported by the language server and is ignored.",
+      DENO_CACHE_BACKEND
+    );
+    env::remove_var(DENO_CACHE_BACKEND);
+  }
+
   let stdin = tokio::io::stdin();
   let stdout = tokio::io::stdout();
 
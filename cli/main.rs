@@ -27,6 +27,7 @@ mod media_type;
 mod module_graph;
 mod module_loader;
 mod ops;
+mod packed_cache;
 mod program_state;
 mod source_maps;
 mod specifier_handler;
@@ -147,6 +148,12 @@ fn create_web_worker_callback(
       // Applies source maps - works in conjuction with `js_error_create_fn`
       // above
       ops::errors::init(js_runtime);
+      if let Some(threshold) = program_state.stall_threshold {
+        js_runtime.set_stall_threshold(threshold);
+      }
+      if let Some(budget) = program_state.op_budget {
+        js_runtime.set_op_budget(budget);
+      }
       if args.use_deno_namespace {
         ops::runtime_compiler::init(js_runtime);
       }
@@ -231,6 +238,12 @@ pub fn create_main_worker(
     // above
     ops::errors::init(js_runtime);
     ops::runtime_compiler::init(js_runtime);
+    if let Some(threshold) = program_state.stall_threshold {
+      js_runtime.set_stall_threshold(threshold);
+    }
+    if let Some(budget) = program_state.op_budget {
+      js_runtime.set_op_budget(budget);
+    }
 
     if enable_testing {
       ops::testing::init(js_runtime);
@@ -274,7 +287,7 @@ fn print_cache_info(
 ) -> Result<(), AnyError> {
   let deno_dir = &state.dir.root;
   let modules_cache = &state.file_fetcher.get_http_cache_location();
-  let typescript_cache = &state.dir.gen_cache.location;
+  let typescript_cache = &state.dir.gen_cache.get_storage_path();
   let registry_cache =
     &state.dir.root.join(lsp::language_server::REGISTRIES_PATH);
   let mut origin_dir = state.dir.root.join("location_data");
@@ -486,13 +499,14 @@ async fn lint_command(
   list_rules: bool,
   ignore: Vec<PathBuf>,
   json: bool,
+  no_cache: bool,
 ) -> Result<(), AnyError> {
   if list_rules {
     tools::lint::print_rules_list(json);
     return Ok(());
   }
 
-  tools::lint::lint_files(files, ignore, json).await
+  tools::lint::lint_files(files, ignore, json, no_cache).await
 }
 
 async fn cache_command(
@@ -613,6 +627,7 @@ async fn create_module_graph_and_maybe_check(
         lib,
         maybe_config_file: program_state.maybe_config_file.clone(),
         reload: program_state.flags.reload,
+        maybe_compiler_pool: Some(program_state.compiler_pool.clone()),
         ..Default::default()
       })?;
 
@@ -655,16 +670,20 @@ async fn bundle_command(
   out_file: Option<PathBuf>,
 ) -> Result<(), AnyError> {
   let debug = flags.log_level == Some(log::Level::Debug);
+  let compiler_pool = tsc::CompilerPool::default();
 
   let resolver = |_| {
     let flags = flags.clone();
+    let compiler_pool = compiler_pool.clone();
     let source_file1 = source_file.clone();
     let source_file2 = source_file.clone();
     async move {
       let module_specifier = resolve_url_or_path(&source_file1)?;
 
       debug!(">>>>> bundle START");
-      let program_state = ProgramState::build(flags.clone()).await?;
+      let program_state =
+        ProgramState::build_with_compiler_pool(flags.clone(), compiler_pool)
+          .await?;
 
       let module_graph = create_module_graph_and_maybe_check(
         module_specifier,
@@ -763,12 +782,13 @@ async fn format_command(
   ignore: Vec<PathBuf>,
   check: bool,
   ext: String,
+  no_cache: bool,
 ) -> Result<(), AnyError> {
   if args.len() == 1 && args[0].to_string_lossy() == "-" {
     return tools::fmt::format_stdin(check, ext);
   }
 
-  tools::fmt::format(args, ignore, check, flags.watch).await?;
+  tools::fmt::format(args, ignore, check, flags.watch, no_cache).await?;
   Ok(())
 }
 
@@ -823,13 +843,17 @@ async fn run_from_stdin(flags: Flags) -> Result<(), AnyError> {
 }
 
 async fn run_with_watch(flags: Flags, script: String) -> Result<(), AnyError> {
+  let compiler_pool = tsc::CompilerPool::default();
+
   let resolver = |_| {
     let script1 = script.clone();
     let script2 = script.clone();
     let flags = flags.clone();
+    let compiler_pool = compiler_pool.clone();
     async move {
       let main_module = resolve_url_or_path(&script1)?;
-      let program_state = ProgramState::build(flags).await?;
+      let program_state =
+        ProgramState::build_with_compiler_pool(flags, compiler_pool).await?;
       let handler = Arc::new(Mutex::new(FetchHandler::new(
         &program_state,
         Permissions::allow_all(),
@@ -992,6 +1016,7 @@ async fn test_command(
   filter: Option<String>,
   shuffle: Option<u64>,
   concurrent_jobs: usize,
+  isolate_files: bool,
 ) -> Result<(), AnyError> {
   if let Some(ref coverage_dir) = flags.coverage_dir {
     std::fs::create_dir_all(&coverage_dir)?;
@@ -1209,6 +1234,7 @@ async fn test_command(
           filter.clone(),
           shuffle,
           concurrent_jobs,
+          isolate_files,
         )
         .await?;
 
@@ -1247,6 +1273,7 @@ async fn test_command(
       filter,
       shuffle,
       concurrent_jobs,
+      isolate_files,
     )
     .await?;
 
@@ -1323,7 +1350,10 @@ fn get_subcommand(
       files,
       ignore,
       ext,
-    } => format_command(flags, files, ignore, check, ext).boxed_local(),
+      no_cache,
+    } => {
+      format_command(flags, files, ignore, check, ext, no_cache).boxed_local()
+    }
     DenoSubcommand::Info { file, json } => {
       info_command(flags, file, json).boxed_local()
     }
@@ -1342,7 +1372,10 @@ fn get_subcommand(
       rules,
       ignore,
       json,
-    } => lint_command(flags, files, rules, ignore, json).boxed_local(),
+      no_cache,
+    } => {
+      lint_command(flags, files, rules, ignore, json, no_cache).boxed_local()
+    }
     DenoSubcommand::Repl => run_repl(flags).boxed_local(),
     DenoSubcommand::Run { script } => run_command(flags, script).boxed_local(),
     DenoSubcommand::Test {
@@ -1355,6 +1388,7 @@ fn get_subcommand(
       filter,
       shuffle,
       concurrent_jobs,
+      isolate_files,
     } => test_command(
       flags,
       include,
@@ -1366,6 +1400,7 @@ fn get_subcommand(
       filter,
       shuffle,
       concurrent_jobs,
+      isolate_files,
     )
     .boxed_local(),
     DenoSubcommand::Completions { buf } => {
@@ -55,7 +55,10 @@ use std::fmt;
 use std::path::PathBuf;
 use std::rc::Rc;
 use std::result;
+use std::sync::atomic::AtomicUsize;
+use std::sync::atomic::Ordering;
 use std::sync::Arc;
+use std::thread;
 use std::time::Instant;
 use swc_common::comments::Comment;
 use swc_common::BytePos;
@@ -248,6 +251,87 @@ fn get_version(source: &str, version: &str, config: &[u8]) -> String {
   crate::checksum::gen(&[source.as_bytes(), version.as_bytes(), config])
 }
 
+/// Transpiling is only spread over several threads when each of them gets at
+/// least this many modules, as small graphs are not worth the thread startup.
+const MIN_TRANSPILES_PER_THREAD: usize = 4;
+
+/// A module to be transpiled by `transpile_modules`.
+struct TranspileJob {
+  specifier: ModuleSpecifier,
+  source: String,
+  media_type: MediaType,
+}
+
+type TranspileResult = Result<(String, Option<String>), AnyError>;
+
+/// Transpiles modules in parallel on a bounded number of threads. Parsing and
+/// transforming a module with swc doesn't depend on any other module, so
+/// this is only a matter of spreading them out. The results are returned in
+/// the same order as the jobs.
+fn transpile_modules(
+  jobs: Vec<TranspileJob>,
+  emit_options: &ast::EmitOptions,
+) -> Vec<TranspileResult> {
+  fn transpile(
+    job: &TranspileJob,
+    emit_options: &ast::EmitOptions,
+  ) -> TranspileResult {
+    let parsed_module =
+      parse(job.specifier.as_str(), &job.source, &job.media_type)?;
+    parsed_module.transpile(emit_options)
+  }
+
+  let thread_count =
+    std::cmp::min(num_cpus::get(), jobs.len() / MIN_TRANSPILES_PER_THREAD);
+  if thread_count <= 1 {
+    return jobs
+      .iter()
+      .map(|job| transpile(job, emit_options))
+      .collect();
+  }
+
+  let job_count = jobs.len();
+  let jobs = Arc::new(jobs);
+  let next_job = Arc::new(AtomicUsize::new(0));
+  let handles: Vec<_> = (0..thread_count)
+    .map(|_| {
+      let jobs = jobs.clone();
+      let next_job = next_job.clone();
+      let emit_options = emit_options.clone();
+      thread::Builder::new()
+        .name("transpile".to_string())
+        // swc recurses deeply on deeply nested code, so give the threads as
+        // much stack as the main thread has.
+        .stack_size(8 * 1024 * 1024)
+        .spawn(move || {
+          let mut results = Vec::new();
+          loop {
+            let index = next_job.fetch_add(1, Ordering::Relaxed);
+            match jobs.get(index) {
+              Some(job) => results.push((index, transpile(job, &emit_options))),
+              None => break results,
+            }
+          }
+        })
+        .unwrap()
+    })
+    .collect();
+
+  let mut results: Vec<Option<TranspileResult>> =
+    (0..job_count).map(|_| None).collect();
+  for handle in handles {
+    match handle.join() {
+      Ok(thread_results) => {
+        for (index, result) in thread_results {
+          results[index] = Some(result);
+        }
+      }
+      Err(err) => std::panic::resume_unwind(err),
+    }
+  }
+  results.into_iter().map(Option::unwrap).collect()
+}
+
 /// A logical representation of a module within a graph.
 #[derive(Debug, Clone)]
 pub struct Module {
@@ -632,6 +716,9 @@ pub struct CheckOptions {
   /// `CheckOptions::reload` if it is `true`. Perhaps because they have already
   /// reloaded once in this process.
   pub reload_exclusions: HashSet<ModuleSpecifier>,
+  /// An optional pool of warm compiler runtimes to type check with, instead of
+  /// starting a new one.
+  pub maybe_compiler_pool: Option<tsc::CompilerPool>,
 }
 
 #[derive(Debug, Eq, PartialEq)]
@@ -667,6 +754,9 @@ pub struct EmitOptions {
   /// An optional map that contains user supplied TypeScript compiler
   /// configuration options that are passed to the TypeScript compiler.
   pub maybe_user_config: Option<HashMap<String, Value>>,
+  /// An optional pool of warm compiler runtimes to type check with, instead of
+  /// starting a new one.
+  pub maybe_compiler_pool: Option<tsc::CompilerPool>,
 }
 
 /// A structure which provides options when transpiling modules.
@@ -902,15 +992,18 @@ impl Graph {
       };
     debug!("maybe_config_specifier: {:?}", maybe_config_specifier);
 
-    let response = tsc::exec(tsc::Request {
-      config: config.clone(),
-      debug: options.debug,
-      graph: graph.clone(),
-      hash_data,
-      maybe_config_specifier,
-      maybe_tsbuildinfo,
-      root_names,
-    })?;
+    let response = tsc::exec_with_pool(
+      options.maybe_compiler_pool.as_ref(),
+      tsc::Request {
+        config: config.clone(),
+        debug: options.debug,
+        graph: graph.clone(),
+        hash_data,
+        maybe_config_specifier,
+        maybe_tsbuildinfo,
+        root_names,
+      },
+    )?;
 
     let mut graph = graph.lock();
     graph.maybe_tsbuildinfo = response.maybe_tsbuildinfo;
@@ -1038,15 +1131,18 @@ impl Graph {
       let hash_data =
         vec![config.as_bytes(), version::deno().as_bytes().to_owned()];
       let graph = Arc::new(Mutex::new(self));
-      let response = tsc::exec(tsc::Request {
-        config: config.clone(),
-        debug: options.debug,
-        graph: graph.clone(),
-        hash_data,
-        maybe_config_specifier: None,
-        maybe_tsbuildinfo: None,
-        root_names,
-      })?;
+      let response = tsc::exec_with_pool(
+        options.maybe_compiler_pool.as_ref(),
+        tsc::Request {
+          config: config.clone(),
+          debug: options.debug,
+          graph: graph.clone(),
+          hash_data,
+          maybe_config_specifier: None,
+          maybe_tsbuildinfo: None,
+          root_names,
+        },
+      )?;
 
       let graph = graph.lock();
       match options.bundle_type {
@@ -1130,7 +1226,8 @@ impl Graph {
         BundleType::None => {
           let check_js = config.get_check_js();
           let emit_options: ast::EmitOptions = config.into();
-          for (_, module_slot) in self.modules.iter_mut() {
+          let mut jobs = Vec::new();
+          for (_, module_slot) in self.modules.iter() {
             if let ModuleSlot::Module(module) = module_slot {
               if !(check_js
                 || module.media_type == MediaType::Jsx
@@ -1140,14 +1237,25 @@ impl Graph {
                 emitted_files
                   .insert(module.specifier.to_string(), module.source.clone());
               }
-              let parsed_module = module.parse()?;
-              let (code, maybe_map) = parsed_module.transpile(&emit_options)?;
-              emit_count += 1;
-              emitted_files.insert(format!("{}.js", module.specifier), code);
-              if let Some(map) = maybe_map {
-                emitted_files
-                  .insert(format!("{}.js.map", module.specifier), map);
-              }
+              jobs.push(TranspileJob {
+                specifier: module.specifier.clone(),
+                source: module.source.clone(),
+                media_type: module.media_type,
+              });
+            }
+          }
+          // Sorted, so that which error is reported doesn't depend on the
+          // iteration order of the modules.
+          jobs.sort_by(|a, b| a.specifier.cmp(&b.specifier));
+          let specifiers: Vec<ModuleSpecifier> =
+            jobs.iter().map(|job| job.specifier.clone()).collect();
+          let results = transpile_modules(jobs, &emit_options);
+          for (specifier, result) in specifiers.iter().zip(results) {
+            let (code, maybe_map) = result?;
+            emit_count += 1;
+            emitted_files.insert(format!("{}.js", specifier), code);
+            if let Some(map) = maybe_map {
+              emitted_files.insert(format!("{}.js.map", specifier), map);
             }
           }
           self.flush()?;
@@ -1710,8 +1818,8 @@ impl Graph {
     let config = ts_config.as_bytes();
     let check_js = ts_config.get_check_js();
     let emit_options: ast::EmitOptions = ts_config.into();
-    let mut emit_count = 0_u32;
-    for (specifier, module_slot) in self.modules.iter_mut() {
+    let mut jobs = Vec::new();
+    for (specifier, module_slot) in self.modules.iter() {
       if let ModuleSlot::Module(module) = module_slot {
         // TODO(kitsonk) a lot of this logic should be refactored into `Module` as
         // we start to support other methods on the graph.  Especially managing
@@ -1737,8 +1845,26 @@ impl Graph {
         if module.is_emit_valid(&config) && !needs_reload {
           continue;
         }
-        let parsed_module = module.parse()?;
-        let emit = parsed_module.transpile(&emit_options)?;
+        jobs.push(TranspileJob {
+          specifier: specifier.clone(),
+          source: module.source.clone(),
+          media_type: module.media_type,
+        });
+      }
+    }
+
+    // The modules are transpiled in parallel, and then the emits are stored in
+    // the graph in the order of their specifiers, so that the outcome doesn't
+    // depend on the iteration order of the modules.
+    jobs.sort_by(|a, b| a.specifier.cmp(&b.specifier));
+    let specifiers: Vec<ModuleSpecifier> =
+      jobs.iter().map(|job| job.specifier.clone()).collect();
+    let results = transpile_modules(jobs, &emit_options);
+    let mut emit_count = 0_u32;
+    for (specifier, result) in specifiers.iter().zip(results) {
+      let emit = result?;
+      if let Some(ModuleSlot::Module(module)) = self.modules.get_mut(specifier)
+      {
         emit_count += 1;
         module.maybe_emit = Some(Emit::Cli(emit));
         module.set_version(&config);
@@ -2542,6 +2668,7 @@ pub mod tests {
         bundle_type: BundleType::None,
         debug: false,
         maybe_user_config: None,
+        maybe_compiler_pool: None,
       })
       .expect("should have emitted");
     assert!(result_info.diagnostics.is_empty());
@@ -2582,6 +2709,7 @@ pub mod tests {
         bundle_type: BundleType::Module,
         debug: false,
         maybe_user_config: None,
+        maybe_compiler_pool: None,
       })
       .expect("should have emitted");
     assert!(result_info.diagnostics.is_empty());
@@ -2620,6 +2748,7 @@ pub mod tests {
         bundle_type: BundleType::None,
         debug: false,
         maybe_user_config: Some(user_config),
+        maybe_compiler_pool: None,
       })
       .expect("should have emitted");
     assert!(result_info.diagnostics.is_empty());
@@ -2,6 +2,7 @@
 
 use crate::import_map::ImportMap;
 use crate::module_graph::TypeLib;
+use crate::program_state::code_cache_key;
 use crate::program_state::ProgramState;
 use deno_core::error::AnyError;
 use deno_core::futures::future::FutureExt;
@@ -11,7 +12,9 @@ use deno_core::ModuleLoader;
 use deno_core::ModuleSpecifier;
 use deno_core::OpState;
 use deno_runtime::permissions::Permissions;
+use log::debug;
 use std::cell::RefCell;
+use std::collections::HashMap;
 use std::pin::Pin;
 use std::rc::Rc;
 use std::str;
@@ -27,6 +30,9 @@ pub struct CliModuleLoader {
   /// read access errors must be raised based on the parent thread permissions.
   pub root_permissions: Permissions,
   pub program_state: Arc<ProgramState>,
+  /// Keys of the code caches requested for modules, used to store the code
+  /// caches V8 produces for them once they have been evaluated.
+  code_cache_keys: RefCell<HashMap<ModuleSpecifier, String>>,
 }
 
 impl CliModuleLoader {
@@ -44,6 +50,7 @@ impl CliModuleLoader {
       lib,
       root_permissions: Permissions::allow_all(),
       program_state,
+      code_cache_keys: Default::default(),
     })
   }
 
@@ -62,6 +69,7 @@ impl CliModuleLoader {
       lib,
       root_permissions: permissions,
       program_state,
+      code_cache_keys: Default::default(),
     })
   }
 }
@@ -145,4 +153,41 @@ impl ModuleLoader for CliModuleLoader {
     }
     .boxed_local()
   }
+
+  fn uses_code_cache(&self) -> bool {
+    let flags = &self.program_state.flags;
+    // Code caches can interfere with coverage collection and debugging, so
+    // they are only used when neither is requested.
+    !flags.no_code_cache
+      && !flags.repl
+      && self.program_state.coverage_dir.is_none()
+      && flags.inspect.is_none()
+      && flags.inspect_brk.is_none()
+  }
+
+  fn get_code_cache(
+    &self,
+    specifier: &ModuleSpecifier,
+    code: &str,
+  ) -> Option<Vec<u8>> {
+    let key = code_cache_key(code);
+    let maybe_code_cache = self.program_state.get_code_cache(specifier, &key);
+    self
+      .code_cache_keys
+      .borrow_mut()
+      .insert(specifier.clone(), key);
+    maybe_code_cache
+  }
+
+  fn code_cache_ready(&self, specifier: &ModuleSpecifier, code_cache: &[u8]) {
+    let maybe_key = self.code_cache_keys.borrow_mut().remove(specifier);
+    if let Some(key) = maybe_key {
+      if let Err(err) = self
+        .program_state
+        .set_code_cache(specifier, &key, code_cache)
+      {
+        debug!("Failed to write code cache for \"{}\": {}", specifier, err);
+      }
+    }
+  }
 }
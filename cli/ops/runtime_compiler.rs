@@ -124,6 +124,7 @@ async fn op_emit(
     check: args.check.unwrap_or(true),
     debug,
     maybe_user_config: args.compiler_options,
+    maybe_compiler_pool: Some(program_state.compiler_pool.clone()),
   })?;
   result_info.diagnostics.extend_graph_errors(graph_errors);
 
@@ -1,4 +1,5 @@
 use crate::tools::test_runner::TestEvent;
+use crate::tools::test_runner::TestScheduler;
 use deno_core::error::generic_error;
 use deno_core::error::AnyError;
 use deno_core::JsRuntime;
@@ -8,6 +9,7 @@ use deno_runtime::ops::worker_host::create_worker_permissions;
 use deno_runtime::ops::worker_host::PermissionsArg;
 use deno_runtime::permissions::Permissions;
 use std::sync::mpsc::Sender;
+use std::sync::Arc;
 use uuid::Uuid;
 
 pub fn init(rt: &mut JsRuntime) {
@@ -19,6 +21,8 @@ pub fn init(rt: &mut JsRuntime) {
   );
   super::reg_sync(rt, "op_get_test_origin", op_get_test_origin);
   super::reg_sync(rt, "op_dispatch_test_event", op_dispatch_test_event);
+  super::reg_sync(rt, "op_start_test_queue", op_start_test_queue);
+  super::reg_sync(rt, "op_next_test", op_next_test);
 }
 
 #[derive(Clone)]
@@ -82,3 +86,24 @@ fn op_dispatch_test_event(
 
   Ok(())
 }
+
+/// Sets the number of tests of a test module whose tests are shared with other
+/// workers. Returns true if this is the first worker that loaded the module.
+fn op_start_test_queue(
+  state: &mut OpState,
+  queue: usize,
+  total: usize,
+) -> Result<bool, AnyError> {
+  let scheduler = state.borrow::<Arc<TestScheduler>>();
+  Ok(scheduler.start(queue, total))
+}
+
+/// Takes the index of the next test to run from a shared test module.
+fn op_next_test(
+  state: &mut OpState,
+  queue: usize,
+  _: (),
+) -> Result<Option<usize>, AnyError> {
+  let scheduler = state.borrow::<Arc<TestScheduler>>();
+  Ok(scheduler.next_test(queue))
+}
@@ -0,0 +1,299 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+
+//! An alternative backend for the caches in `DENO_DIR` that stores all files
+//! of a cache in a single SQLite database next to the cache directory, instead
+//! of as one file per entry. Hundreds of thousands of small files are slow to
+//! create, copy and `stat` on some file systems, like overlayfs in container
+//! images.
+//!
+//! It is selected by setting `DENO_CACHE_BACKEND=packed`. The first time a
+//! packed cache is opened, the files that are already in the cache directory
+//! are imported into it.
+
+use deno_core::error::generic_error;
+use deno_core::error::AnyError;
+use deno_core::parking_lot::Mutex;
+use log::debug;
+use rusqlite::params;
+use rusqlite::Connection;
+use rusqlite::OptionalExtension;
+use rusqlite::Transaction;
+use rusqlite::TransactionBehavior;
+use std::collections::HashMap;
+use std::env;
+use std::fmt;
+use std::fs;
+use std::path::Path;
+use std::path::PathBuf;
+use std::sync::Arc;
+use std::time::Duration;
+use walkdir::WalkDir;
+
+pub const DENO_CACHE_BACKEND: &str = "DENO_CACHE_BACKEND";
+
+/// The version of the schema of the database, which is stored as its
+/// `user_version`. A database with version 0 has just been created, and the
+/// files of the cache directory still have to be imported into it.
+const SCHEMA_VERSION: u32 = 1;
+
+/// When a database is opened with more than this fraction of its pages free,
+/// which happens as entries are overwritten, it is compacted.
+const MAX_FREE_PAGE_RATIO: f64 = 0.25;
+
+type SharedConnection = Arc<Mutex<Option<Connection>>>;
+
+lazy_static::lazy_static! {
+  /// The connections opened by this process, by database path. Every
+  /// `PackedCache` of the same cache directory shares one of them.
+  static ref CONNECTIONS: Mutex<HashMap<PathBuf, SharedConnection>> =
+    Default::default();
+}
+
+/// The files of a cache directory, stored in a single database. Entries are
+/// keyed by their path relative to the cache directory, so `DiskCache` and
+/// `HttpCache` can keep naming them as they do in the file layout.
+#[derive(Clone)]
+pub struct PackedCache {
+  location: PathBuf,
+  path: PathBuf,
+  conn: SharedConnection,
+}
+
+impl fmt::Debug for PackedCache {
+  fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+    f.debug_struct("PackedCache")
+      .field("path", &self.path)
+      .finish()
+  }
+}
+
+impl PackedCache {
+  /// Returns a packed cache for the cache directory `location` if the packed
+  /// backend is selected with `DENO_CACHE_BACKEND`.
+  pub fn from_env(location: &Path) -> Option<Self> {
+    match env::var(DENO_CACHE_BACKEND) {
+      Ok(backend) if backend == "packed" => Some(Self::new(location)),
+      _ => None,
+    }
+  }
+
+  /// Returns a packed cache for the cache directory `location`, which is
+  /// stored next to it, e.g. in `$DENO_DIR/deps.db` for `$DENO_DIR/deps`.
+  /// The database is only opened when the cache is first used, and only once
+  /// per process.
+  pub fn new(location: &Path) -> Self {
+    let path = location.with_extension("db");
+    let conn = CONNECTIONS.lock().entry(path.clone()).or_default().clone();
+    Self {
+      location: location.to_owned(),
+      path,
+      conn,
+    }
+  }
+
+  /// Returns the path of the database.
+  pub fn path(&self) -> &Path {
+    &self.path
+  }
+
+  /// Returns where the file at `path` is stored, to show it to the user: the
+  /// key of its entry, under the path of the database.
+  pub fn entry_path(&self, path: &Path) -> PathBuf {
+    match self.key(path) {
+      Ok(key) => self.path.join(key),
+      Err(_) => path.to_owned(),
+    }
+  }
+
+  /// Returns the contents of the file at `path`, which must be inside the
+  /// cache directory.
+  pub fn get(&self, path: &Path) -> Result<Option<Vec<u8>>, AnyError> {
+    let key = self.key(path)?;
+    self.with_conn(|conn| {
+      conn
+        .prepare_cached("SELECT data FROM entries WHERE key = ?")?
+        .query_row(params![key], |row| row.get(0))
+        .optional()
+    })
+  }
+
+  /// Stores the contents of several files at once, so either all or none of
+  /// them are stored.
+  pub fn set(&self, files: &[(&Path, &[u8])]) -> Result<(), AnyError> {
+    let entries = files
+      .iter()
+      .map(|(path, data)| Ok((self.key(path)?, *data)))
+      .collect::<Result<Vec<_>, AnyError>>()?;
+    self.with_conn(|conn| {
+      let tx = conn.transaction()?;
+      for (key, data) in &entries {
+        insert(&tx, key, data)?;
+      }
+      tx.commit()
+    })
+  }
+
+  /// Rewrites the database without its free pages. SQLite does this in a
+  /// transaction, so an interrupted compaction leaves the database as it was.
+  pub fn compact(&self) -> Result<(), AnyError> {
+    self.with_conn(|conn| conn.execute_batch("VACUUM"))
+  }
+
+  fn key(&self, path: &Path) -> Result<String, AnyError> {
+    path
+      .strip_prefix(&self.location)
+      .ok()
+      .and_then(|relative| {
+        relative
+          .components()
+          .map(|c| c.as_os_str().to_str())
+          .collect::<Option<Vec<_>>>()
+      })
+      .map(|components| components.join("/"))
+      .ok_or_else(|| {
+        generic_error(format!(
+          "Cannot store {:?} in the packed cache of {:?}.",
+          path, self.location
+        ))
+      })
+  }
+
+  fn with_conn<T>(
+    &self,
+    f: impl FnOnce(&mut Connection) -> rusqlite::Result<T>,
+  ) -> Result<T, AnyError> {
+    let mut maybe_conn = self.conn.lock();
+    if maybe_conn.is_none() {
+      *maybe_conn = Some(self.open()?);
+    }
+    Ok(f(maybe_conn.as_mut().unwrap())?)
+  }
+
+  fn open(&self) -> Result<Connection, AnyError> {
+    if let Some(parent) = self.path.parent() {
+      fs::create_dir_all(parent)?;
+    }
+    let mut conn = Connection::open(&self.path)?;
+    // Other processes may be writing to the cache at the same time.
+    conn.busy_timeout(Duration::from_secs(30))?;
+    conn.query_row("PRAGMA journal_mode = WAL", params![], |_| Ok(()))?;
+    conn.execute(
+      "CREATE TABLE IF NOT EXISTS entries (key TEXT PRIMARY KEY, data BLOB NOT NULL)",
+      params![],
+    )?;
+
+    // Only one process gets to import the existing files.
+    let tx = conn.transaction_with_behavior(TransactionBehavior::Immediate)?;
+    let version: u32 =
+      tx.query_row("PRAGMA user_version", params![], |row| row.get(0))?;
+    if version == 0 {
+      let count = self.import_files(&tx)?;
+      debug!("Imported {} files from {:?}.", count, self.location);
+      tx.execute_batch(&format!("PRAGMA user_version = {}", SCHEMA_VERSION))?;
+    }
+    tx.commit()?;
+
+    let page_count: i64 =
+      conn.query_row("PRAGMA page_count", params![], |row| row.get(0))?;
+    let free_count: i64 =
+      conn.query_row("PRAGMA freelist_count", params![], |row| row.get(0))?;
+    if free_count as f64 > page_count as f64 * MAX_FREE_PAGE_RATIO {
+      debug!("Compacting {:?}.", self.path);
+      conn.execute_batch("VACUUM")?;
+    }
+
+    Ok(conn)
+  }
+
+  /// Imports the files of the cache directory, so switching to the packed
+  /// backend doesn't require fetching and compiling everything again. The
+  /// files are left in place, so switching back keeps working, and can be
+  /// removed once they are no longer needed.
+  fn import_files(&self, tx: &Transaction) -> Result<usize, AnyError> {
+    if !self.location.is_dir() {
+      return Ok(0);
+    }
+    let mut count = 0;
+    for entry in WalkDir::new(&self.location) {
+      let entry = entry?;
+      if !entry.file_type().is_file() {
+        continue;
+      }
+      let key = match self.key(entry.path()) {
+        Ok(key) => key,
+        Err(err) => {
+          debug!("{}", err);
+          continue;
+        }
+      };
+      let data = fs::read(entry.path())?;
+      insert(tx, &key, &data)?;
+      count += 1;
+    }
+    Ok(count)
+  }
+}
+
+fn insert(tx: &Transaction, key: &str, data: &[u8]) -> rusqlite::Result<()> {
+  tx.prepare_cached(
+    "INSERT OR REPLACE INTO entries (key, data) VALUES (?, ?)",
+  )?
+  .execute(params![key, data])?;
+  Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+  use tempfile::TempDir;
+
+  #[test]
+  fn test_packed_cache() {
+    let temp_dir = TempDir::new().unwrap();
+    let location = temp_dir.path().join("deps");
+    let cache = PackedCache::new(&location);
+    let path = location.join("https/deno.land/abc");
+    assert_eq!(cache.get(&path).unwrap(), None);
+    let metadata_path = path.with_extension("metadata.json");
+    cache
+      .set(&[
+        (path.as_path(), &b"a"[..]),
+        (metadata_path.as_path(), &b"b"[..]),
+      ])
+      .unwrap();
+    assert_eq!(cache.get(&path).unwrap(), Some(b"a".to_vec()));
+    cache.set(&[(path.as_path(), &b"c"[..])]).unwrap();
+    cache.compact().unwrap();
+    assert_eq!(cache.get(&path).unwrap(), Some(b"c".to_vec()));
+    assert!(temp_dir.path().join("deps.db").is_file());
+    // Nothing is written to the cache directory itself.
+    assert!(!location.exists());
+    assert!(cache.get(&temp_dir.path().join("other/abc")).is_err());
+
+    // Another instance sees the same entries, through the same connection.
+    let other = PackedCache::new(&location);
+    assert!(Arc::ptr_eq(&cache.conn, &other.conn));
+    assert_eq!(other.get(&path).unwrap(), Some(b"c".to_vec()));
+    assert_eq!(
+      cache.entry_path(&path),
+      temp_dir.path().join("deps.db/https/deno.land/abc")
+    );
+  }
+
+  #[test]
+  fn test_packed_cache_imports_files() {
+    let temp_dir = TempDir::new().unwrap();
+    let location = temp_dir.path().join("gen");
+    let path = location.join("file/a/b.ts.js");
+    fs::create_dir_all(path.parent().unwrap()).unwrap();
+    fs::write(&path, "console.log(1);").unwrap();
+
+    let cache = PackedCache::new(&location);
+    assert_eq!(cache.get(&path).unwrap(), Some(b"console.log(1);".to_vec()));
+
+    // Files are only imported into a new database.
+    fs::write(location.join("file/a/c.ts.js"), "").unwrap();
+    let cache = PackedCache::new(&location);
+    assert_eq!(cache.get(&location.join("file/a/c.ts.js")).unwrap(), None);
+  }
+}
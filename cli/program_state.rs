@@ -12,8 +12,10 @@ use crate::module_graph::CheckOptions;
 use crate::module_graph::GraphBuilder;
 use crate::module_graph::TranspileOptions;
 use crate::module_graph::TypeLib;
+use crate::packed_cache::PackedCache;
 use crate::source_maps::SourceMapGetter;
 use crate::specifier_handler::FetchHandler;
+use crate::tsc;
 use crate::version;
 use deno_core::SharedArrayBufferStore;
 use deno_runtime::deno_broadcast_channel::InMemoryBroadcastChannel;
@@ -37,6 +39,7 @@ use std::collections::HashSet;
 use std::env;
 use std::fs::read;
 use std::sync::Arc;
+use std::time::Duration;
 
 /// This structure represents state of single "deno" program.
 ///
@@ -46,6 +49,14 @@ pub struct ProgramState {
   pub flags: flags::Flags,
   pub dir: deno_dir::DenoDir,
   pub coverage_dir: Option<String>,
+  /// Set from `DENO_UNSTABLE_STALL_THRESHOLD` (in milliseconds) when
+  /// `--unstable` is passed. Workers print the JS stack when a turn of their
+  /// event loop runs for longer than this.
+  pub stall_threshold: Option<Duration>,
+  /// Set from `DENO_UNSTABLE_OP_BUDGET` when `--unstable` is passed. Caps the
+  /// number of async op completions workers deliver to JS per turn of their
+  /// event loop.
+  pub op_budget: Option<usize>,
   pub file_fetcher: FileFetcher,
   pub modules:
     Arc<Mutex<HashMap<ModuleSpecifier, Result<ModuleSource, AnyError>>>>,
@@ -57,14 +68,31 @@ pub struct ProgramState {
   pub blob_store: BlobStore,
   pub broadcast_channel: InMemoryBroadcastChannel,
   pub shared_array_buffer_store: SharedArrayBufferStore,
+  /// Compiler runtimes that are kept warm between type checks.
+  pub compiler_pool: tsc::CompilerPool,
 }
 
 impl ProgramState {
   pub async fn build(flags: flags::Flags) -> Result<Arc<Self>, AnyError> {
+    Self::build_with_compiler_pool(flags, Default::default()).await
+  }
+
+  /// Like `build`, but type checks with the runtimes of an existing
+  /// `compiler_pool`, so they stay warm when the program state is rebuilt,
+  /// e.g. on every restart in watch mode.
+  pub async fn build_with_compiler_pool(
+    flags: flags::Flags,
+    compiler_pool: tsc::CompilerPool,
+  ) -> Result<Arc<Self>, AnyError> {
     let custom_root = env::var("DENO_DIR").map(String::into).ok();
     let dir = deno_dir::DenoDir::new(custom_root)?;
     let deps_cache_location = dir.root.join("deps");
-    let http_cache = http_cache::HttpCache::new(&deps_cache_location);
+    let http_cache = match PackedCache::from_env(&deps_cache_location) {
+      Some(pack) => {
+        http_cache::HttpCache::new_packed(&deps_cache_location, pack)
+      }
+      None => http_cache::HttpCache::new(&deps_cache_location),
+    };
     let ca_file = flags.ca_file.clone().or_else(|| env::var("DENO_CERT").ok());
     let ca_data = match &ca_file {
       Some(ca_file) => Some(read(ca_file).context("Failed to open ca file")?),
@@ -138,9 +166,28 @@ impl ProgramState {
       .clone()
       .or_else(|| env::var("DENO_UNSTABLE_COVERAGE_DIR").ok());
 
+    let stall_threshold = if flags.unstable {
+      env::var("DENO_UNSTABLE_STALL_THRESHOLD")
+        .ok()
+        .and_then(|millis| millis.parse().ok())
+        .map(Duration::from_millis)
+    } else {
+      None
+    };
+    let op_budget = if flags.unstable {
+      env::var("DENO_UNSTABLE_OP_BUDGET")
+        .ok()
+        .and_then(|budget| budget.parse().ok())
+        .filter(|budget| *budget > 0)
+    } else {
+      None
+    };
+
     let program_state = ProgramState {
       dir,
       coverage_dir,
+      stall_threshold,
+      op_budget,
       flags,
       file_fetcher,
       modules: Default::default(),
@@ -152,6 +199,7 @@ impl ProgramState {
       blob_store,
       broadcast_channel,
       shared_array_buffer_store,
+      compiler_pool,
     };
     Ok(Arc::new(program_state))
   }
@@ -208,6 +256,7 @@ impl ProgramState {
         maybe_config_file,
         reload: self.flags.reload,
         reload_exclusions,
+        maybe_compiler_pool: Some(self.compiler_pool.clone()),
       })?;
 
       debug!("{}", result_info.stats);
@@ -282,6 +331,7 @@ impl ProgramState {
         maybe_config_file,
         reload: self.flags.reload,
         reload_exclusions,
+        maybe_compiler_pool: Some(self.compiler_pool.clone()),
       })?;
 
       debug!("{}", result_info.stats);
@@ -353,6 +403,41 @@ impl ProgramState {
       })
   }
 
+  /// Returns the V8 code cache stored next to the emit of a module, if it was
+  /// created for the source code identified by `key`.
+  pub fn get_code_cache(&self, url: &Url, key: &str) -> Option<Vec<u8>> {
+    let filename = self
+      .dir
+      .gen_cache
+      .get_cache_filename_with_extension(url, "js.cache")?;
+    let data = self.dir.gen_cache.get(&filename).ok()?;
+    if data.len() > key.len() && data.starts_with(key.as_bytes()) {
+      Some(data[key.len()..].to_vec())
+    } else {
+      None
+    }
+  }
+
+  /// Stores a V8 code cache next to the emit of a module. The cache is
+  /// prefixed with `key`, so it is only used again for the same source code.
+  pub fn set_code_cache(
+    &self,
+    url: &Url,
+    key: &str,
+    code_cache: &[u8],
+  ) -> Result<(), AnyError> {
+    let filename = self
+      .dir
+      .gen_cache
+      .get_cache_filename_with_extension(url, "js.cache")
+      .ok_or_else(|| anyhow!("Cannot cache code for \"{}\".", url))?;
+    let mut data = Vec::with_capacity(key.len() + code_cache.len());
+    data.extend_from_slice(key.as_bytes());
+    data.extend_from_slice(code_cache);
+    self.dir.gen_cache.set(&filename, &data)?;
+    Ok(())
+  }
+
   // TODO(@kitsonk) this should be refactored to get it from the module graph
   fn get_emit(&self, url: &Url) -> Option<(Vec<u8>, Option<Vec<u8>>)> {
     match url.scheme() {
@@ -421,6 +506,16 @@ impl SourceMapGetter for ProgramState {
   }
 }
 
+/// Returns the key a V8 code cache of `code` is stored under. Code caches are
+/// only valid for the exact source and V8 version they were produced with.
+pub fn code_cache_key(code: &str) -> String {
+  crate::checksum::gen(&[
+    version::deno().as_bytes(),
+    deno_core::v8_version().as_bytes(),
+    code.as_bytes(),
+  ])
+}
+
 fn source_map_from_code(code: String) -> Option<Vec<u8>> {
   let lines: Vec<&str> = code.split('\n').collect();
   if let Some(last_line) = lines.last() {
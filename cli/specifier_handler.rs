@@ -228,6 +228,9 @@ pub struct FetchHandler {
   dynamic_permissions: Permissions,
   /// A clone of the `program_state` file fetcher.
   file_fetcher: FileFetcher,
+  /// If the imports of fetched modules should be prefetched. This is disabled
+  /// when an import map is used, as the pre-scan resolves imports without it.
+  prefetch: bool,
 }
 
 impl FetchHandler {
@@ -240,12 +243,14 @@ impl FetchHandler {
     let deno_dir = DenoDir::new(custom_root)?;
     let disk_cache = deno_dir.gen_cache;
     let file_fetcher = program_state.file_fetcher.clone();
+    let prefetch = program_state.maybe_import_map.is_none();
 
     Ok(FetchHandler {
       disk_cache,
       root_permissions,
       dynamic_permissions,
       file_fetcher,
+      prefetch,
     })
   }
 }
@@ -267,6 +272,7 @@ impl SpecifierHandler for FetchHandler {
     };
     let file_fetcher = self.file_fetcher.clone();
     let disk_cache = self.disk_cache.clone();
+    let prefetch = self.prefetch;
 
     async move {
       let source_file = file_fetcher
@@ -308,6 +314,15 @@ impl SpecifierHandler for FetchHandler {
             (requested_specifier.clone(), err)
           }
         })?;
+      if prefetch
+        && !file_fetcher
+          .prefetch_imports(&source_file, &permissions)
+          .is_empty()
+      {
+        // Let the prefetches send their requests before the module is handed
+        // to the graph, so that they are downloaded while it is parsed.
+        tokio::task::yield_now().await;
+      }
       let url = &source_file.specifier;
       let is_remote = !(url.scheme() == "file"
         || url.scheme() == "data"
@@ -334,7 +349,7 @@ impl SpecifierHandler for FetchHandler {
         disk_cache.get_cache_filename_with_extension(&url, "js.map");
       let maybe_map = if let Some(map_path) = map_path {
         if let Ok(map) = disk_cache.get(&map_path) {
-          maybe_map_path = Some(disk_cache.location.join(map_path));
+          maybe_map_path = Some(disk_cache.get_storage_filename(&map_path));
           Some(String::from_utf8(map).unwrap())
         } else {
           None
@@ -350,7 +365,7 @@ impl SpecifierHandler for FetchHandler {
           maybe_emit =
             Some(Emit::Cli((String::from_utf8(code).unwrap(), maybe_map)));
           maybe_emit_path =
-            Some((disk_cache.location.join(emit_path), maybe_map_path));
+            Some((disk_cache.get_storage_filename(&emit_path), maybe_map_path));
         }
       };
 
@@ -609,6 +624,7 @@ pub mod tests {
       root_permissions: Permissions::allow_all(),
       dynamic_permissions: Permissions::default(),
       file_fetcher,
+      prefetch: true,
     };
 
     (temp_dir, fetch_handler)
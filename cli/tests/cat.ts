@@ -1,9 +1,8 @@
-import { copy } from "../../test_util/std/io/util.ts";
 async function main(): Promise<void> {
-  for (let i = 1; i < Deno.args.length; i++) {
-    const filename = Deno.args[i];
+  for (const filename of Deno.args) {
     const file = await Deno.open(filename);
-    await copy(file, Deno.stdout);
+    // deno-lint-ignore no-deprecated-deno-api
+    await Deno.copy(file, Deno.stdout);
   }
 }
 
@@ -36,6 +36,43 @@ fn info_with_compiled_source() {
   assert_eq!(output.stderr, b"");
 }
 
+#[test]
+fn info_with_packed_cache() {
+  let _g = util::http_server();
+  let module_path = "http://127.0.0.1:4545/cli/tests/048_media_types_jsx.ts";
+  let t = TempDir::new().expect("tempdir fail");
+
+  let status = util::deno_cmd()
+    .env("DENO_DIR", t.path())
+    .env("DENO_CACHE_BACKEND", "packed")
+    .current_dir(util::root_path())
+    .arg("cache")
+    .arg(&module_path)
+    .spawn()
+    .expect("failed to spawn script")
+    .wait()
+    .expect("failed to wait for the child process");
+  assert!(status.success());
+
+  let output = util::deno_cmd()
+    .env("DENO_DIR", t.path())
+    .env("DENO_CACHE_BACKEND", "packed")
+    .env("NO_COLOR", "1")
+    .current_dir(util::root_path())
+    .arg("info")
+    .arg(&module_path)
+    .output()
+    .expect("failed to spawn script");
+
+  // Entries are reported inside the databases they are stored in.
+  let str_output = std::str::from_utf8(&output.stdout).unwrap().trim();
+  let deps_db = t.path().join("deps.db").join("http");
+  let gen_db = t.path().join("gen.db").join("http");
+  assert!(str_output.contains(&format!("local: {}", deps_db.display())));
+  assert!(str_output.contains(&format!("emit: {}", gen_db.display())));
+  assert_eq!(output.stderr, b"");
+}
+
 itest!(_022_info_flag_script {
   args: "info http://127.0.0.1:4545/cli/tests/019_media_types.ts",
   output: "022_info_flag_script.out",
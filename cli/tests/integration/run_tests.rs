@@ -1303,6 +1303,40 @@ fn should_not_panic_on_undefined_deno_dir_and_home_environment_variables() {
   assert!(output.status.success());
 }
 
+#[test]
+fn stall_detector() {
+  let output = util::deno_cmd()
+    .current_dir(util::root_path())
+    .arg("run")
+    .arg("--unstable")
+    .arg("cli/tests/stall.js")
+    .env("DENO_UNSTABLE_STALL_THRESHOLD", "100")
+    .stderr(std::process::Stdio::piped())
+    .spawn()
+    .unwrap()
+    .wait_with_output()
+    .unwrap();
+  assert!(output.status.success());
+  let stderr = std::str::from_utf8(&output.stderr).unwrap();
+  assert!(stderr.contains("has been running for more than 100ms"));
+  assert!(stderr.contains("at busyWait"));
+  assert!(stderr.contains("at stallingTimer"));
+
+  // The stall detector is only enabled with --unstable.
+  let output = util::deno_cmd()
+    .current_dir(util::root_path())
+    .arg("run")
+    .arg("cli/tests/stall.js")
+    .env("DENO_UNSTABLE_STALL_THRESHOLD", "100")
+    .stderr(std::process::Stdio::piped())
+    .spawn()
+    .unwrap()
+    .wait_with_output()
+    .unwrap();
+  assert!(output.status.success());
+  assert!(output.stderr.is_empty());
+}
+
 #[test]
 fn rust_log() {
   // Without RUST_LOG the stderr is empty.
@@ -132,3 +132,15 @@ itest!(shuffle_with_seed {
   exit_code: 0,
   output: "test/shuffle.out",
 });
+
+itest!(jobs {
+  args: "test --jobs=2 test/shuffle",
+  exit_code: 0,
+  output: "test/jobs.out",
+});
+
+itest!(jobs_isolate_files {
+  args: "test --jobs=2 --isolate-files test/shuffle",
+  exit_code: 0,
+  output: "test/jobs.out",
+});
@@ -0,0 +1,10 @@
+// Reads the files given as arguments, as text if the first argument is
+// `--text`.
+const text = Deno.args[0] === "--text";
+for (const filename of Deno.args.slice(text ? 1 : 0)) {
+  if (text) {
+    await Deno.readTextFile(filename);
+  } else {
+    await Deno.readFile(filename);
+  }
+}
@@ -0,0 +1,8 @@
+function busyWait(millis) {
+  const start = Date.now();
+  while (Date.now() - start < millis);
+}
+
+setTimeout(function stallingTimer() {
+  busyWait(500);
+}, 0);
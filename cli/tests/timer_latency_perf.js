@@ -0,0 +1,68 @@
+// Measures how late a 10ms interval timer fires while many connections push
+// bulk data over loopback TCP, and prints the 50th and 99th percentiles and
+// the maximum, in milliseconds, as JSON.
+const CONNECTIONS = 32;
+const CHUNK_SIZE = 16 * 1024;
+const DURATION = 3000;
+const INTERVAL = 10;
+
+const listener = Deno.listen({ hostname: "127.0.0.1", port: 0 });
+const { port } = listener.addr;
+let running = true;
+
+async function drain(conn) {
+  const buf = new Uint8Array(CHUNK_SIZE);
+  while ((await conn.read(buf)) !== null);
+  conn.close();
+}
+
+async function flood(conn) {
+  const chunk = new Uint8Array(CHUNK_SIZE);
+  try {
+    while (running) {
+      await conn.write(chunk);
+    }
+  } finally {
+    conn.close();
+  }
+}
+
+const servers = [];
+const clients = [];
+for (let i = 0; i < CONNECTIONS; i++) {
+  const client = await Deno.connect({ hostname: "127.0.0.1", port });
+  const server = await listener.accept();
+  servers.push(drain(server));
+  clients.push(flood(client));
+}
+
+const lateness = [];
+const start = performance.now();
+let expected = start + INTERVAL;
+await new Promise((resolve) => {
+  const id = setInterval(() => {
+    const now = performance.now();
+    lateness.push(now - expected);
+    expected = now + INTERVAL;
+    if (now - start >= DURATION) {
+      clearInterval(id);
+      resolve();
+    }
+  }, INTERVAL);
+});
+
+running = false;
+await Promise.all(clients);
+await Promise.all(servers);
+listener.close();
+
+lateness.sort((a, b) => a - b);
+function quantile(q) {
+  const index = Math.min(lateness.length - 1, Math.floor(lateness.length * q));
+  return lateness[index];
+}
+console.log(JSON.stringify({
+  p50: quantile(0.5),
+  p99: quantile(0.99),
+  max: lateness[lateness.length - 1],
+}));
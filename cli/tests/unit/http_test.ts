@@ -689,3 +689,172 @@ unitTest({ perms: { net: true } }, async function httpCookieConcatenation() {
   assertEquals(text, "ok");
   await promise;
 });
+
+unitTest(
+  { perms: { net: true } },
+  async function httpServerKeepAliveMethodAndUrl() {
+    const promise = (async () => {
+      const listener = Deno.listen({ port: 4501 });
+      const conn = await listener.accept();
+      listener.close();
+      const httpConn = Deno.serveHttp(conn);
+      const first = await httpConn.nextRequest();
+      assert(first);
+      assertEquals(first.request.method, "GET");
+      assertEquals(first.request.url, "http://127.0.0.1:4501/a?b=c");
+      await first.respondWith(new Response("a"));
+      const second = await httpConn.nextRequest();
+      assert(second);
+      assertEquals(second.request.method, "PROPFIND");
+      assertEquals(second.request.url, "http://127.0.0.1:4501/d");
+      assertEquals(second.request.headers.get("connection"), "close");
+      await second.respondWith(new Response("d"));
+      httpConn.close();
+    })();
+
+    const client = Deno.createHttpClient({});
+    const resp1 = await fetch("http://127.0.0.1:4501/a?b=c", { client });
+    assertEquals(await resp1.text(), "a");
+    const resp2 = await fetch("http://127.0.0.1:4501/d", {
+      client,
+      method: "PROPFIND",
+      headers: { "connection": "close" },
+    });
+    assertEquals(await resp2.text(), "d");
+    client.close();
+    await promise;
+  },
+);
+
+unitTest(
+  { perms: { net: true } },
+  async function httpServerStreamResponseBuffered() {
+    const chunks = 1000;
+    const promise = (async () => {
+      const listener = Deno.listen({ port: 4501 });
+      const conn = await listener.accept();
+      const httpConn = Deno.serveHttp(conn, { responseBodyBufferSize: 4096 });
+      const evt = await httpConn.nextRequest();
+      assert(evt);
+      const { respondWith } = evt;
+      let i = 0;
+      const body = new ReadableStream({
+        pull(controller) {
+          if (i === chunks) {
+            controller.close();
+          } else {
+            controller.enqueue(new TextEncoder().encode(`${i++},`));
+          }
+        },
+      });
+      await respondWith(new Response(body));
+      httpConn.close();
+      listener.close();
+    })();
+
+    const resp = await fetch("http://127.0.0.1:4501/", {
+      headers: { "connection": "close" },
+    });
+    const expected = Array.from({ length: chunks }, (_, i) => `${i},`);
+    assertEquals(await resp.text(), expected.join(""));
+    await promise;
+  },
+);
+
+unitTest(
+  { perms: { net: true } },
+  async function httpServerStreamResponseBufferedFlushesOnStall() {
+    // The second chunk is only enqueued once the client got the first one, so
+    // the first one has to be sent without waiting for the buffer to fill up
+    // or for the body to end.
+    const firstChunkReceived = deferred();
+    const promise = (async () => {
+      const listener = Deno.listen({ port: 4501 });
+      const conn = await listener.accept();
+      const httpConn = Deno.serveHttp(conn, { responseBodyBufferSize: 4096 });
+      const evt = await httpConn.nextRequest();
+      assert(evt);
+      const { respondWith } = evt;
+      const body = new ReadableStream({
+        async start(controller) {
+          controller.enqueue(new TextEncoder().encode("first,"));
+          await firstChunkReceived;
+          controller.enqueue(new TextEncoder().encode("second"));
+          controller.close();
+        },
+      });
+      await respondWith(new Response(body));
+      httpConn.close();
+      listener.close();
+    })();
+
+    const resp = await fetch("http://127.0.0.1:4501/", {
+      headers: { "connection": "close" },
+    });
+    const reader = resp.body!.getReader();
+    const decoder = new TextDecoder();
+    let text = "";
+    while (text !== "first,") {
+      const { value, done } = await reader.read();
+      assert(!done);
+      text += decoder.decode(value);
+    }
+    firstChunkReceived.resolve();
+    while (true) {
+      const { value, done } = await reader.read();
+      if (done) break;
+      text += decoder.decode(value);
+    }
+    assertEquals(text, "first,second");
+    await promise;
+  },
+);
+
+unitTest(
+  { perms: { net: true } },
+  async function httpServerRequestHeadersAfterRespond() {
+    const promise = (async () => {
+      const listener = Deno.listen({ port: 4501 });
+      const conn = await listener.accept();
+      listener.close();
+      const httpConn = Deno.serveHttp(conn);
+      const event = await httpConn.nextRequest();
+      assert(event);
+      await event.respondWith(new Response("ok"));
+      assertEquals(event.request.headers.get("x-foo"), "bar");
+      httpConn.close();
+    })();
+
+    const resp = await fetch("http://127.0.0.1:4501/", {
+      headers: { "x-foo": "bar" },
+    });
+    assertEquals(await resp.text(), "ok");
+    await promise;
+  },
+);
+
+unitTest(
+  { perms: { net: true } },
+  async function httpServerRequestHeadersUnread() {
+    const promise = (async () => {
+      const listener = Deno.listen({ port: 4501 });
+      const conn = await listener.accept();
+      listener.close();
+      const httpConn = Deno.serveHttp(conn);
+      const event = await httpConn.nextRequest();
+      assert(event);
+      assert(Object.values(Deno.resources()).includes("requestHeaders"));
+      // The headers are never read, so the resource holding them has to be
+      // closed by `respondWith()`. The resource sanitizer checks it is.
+      await event.respondWith(new Response("ok"));
+      assert(!Object.values(Deno.resources()).includes("requestHeaders"));
+      httpConn.close();
+    })();
+
+    const resp = await fetch("http://127.0.0.1:4501/", {
+      headers: { "x-foo": "bar" },
+    });
+    assertEquals(await resp.text(), "ok");
+    await promise;
+  },
+);
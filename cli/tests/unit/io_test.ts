@@ -75,3 +75,52 @@ unitTest({ perms: { write: true } }, async function copyBufferToFile() {
   write.close();
   await Deno.remove(filePath);
 });
+
+unitTest(
+  { perms: { read: true, write: true } },
+  async function copyFileToFile() {
+    const dir = Deno.makeTempDirSync();
+    const xBytes = repeat("c", 100 * 1024);
+    Deno.writeFileSync(dir + "/src.txt", xBytes);
+    const src = await Deno.open(dir + "/src.txt");
+    const dst = await Deno.create(dir + "/dst.txt");
+
+    // Only the rest of the file is copied.
+    await src.read(new Uint8Array(1024));
+    // deno-lint-ignore no-deprecated-deno-api
+    const n = await Deno.copy(src, dst);
+
+    assertEquals(n, xBytes.length - 1024);
+    assertEquals(Deno.readFileSync(dir + "/dst.txt"), xBytes.subarray(1024));
+    src.close();
+    dst.close();
+  },
+);
+
+unitTest(
+  { perms: { read: true, write: true, net: true } },
+  async function copyFileToConn() {
+    const filePath = Deno.makeTempDirSync() + "/test.txt";
+    // Large enough to fill the socket buffers.
+    const xBytes = repeat("d", 4 * 1024 * 1024);
+    Deno.writeFileSync(filePath, xBytes);
+    const listener = Deno.listen({ hostname: "127.0.0.1", port: 3513 });
+    const accepted = listener.accept();
+    const conn = await Deno.connect({ hostname: "127.0.0.1", port: 3513 });
+    const serverConn = await accepted;
+    const file = await Deno.open(filePath);
+
+    // deno-lint-ignore no-deprecated-deno-api
+    const received = Deno.readAll(serverConn);
+    // deno-lint-ignore no-deprecated-deno-api
+    const n = await Deno.copy(file, conn);
+    conn.closeWrite();
+
+    assertEquals(n, xBytes.length);
+    assertEquals(await received, xBytes);
+    file.close();
+    conn.close();
+    serverConn.close();
+    listener.close();
+  },
+);
@@ -4,6 +4,7 @@
 import {
   assert,
   assertEquals,
+  assertThrows,
 } from "../../../test_util/std/testing/asserts.ts";
 import { deferred } from "../../../test_util/std/async/deferred.ts";
 
@@ -57,3 +58,39 @@ Deno.test("messagechannel clone port", async () => {
   mc.port2.close();
   mc2.port2.close();
 });
+
+Deno.test("messagechannel transfer arraybuffer", async () => {
+  const mc = new MessageChannel();
+  const buffer = new Uint8Array([1, 2, 3]).buffer;
+
+  const promise = deferred();
+
+  mc.port2.onmessage = (e) => {
+    const { view } = e.data;
+    assert(view instanceof Uint8Array);
+    assertEquals(view, new Uint8Array([1, 2, 3]));
+    promise.resolve();
+  };
+
+  mc.port1.postMessage({ view: new Uint8Array(buffer) }, [buffer]);
+  assertEquals(buffer.byteLength, 0);
+  mc.port1.close();
+
+  await promise;
+
+  mc.port2.close();
+});
+
+Deno.test("messagechannel transfer detached arraybuffer", () => {
+  const mc = new MessageChannel();
+  const buffer = new ArrayBuffer(8);
+  mc.port1.postMessage(null, [buffer]);
+  assertEquals(buffer.byteLength, 0);
+  assertThrows(
+    () => mc.port1.postMessage(null, [buffer]),
+    DOMException,
+    "Can not transfer detached ArrayBuffer",
+  );
+  mc.port1.close();
+  mc.port2.close();
+});
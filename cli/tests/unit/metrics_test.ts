@@ -1,5 +1,5 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
-import { assert, unitTest } from "./test_util.ts";
+import { assert, assertEquals, unitTest } from "./test_util.ts";
 
 unitTest(async function metrics(): Promise<void> {
   // Write to stdout to ensure a "data" message gets sent instead of just
@@ -76,3 +76,33 @@ unitTest(function metricsForOpCrates(): void {
   assert(m1.opsDispatched > 0);
   assert(m1.opsCompleted > 0);
 });
+
+unitTest(async function metricsPerOp(): Promise<void> {
+  Deno.metrics({ perOp: true });
+  await Deno.stdout.write(new Uint8Array([13, 13, 13]));
+  const _ = new URL("https://deno.land");
+
+  const { perOp } = Deno.metrics({ perOp: true });
+  assert(perOp);
+  const write = perOp["op_write_async"];
+  assert(write.asyncTime.count > 0);
+  assert(write.asyncTime.p50 <= write.asyncTime.p99);
+  assert(write.asyncTime.p99 <= write.asyncTime.max);
+  assert(write.bytesSent.max >= 3);
+  const urlParse = perOp["op_url_parse"];
+  assert(urlParse.syncTime.count > 0);
+  assert(urlParse.syncTime.buckets.length > 0);
+});
+
+unitTest(async function metricsEventLoop(): Promise<void> {
+  const before = Deno.metrics().eventLoop;
+  await new Promise((resolve) => setTimeout(resolve, 0));
+  const after = Deno.metrics().eventLoop;
+  assert(after.turns > before.turns);
+  assert(after.lag.count > before.lag.count);
+  assert(after.lag.p50 <= after.lag.max);
+  assert(after.phases.macrotasks > before.phases.macrotasks);
+  // The timer completes through an async op.
+  assert(after.opsPerTurn.count > before.opsPerTurn.count);
+  assertEquals(after.opBudgetExhaustedTurns, 0);
+});
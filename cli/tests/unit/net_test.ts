@@ -19,6 +19,27 @@ unitTest({ perms: { net: true } }, function netTcpListenClose(): void {
   listener.close();
 });
 
+unitTest(
+  { ignore: Deno.build.os === "windows", perms: { net: true } },
+  async function netTcpListenReusePort() {
+    const options = { hostname: "127.0.0.1", port: 3500, reusePort: true };
+    const listener1 = Deno.listen(options);
+    const listener2 = Deno.listen(options);
+    assertEquals(listener1.addr, listener2.addr);
+    assertThrows(() => {
+      Deno.listen({ hostname: "127.0.0.1", port: 3500 });
+    }, Deno.errors.AddrInUse);
+
+    // Whichever listener the kernel picks accepts the connection.
+    const accepted = Promise.race([listener1.accept(), listener2.accept()]);
+    const conn = await Deno.connect({ hostname: "127.0.0.1", port: 3500 });
+    (await accepted).close();
+    conn.close();
+    listener1.close();
+    listener2.close();
+  },
+);
+
 unitTest(
   {
     perms: { net: true },
@@ -87,3 +87,17 @@ unitTest(
     assertEquals(resourcesBefore, Deno.resources());
   },
 );
+
+unitTest(
+  { perms: { read: true, write: true } },
+  async function readTextFileDecodesLikeTextDecoder(): Promise<void> {
+    const filename = Deno.makeTempDirSync() + "/test.txt";
+    // A BOM, followed by "hi" and an invalid byte.
+    Deno.writeFileSync(
+      filename,
+      new Uint8Array([0xef, 0xbb, 0xbf, 104, 105, 0xff]),
+    );
+    assertEquals(Deno.readTextFileSync(filename), "hi�");
+    assertEquals(await Deno.readTextFile(filename), "hi�");
+  },
+);
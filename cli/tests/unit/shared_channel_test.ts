@@ -0,0 +1,63 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+import { assert, assertEquals, assertThrows, unitTest } from "./test_util.ts";
+
+unitTest(function sharedChannelSendRecv(): void {
+  const channel = new Deno.SharedChannel(64);
+  assertEquals(channel.capacity, 64);
+  assertEquals(channel.buffer.byteLength, 96);
+  // Enough messages to wrap around the ring a few times, with lengths that
+  // aren't multiples of 4.
+  for (let i = 0; i < 100; i++) {
+    const message = new Uint8Array(i % 30).fill(i);
+    assert(channel.trySend(message));
+    assertEquals(channel.tryRecv(), message);
+  }
+  assertEquals(channel.tryRecv(), null);
+  assertEquals(channel.recvSync(10), null);
+});
+
+unitTest(function sharedChannelFull(): void {
+  const channel = new Deno.SharedChannel(64);
+  // Every message takes 4 bytes for its length and 12 for its data.
+  for (let i = 0; i < 4; i++) {
+    assert(channel.trySend(new Uint8Array(10).fill(i)));
+  }
+  assert(!channel.trySend(new Uint8Array(1)));
+  assert(!channel.send(new Uint8Array(1), 10));
+  assertEquals(channel.tryRecv(), new Uint8Array(10).fill(0));
+  assert(channel.trySend(new Uint8Array(1)));
+  assertThrows(() => channel.send(new Uint8Array(64)), RangeError);
+});
+
+unitTest(function sharedChannelOpenBuffer(): void {
+  const channel = new Deno.SharedChannel(64);
+  const other = new Deno.SharedChannel(channel.buffer);
+  assertEquals(other.capacity, 64);
+  channel.send(new Uint8Array([1, 2, 3]));
+  assertEquals(other.recvSync(), new Uint8Array([1, 2, 3]));
+  assertThrows(() => new Deno.SharedChannel(100), RangeError);
+  assertThrows(() => new Deno.SharedChannel(new SharedArrayBuffer(8)));
+});
+
+unitTest(function sharedChannelClose(): void {
+  const channel = new Deno.SharedChannel(64);
+  channel.send(new Uint8Array([1]));
+  channel.close();
+  assert(channel.closed);
+  assertThrows(() => channel.send(new Uint8Array([2])), Error, "closed");
+  // Messages sent before closing are still received.
+  assertEquals(channel.recvSync(), new Uint8Array([1]));
+  assertEquals(channel.recvSync(), null);
+});
+
+unitTest(async function sharedChannelRecvAsync(): Promise<void> {
+  const channel = new Deno.SharedChannel(64);
+  // The message is sent by a timer, which only fires because `recv()` doesn't
+  // block the event loop.
+  const timer = setTimeout(() => channel.send(new Uint8Array([1])), 10);
+  assertEquals(await channel.recv(), new Uint8Array([1]));
+  clearTimeout(timer);
+  assertEquals(await channel.recv(10), null);
+  setTimeout(() => channel.close(), 10);
+  assertEquals(await channel.recv(), null);
+});
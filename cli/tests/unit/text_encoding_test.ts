@@ -84,6 +84,21 @@ unitTest(function textDecoder2(): void {
   assertEquals(decoder.decode(fixture), "𝓽𝓮𝔁𝓽");
 });
 
+unitTest(function textDecoderOneShot(): void {
+  const decoder = new TextDecoder();
+  const ascii = "a".repeat(1000);
+  assertEquals(decoder.decode(new TextEncoder().encode(ascii)), ascii);
+  // A leading BOM is stripped and invalid sequences are replaced, like the
+  // streaming decoder does.
+  const fixture = new Uint8Array([0xef, 0xbb, 0xbf, 0x61, 0xff, 0xc3, 0xa9]);
+  assertEquals(decoder.decode(fixture), "a\ufffd\u00e9");
+  assertEquals(
+    decoder.decode(fixture.subarray(3), { stream: true }),
+    "a\ufffd\u00e9",
+  );
+  assertEquals(decoder.decode(), "");
+});
+
 // ignoreBOM is tested through WPT
 
 unitTest(function textDecoderASCII(): void {
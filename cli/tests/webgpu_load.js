@@ -0,0 +1,3 @@
+// WebGPU is a lazy extension: this loads it, which "hello" never does.
+navigator.gpu;
+console.log("Hello World");
@@ -0,0 +1,28 @@
+// Benchmark measures time it takes to run tasks on a pool of workers. It does
+// the same amount of work as bench_round_robin.ts, so the two can be compared.
+const data = "HTTP/1.1 200 OK\r\nContent-Length: 12\r\n\r\nHello World\n";
+const workerCount = 4;
+const cmdsPerWorker = 400;
+
+async function main(): Promise<void> {
+  const pool = new Deno.WorkerPool(
+    new URL("bench_worker.ts", import.meta.url).href,
+    { type: "module", size: workerCount },
+  );
+  for (const cmdId of Array(cmdsPerWorker).keys()) {
+    const promises: Array<Promise<{ cmdId: number; data: string }>> = [];
+    for (let i = 0; i < workerCount; ++i) {
+      promises.push(pool.run({ cmdId, action: 1, data }));
+    }
+    for (const promise of promises) {
+      const result = await promise;
+      if (result.cmdId !== cmdId || result.data !== data) {
+        throw new Error(`Unexpected result: ${JSON.stringify(result)}`);
+      }
+    }
+  }
+  pool.terminate();
+  console.log("Finished!");
+}
+
+main();
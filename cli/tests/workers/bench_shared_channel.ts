@@ -0,0 +1,40 @@
+// Benchmark measures time it takes to send messages to a group of workers
+// through shared channels and receive their responses. It does the same amount
+// of work as bench_round_robin.ts, which uses postMessage, so the two can be
+// compared.
+const data = new TextEncoder().encode(
+  "HTTP/1.1 200 OK\r\nContent-Length: 12\r\n\r\nHello World\n",
+);
+const workerCount = 4;
+const cmdsPerWorker = 400;
+
+function main(): void {
+  const workers: Array<[Deno.SharedChannel, Deno.SharedChannel]> = [];
+  for (let i = 1; i <= workerCount; ++i) {
+    const worker = new Worker(
+      new URL("shared_channel_worker.ts", import.meta.url).href,
+      { type: "module", deno: { namespace: true } },
+    );
+    const requests = new Deno.SharedChannel();
+    const responses = new Deno.SharedChannel();
+    worker.postMessage([requests.buffer, responses.buffer]);
+    workers.push([requests, responses]);
+  }
+  for (let cmdId = 0; cmdId < cmdsPerWorker; ++cmdId) {
+    for (const [requests] of workers) {
+      requests.send(data);
+    }
+    for (const [, responses] of workers) {
+      const response = responses.recvSync();
+      if (response?.byteLength !== data.byteLength) {
+        throw new Error(`Unexpected response: ${response}`);
+      }
+    }
+  }
+  for (const [requests] of workers) {
+    requests.close();
+  }
+  console.log("Finished!");
+}
+
+main();
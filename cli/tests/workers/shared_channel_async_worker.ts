@@ -0,0 +1,18 @@
+// Sends every message it receives on the first channel back on the second
+// one, until the first channel is closed. Waits for them with the async
+// `recv()`, and echoes the strings posted to it in the meantime.
+self.onmessage = async (
+  e: MessageEvent<string | [SharedArrayBuffer, SharedArrayBuffer]>,
+) => {
+  if (typeof e.data === "string") {
+    self.postMessage(e.data);
+    return;
+  }
+  const requests = new Deno.SharedChannel(e.data[0]);
+  const responses = new Deno.SharedChannel(e.data[1]);
+  let message;
+  while ((message = await requests.recv()) !== null) {
+    responses.send(message);
+  }
+  self.postMessage("closed");
+};
@@ -0,0 +1,11 @@
+// Sends every message it receives on the first channel back on the second
+// one, until the first channel is closed.
+self.onmessage = (e: MessageEvent<[SharedArrayBuffer, SharedArrayBuffer]>) => {
+  const requests = new Deno.SharedChannel(e.data[0]);
+  const responses = new Deno.SharedChannel(e.data[1]);
+  let message;
+  while ((message = requests.recvSync()) !== null) {
+    responses.send(message);
+  }
+  self.close();
+};
@@ -6,6 +6,7 @@ import {
   assert,
   assertEquals,
   assertThrows,
+  assertThrowsAsync,
 } from "../../../test_util/std/testing/asserts.ts";
 import { deferred } from "../../../test_util/std/async/deferred.ts";
 import { fromFileUrl } from "../../../test_util/std/path/mod.ts";
@@ -850,3 +851,106 @@ Deno.test({
     worker.terminate();
   },
 });
+
+Deno.test({
+  name: "worker pool",
+  fn: async function (): Promise<void> {
+    const pool = new Deno.WorkerPool(
+      new URL("bench_worker.ts", import.meta.url).href,
+      { type: "module", size: 2 },
+    );
+    assertEquals(pool.size, 2);
+    const results = await Promise.all(
+      Array.from(
+        { length: 10 },
+        (_, cmdId) => pool.run({ cmdId, action: 1, data: `${cmdId}` }),
+      ),
+    );
+    assertEquals(
+      results,
+      Array.from({ length: 10 }, (_, cmdId) => ({ cmdId, data: `${cmdId}` })),
+    );
+    pool.terminate();
+    await assertThrowsAsync(() => pool.run({ action: 2 }), TypeError);
+  },
+});
+
+Deno.test({
+  name: "worker pool with failing module",
+  fn: async function (): Promise<void> {
+    const pool = new Deno.WorkerPool(
+      new URL("throwing_worker.js", import.meta.url).href,
+      { type: "module", size: 2 },
+    );
+    await assertThrowsAsync(() => pool.run("Hello World"), Error);
+    pool.terminate();
+  },
+});
+
+Deno.test({
+  name: "worker pool with failing task",
+  fn: async function (): Promise<void> {
+    const pool = new Deno.WorkerPool(
+      new URL("throwing_task_worker.js", import.meta.url).href,
+      { type: "module", size: 1 },
+    );
+    await assertThrowsAsync(() => pool.run("throw"), Error, "Task failed");
+    // The worker that failed was replaced.
+    assertEquals(await Promise.all([pool.run(1), pool.run(2)]), [2, 4]);
+    pool.terminate();
+  },
+});
+
+Deno.test({
+  name: "shared channel",
+  fn: async function (): Promise<void> {
+    const worker = new Worker(
+      new URL("shared_channel_worker.ts", import.meta.url).href,
+      { type: "module", deno: { namespace: true } },
+    );
+    const requests = new Deno.SharedChannel(1024);
+    const responses = new Deno.SharedChannel(1024);
+    worker.postMessage([requests.buffer, responses.buffer]);
+    for (let i = 0; i < 1000; i++) {
+      const message = new Uint8Array(i % 100).fill(i);
+      requests.send(message);
+      assertEquals(responses.recvSync(), message);
+    }
+    requests.close();
+    assertEquals(responses.recvSync(100), null);
+    worker.terminate();
+  },
+});
+
+Deno.test({
+  name: "shared channel async recv",
+  fn: async function (): Promise<void> {
+    const worker = new Worker(
+      new URL("shared_channel_async_worker.ts", import.meta.url).href,
+      { type: "module", deno: { namespace: true } },
+    );
+    const messages: string[] = [];
+    let onMessage = deferred();
+    worker.onmessage = (e: MessageEvent<string>) => {
+      messages.push(e.data);
+      onMessage.resolve();
+    };
+    const requests = new Deno.SharedChannel(1024);
+    const responses = new Deno.SharedChannel(1024);
+    worker.postMessage([requests.buffer, responses.buffer]);
+    // The worker still handles messages while it waits on the channel.
+    worker.postMessage("ping");
+    await onMessage;
+    assertEquals(messages, ["ping"]);
+    for (let i = 0; i < 100; i++) {
+      const message = new Uint8Array(i % 100).fill(i);
+      requests.send(message);
+      assertEquals(responses.recvSync(), message);
+    }
+    onMessage = deferred();
+    requests.close();
+    await onMessage;
+    assertEquals(messages, ["ping", "closed"]);
+    worker.terminate();
+  },
+});
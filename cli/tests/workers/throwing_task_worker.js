@@ -0,0 +1,7 @@
+// This worker throws an error for the task "throw", and doubles any other
+onmessage = function (e) {
+  if (e.data === "throw") {
+    throw new Error("Task failed");
+  }
+  postMessage(e.data * 2);
+};
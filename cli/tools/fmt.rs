@@ -13,6 +13,7 @@ use crate::file_watcher;
 use crate::file_watcher::ResolutionResult;
 use crate::fs_util::{collect_files, get_extension, is_supported_ext_fmt};
 use crate::text_encoding;
+use crate::tools::incremental_cache::IncrementalCache;
 use deno_core::error::generic_error;
 use deno_core::error::AnyError;
 use deno_core::futures;
@@ -30,12 +31,16 @@ use std::sync::{Arc, Mutex};
 
 const BOM_CHAR: char = '\u{FEFF}';
 
+/// Remembers the files that are already formatted.
+type FmtCache = IncrementalCache<()>;
+
 /// Format JavaScript/TypeScript files.
 pub async fn format(
   args: Vec<PathBuf>,
   ignore: Vec<PathBuf>,
   check: bool,
   watch: bool,
+  no_cache: bool,
 ) -> Result<(), AnyError> {
   let resolver = |changed: Option<Vec<PathBuf>>| {
     let files_changed = changed.is_some();
@@ -66,13 +71,21 @@ pub async fn format(
   };
   let operation = |paths: Vec<PathBuf>| {
     let config = get_typescript_config();
+    // The formatting configuration isn't configurable, so it is covered by
+    // the Deno version that the cache is keyed by.
+    let cache = Arc::new(FmtCache::new("fmt", &[], no_cache));
     async move {
-      if check {
-        check_source_files(config, paths).await?;
+      let result = if check {
+        check_source_files(config, paths, cache.clone()).await
       } else {
-        format_source_files(config, paths).await?;
+        format_source_files(config, paths, cache.clone()).await
+      };
+      if let Ok(cache) = Arc::try_unwrap(cache) {
+        if let Err(err) = cache.save() {
+          debug!("Failed to save the fmt cache: {}", err);
+        }
       }
-      Ok(())
+      result
     }
   };
 
@@ -174,6 +187,7 @@ pub fn format_file(
 async fn check_source_files(
   config: dprint_plugin_typescript::configuration::Configuration,
   paths: Vec<PathBuf>,
+  cache: Arc<FmtCache>,
 ) -> Result<(), AnyError> {
   let not_formatted_files_count = Arc::new(AtomicUsize::new(0));
   let checked_files_count = Arc::new(AtomicUsize::new(0));
@@ -187,10 +201,15 @@ async fn check_source_files(
     move |file_path| {
       checked_files_count.fetch_add(1, Ordering::Relaxed);
       let file_text = read_file_contents(&file_path)?.text;
+      if cache.get(&file_path, &file_text).is_some() {
+        return Ok(());
+      }
 
       match format_file(&file_path, &file_text, config) {
         Ok(formatted_text) => {
-          if formatted_text != file_text {
+          if formatted_text == file_text {
+            cache.set(&file_path, &file_text, ());
+          } else {
             not_formatted_files_count.fetch_add(1, Ordering::Relaxed);
             let _g = output_lock.lock().unwrap();
             let diff = diff(&file_text, &formatted_text);
@@ -230,6 +249,7 @@ async fn check_source_files(
 async fn format_source_files(
   config: dprint_plugin_typescript::configuration::Configuration,
   paths: Vec<PathBuf>,
+  cache: Arc<FmtCache>,
 ) -> Result<(), AnyError> {
   let formatted_files_count = Arc::new(AtomicUsize::new(0));
   let checked_files_count = Arc::new(AtomicUsize::new(0));
@@ -241,9 +261,13 @@ async fn format_source_files(
     move |file_path| {
       checked_files_count.fetch_add(1, Ordering::Relaxed);
       let file_contents = read_file_contents(&file_path)?;
+      if cache.get(&file_path, &file_contents.text).is_some() {
+        return Ok(());
+      }
 
       match format_file(&file_path, &file_contents.text, config) {
         Ok(formatted_text) => {
+          cache.set(&file_path, &formatted_text, ());
           if formatted_text != file_contents.text {
             write_file_contents(
               &file_path,
@@ -0,0 +1,232 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+
+//! A persistent cache of per-file results of `deno fmt` and `deno lint`,
+//! stored in `DENO_DIR`, that allows files that haven't changed since a
+//! previous run to be skipped without being parsed.
+//!
+//! Entries are keyed by file path and content hash. Each Deno version and tool
+//! configuration gets a cache file of its own, so that switching between
+//! projects with different configurations doesn't discard either cache.
+
+use crate::checksum;
+use crate::deno_dir::DenoDir;
+use crate::fs_util;
+use crate::version;
+use deno_core::error::AnyError;
+use deno_core::serde_json;
+use log::debug;
+use serde::de::DeserializeOwned;
+use serde::Deserialize;
+use serde::Serialize;
+use std::collections::hash_map::Entry;
+use std::collections::HashMap;
+use std::env;
+use std::fs;
+use std::path::Path;
+use std::path::PathBuf;
+use std::sync::Mutex;
+
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct CacheData<T> {
+  state_hash: String,
+  files: HashMap<PathBuf, CacheEntry<T>>,
+}
+
+#[derive(Clone, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct CacheEntry<T> {
+  source_hash: String,
+  data: T,
+}
+
+pub struct IncrementalCache<T> {
+  maybe_path: Option<PathBuf>,
+  state_hash: String,
+  /// The entries that were in the cache when it was opened.
+  previous: HashMap<PathBuf, CacheEntry<T>>,
+  /// The entries of the files that were looked up or stored during this run.
+  current: Mutex<HashMap<PathBuf, CacheEntry<T>>>,
+}
+
+impl<T: Clone + Serialize + DeserializeOwned> IncrementalCache<T> {
+  /// Opens the cache of the tool `name` in `DENO_DIR`. `state` is anything
+  /// that the results of the tool depend on besides the source of a file,
+  /// like its configuration. When `no_cache` is set, existing results are
+  /// ignored and overwritten.
+  pub fn new(name: &str, state: &[&str], no_cache: bool) -> Self {
+    let custom_root = env::var("DENO_DIR").map(String::into).ok();
+    let maybe_dir = match DenoDir::new(custom_root) {
+      Ok(dir) => Some(dir.root.join(format!("{}_cache_v1", name))),
+      Err(err) => {
+        debug!("Could not open the {} cache: {}", name, err);
+        None
+      }
+    };
+    Self::with_dir(maybe_dir, state, no_cache)
+  }
+
+  fn with_dir(
+    maybe_dir: Option<PathBuf>,
+    state: &[&str],
+    no_cache: bool,
+  ) -> Self {
+    let mut state_data = vec![version::deno()];
+    state_data.extend(state.iter().map(|s| s.to_string()));
+    let state_hash = checksum::gen(&state_data);
+
+    let maybe_path =
+      maybe_dir.map(|dir| dir.join(format!("{}.json", state_hash)));
+    let previous = match &maybe_path {
+      Some(path) if !no_cache => Self::read(path, &state_hash),
+      _ => HashMap::new(),
+    };
+
+    Self {
+      maybe_path,
+      state_hash,
+      previous,
+      current: Mutex::new(HashMap::new()),
+    }
+  }
+
+  fn read(path: &Path, state_hash: &str) -> HashMap<PathBuf, CacheEntry<T>> {
+    let cache_data = fs::read(path)
+      .ok()
+      .and_then(|bytes| serde_json::from_slice::<CacheData<T>>(&bytes).ok());
+    match cache_data {
+      Some(cache_data) if cache_data.state_hash == state_hash => {
+        cache_data.files
+      }
+      _ => HashMap::new(),
+    }
+  }
+
+  /// Returns the result stored for `file_path`, if its source hasn't changed
+  /// since it was stored.
+  pub fn get(&self, file_path: &Path, source: &str) -> Option<T> {
+    let source_hash = checksum::gen(&[source]);
+    let mut current = self.current.lock().unwrap();
+    let entry = match current.entry(file_path.to_path_buf()) {
+      Entry::Occupied(entry) => entry.into_mut(),
+      Entry::Vacant(entry) => {
+        entry.insert(self.previous.get(file_path)?.clone())
+      }
+    };
+    if entry.source_hash == source_hash {
+      Some(entry.data.clone())
+    } else {
+      None
+    }
+  }
+
+  pub fn set(&self, file_path: &Path, source: &str, data: T) {
+    let entry = CacheEntry {
+      source_hash: checksum::gen(&[source]),
+      data,
+    };
+    let mut current = self.current.lock().unwrap();
+    current.insert(file_path.to_path_buf(), entry);
+  }
+
+  /// Writes the cache back to `DENO_DIR`. Entries of files that weren't
+  /// visited during this run, like files that have been removed since, are
+  /// dropped. The cache is merged with what is on disk now rather than
+  /// overwriting it, so that the results of runs that finished in the
+  /// meantime are kept.
+  pub fn save(self) -> Result<(), AnyError> {
+    let path = match self.maybe_path {
+      Some(path) => path,
+      None => return Ok(()),
+    };
+    let current = self.current.into_inner().unwrap();
+    let mut files = Self::read(&path, &self.state_hash);
+    for (file_path, entry) in &self.previous {
+      let unchanged = files
+        .get(file_path)
+        .map_or(false, |e| e.source_hash == entry.source_hash);
+      if unchanged && !current.contains_key(file_path) {
+        files.remove(file_path);
+      }
+    }
+    files.extend(current);
+
+    let cache_data = CacheData {
+      state_hash: self.state_hash,
+      files,
+    };
+    let json = serde_json::to_vec(&cache_data)?;
+    fs::create_dir_all(path.parent().unwrap())?;
+    fs_util::atomic_write_file(&path, json, 0o644)?;
+    Ok(())
+  }
+}
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+  use tempfile::TempDir;
+
+  #[test]
+  fn test_incremental_cache() {
+    let temp_dir = TempDir::new().expect("could not create temp dir");
+    let cache_dir = Some(temp_dir.path().join("test_cache_v1"));
+    let file_path = PathBuf::from("/a.ts");
+
+    let cache =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &["a"], false);
+    assert_eq!(cache.get(&file_path, "1"), None);
+    cache.set(&file_path, "1", 42);
+    assert_eq!(cache.get(&file_path, "1"), Some(42));
+    assert_eq!(cache.get(&file_path, "2"), None);
+    cache.save().unwrap();
+
+    let cache =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &["a"], false);
+    assert_eq!(cache.get(&file_path, "1"), Some(42));
+    // A different configuration doesn't see the entries...
+    let cache =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &["b"], false);
+    assert_eq!(cache.get(&file_path, "1"), None);
+    cache.set(&file_path, "1", 43);
+    cache.save().unwrap();
+    // ...and doesn't discard them either.
+    let cache =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &["a"], false);
+    assert_eq!(cache.get(&file_path, "1"), Some(42));
+    // `--no-cache` ignores them.
+    let cache = IncrementalCache::<u32>::with_dir(cache_dir, &["a"], true);
+    assert_eq!(cache.get(&file_path, "1"), None);
+  }
+
+  #[test]
+  fn test_incremental_cache_save() {
+    let temp_dir = TempDir::new().expect("could not create temp dir");
+    let cache_dir = Some(temp_dir.path().join("test_cache_v1"));
+    let a = PathBuf::from("/a.ts");
+    let b = PathBuf::from("/b.ts");
+    let c = PathBuf::from("/c.ts");
+
+    let cache =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &[], false);
+    cache.set(&a, "a", 1);
+    cache.set(&b, "b", 2);
+    cache.save().unwrap();
+
+    // Two runs that overlap. The first one only visits `a`, as if `b` had
+    // been removed, and the second one adds `c`.
+    let first =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &[], false);
+    let second =
+      IncrementalCache::<u32>::with_dir(cache_dir.clone(), &[], false);
+    assert_eq!(first.get(&a, "a"), Some(1));
+    second.set(&c, "c", 3);
+    second.save().unwrap();
+    first.save().unwrap();
+
+    let cache = IncrementalCache::<u32>::with_dir(cache_dir, &[], false);
+    assert_eq!(cache.get(&a, "a"), Some(1));
+    assert_eq!(cache.get(&b, "b"), None);
+    assert_eq!(cache.get(&c, "c"), Some(3));
+  }
+}
@@ -236,6 +236,10 @@ pub fn install(
     executable_args.push("--cached-only".to_string());
   }
 
+  if flags.no_code_cache {
+    executable_args.push("--no-code-cache".to_string());
+  }
+
   if !flags.v8_flags.is_empty() {
     executable_args.push(format!("--v8-flags={}", flags.v8_flags.join(",")));
   }
@@ -12,15 +12,19 @@ use crate::fmt_errors;
 use crate::fs_util::{collect_files, is_supported_ext};
 use crate::media_type::MediaType;
 use crate::tools::fmt::run_parallelized;
+use crate::tools::incremental_cache::IncrementalCache;
 use deno_core::error::{generic_error, AnyError, JsStackFrame};
 use deno_core::serde_json;
 use deno_lint::diagnostic::LintDiagnostic;
+use deno_lint::diagnostic::Position;
+use deno_lint::diagnostic::Range;
 use deno_lint::linter::Linter;
 use deno_lint::linter::LinterBuilder;
 use deno_lint::rules;
 use deno_lint::rules::LintRule;
 use log::debug;
 use log::info;
+use serde::Deserialize;
 use serde::Serialize;
 use std::fs;
 use std::io::{stdin, Read};
@@ -45,6 +49,7 @@ pub async fn lint_files(
   args: Vec<PathBuf>,
   ignore: Vec<PathBuf>,
   json: bool,
+  no_cache: bool,
 ) -> Result<(), AnyError> {
   if args.len() == 1 && args[0].to_string_lossy() == "-" {
     return lint_stdin(json);
@@ -69,11 +74,18 @@ pub async fn lint_files(
   };
   let reporter_lock = Arc::new(Mutex::new(create_reporter(reporter_kind)));
 
+  let rule_codes: Vec<&str> = rules::get_recommended_rules()
+    .iter()
+    .map(|rule| rule.code())
+    .collect();
+  let cache = Arc::new(LintCache::new("lint", &rule_codes, no_cache));
+
   run_parallelized(target_files, {
     let reporter_lock = reporter_lock.clone();
     let has_error = has_error.clone();
+    let cache = cache.clone();
     move |file_path| {
-      let r = lint_file(file_path.clone());
+      let r = lint_file(file_path.clone(), &cache);
       let mut reporter = reporter_lock.lock().unwrap();
 
       match r {
@@ -94,6 +106,12 @@ pub async fn lint_files(
   })
   .await?;
 
+  if let Ok(cache) = Arc::try_unwrap(cache) {
+    if let Err(err) = cache.save() {
+      debug!("Failed to save the lint cache: {}", err);
+    }
+  }
+
   let has_error = has_error.load(Ordering::Relaxed);
 
   reporter_lock.lock().unwrap().close(target_files_len);
@@ -143,11 +161,66 @@ pub fn create_linter(syntax: Syntax, rules: Vec<Box<dyn LintRule>>) -> Linter {
     .build()
 }
 
+/// Remembers the diagnostics of files that were already linted.
+type LintCache = IncrementalCache<Vec<CachedLintDiagnostic>>;
+
+/// A copy of `LintDiagnostic` that can be read back from the lint cache.
+#[derive(Clone, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct CachedLintDiagnostic {
+  start: (usize, usize, usize),
+  end: (usize, usize, usize),
+  filename: String,
+  message: String,
+  code: String,
+  hint: Option<String>,
+}
+
+impl From<&LintDiagnostic> for CachedLintDiagnostic {
+  fn from(d: &LintDiagnostic) -> Self {
+    let start = &d.range.start;
+    let end = &d.range.end;
+    Self {
+      start: (start.line, start.col, start.byte_pos),
+      end: (end.line, end.col, end.byte_pos),
+      filename: d.filename.clone(),
+      message: d.message.clone(),
+      code: d.code.clone(),
+      hint: d.hint.clone(),
+    }
+  }
+}
+
+impl From<CachedLintDiagnostic> for LintDiagnostic {
+  fn from(d: CachedLintDiagnostic) -> Self {
+    let to_position = |(line, col, byte_pos)| Position {
+      line,
+      col,
+      byte_pos,
+    };
+    Self {
+      range: Range {
+        start: to_position(d.start),
+        end: to_position(d.end),
+      },
+      filename: d.filename,
+      message: d.message,
+      code: d.code,
+      hint: d.hint,
+    }
+  }
+}
+
 fn lint_file(
   file_path: PathBuf,
+  cache: &LintCache,
 ) -> Result<(Vec<LintDiagnostic>, String), AnyError> {
   let file_name = file_path.to_string_lossy().to_string();
   let source_code = fs::read_to_string(&file_path)?;
+  if let Some(cached) = cache.get(&file_path, &source_code) {
+    let file_diagnostics = cached.into_iter().map(LintDiagnostic::from);
+    return Ok((file_diagnostics.collect(), source_code));
+  }
   let media_type = MediaType::from(&file_path);
   let syntax = ast::get_syntax(&media_type);
 
@@ -155,6 +228,14 @@ fn lint_file(
   let linter = create_linter(syntax, lint_rules);
 
   let (_, file_diagnostics) = linter.lint(file_name, source_code.clone())?;
+  cache.set(
+    &file_path,
+    &source_code,
+    file_diagnostics
+      .iter()
+      .map(CachedLintDiagnostic::from)
+      .collect(),
+  );
 
   Ok((file_diagnostics, source_code))
 }
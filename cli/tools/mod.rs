@@ -3,6 +3,7 @@
 pub mod coverage;
 pub mod doc;
 pub mod fmt;
+pub mod incremental_cache;
 pub mod installer;
 pub mod lint;
 pub mod repl;
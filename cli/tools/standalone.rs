@@ -219,6 +219,7 @@ pub fn compile_to_runtime_flags(
     lock_write: false,
     log_level: flags.log_level,
     no_check: false,
+    no_code_cache: false,
     prompt: flags.prompt,
     no_remote: false,
     reload: false,
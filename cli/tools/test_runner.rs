@@ -18,6 +18,7 @@ use deno_core::futures::FutureExt;
 use deno_core::futures::StreamExt;
 use deno_core::located_script_name;
 use deno_core::serde_json::json;
+use deno_core::serde_json::Value;
 use deno_core::url::Url;
 use deno_core::ModuleSpecifier;
 use deno_runtime::permissions::Permissions;
@@ -26,15 +27,25 @@ use rand::seq::SliceRandom;
 use rand::SeedableRng;
 use regex::Regex;
 use serde::Deserialize;
+use std::collections::HashSet;
 use std::path::Path;
 use std::path::PathBuf;
 use std::sync::mpsc::channel;
 use std::sync::mpsc::Sender;
 use std::sync::Arc;
+use std::sync::Condvar;
+use std::sync::Mutex;
 use std::time::Duration;
 use std::time::Instant;
 use swc_common::comments::CommentKind;
 
+/// The minimum number of remaining tests of a test module for an idle worker
+/// to load the module as well and take some of them.
+const MIN_STOLEN_TESTS: usize = 2;
+
+/// The number of slowest tests that are listed after a concurrent run.
+const SLOWEST_TESTS: usize = 10;
+
 #[derive(Debug, Clone, PartialEq, Deserialize)]
 #[serde(rename_all = "camelCase")]
 pub struct TestDescription {
@@ -76,6 +87,7 @@ pub struct TestSummary {
   pub filtered_out: usize,
   pub measured: usize,
   pub failures: Vec<(TestDescription, String)>,
+  pub timings: Vec<(TestDescription, u64)>,
 }
 
 impl TestSummary {
@@ -88,6 +100,7 @@ impl TestSummary {
       filtered_out: 0,
       measured: 0,
       failures: Vec::new(),
+      timings: Vec::new(),
     }
   }
 
@@ -172,6 +185,19 @@ impl TestReporter for PrettyTestReporter {
       }
     }
 
+    if self.concurrent && !summary.timings.is_empty() {
+      let mut timings = summary.timings.iter().collect::<Vec<_>>();
+      timings.sort_by(|(_, a), (_, b)| b.cmp(a));
+      println!("\nslowest tests:\n");
+      for (description, elapsed) in timings.into_iter().take(SLOWEST_TESTS) {
+        println!(
+          "\t{} {}",
+          description.name,
+          colors::gray(format!("({}ms, {})", elapsed, description.origin))
+        );
+      }
+    }
+
     let status = if summary.has_failed() || summary.has_pending() {
       colors::red("FAILED").to_string()
     } else {
@@ -259,6 +285,126 @@ where
   Ok(prepared)
 }
 
+struct TestQueue {
+  /// The number of tests of the test module that run, which is known once the
+  /// first worker that loaded the module has registered them.
+  total: Option<usize>,
+  next: usize,
+}
+
+struct TestSchedulerState {
+  queues: Vec<TestQueue>,
+  next_module: usize,
+}
+
+/// Distributes the tests of several test modules over a pool of workers.
+///
+/// Test modules are handed out to the workers one at a time. Once every
+/// module has been handed out, idle workers steal from the module with the
+/// most remaining tests: they load the module as well, and take its tests
+/// from the queue they share with the other workers that loaded it.
+pub struct TestScheduler {
+  state: Mutex<TestSchedulerState>,
+  condvar: Condvar,
+}
+
+impl TestScheduler {
+  pub fn new(module_count: usize) -> Self {
+    let queues = (0..module_count)
+      .map(|_| TestQueue {
+        total: None,
+        next: 0,
+      })
+      .collect();
+    Self {
+      state: Mutex::new(TestSchedulerState {
+        queues,
+        next_module: 0,
+      }),
+      condvar: Condvar::new(),
+    }
+  }
+
+  /// Returns the index of the next test module for a worker that has already
+  /// loaded the modules in `loaded`, or `None` if there is nothing left to
+  /// run. Blocks while there is nothing to steal, but other workers are still
+  /// loading modules that may have enough tests to steal from.
+  fn next_module(&self, loaded: &HashSet<usize>) -> Option<usize> {
+    let mut state = self.state.lock().unwrap();
+    loop {
+      if state.next_module < state.queues.len() {
+        state.next_module += 1;
+        return Some(state.next_module - 1);
+      }
+
+      let mut loading = false;
+      let mut maybe_victim: Option<(usize, usize)> = None;
+      for (index, queue) in state.queues.iter().enumerate() {
+        if loaded.contains(&index) {
+          continue;
+        }
+        let remaining = match queue.total {
+          Some(total) => total - queue.next,
+          None => {
+            loading = true;
+            continue;
+          }
+        };
+        if remaining >= MIN_STOLEN_TESTS
+          && maybe_victim.map_or(true, |(_, most)| remaining > most)
+        {
+          maybe_victim = Some((index, remaining));
+        }
+      }
+
+      if let Some((index, _)) = maybe_victim {
+        return Some(index);
+      }
+      if !loading {
+        return None;
+      }
+      state = self.condvar.wait(state).unwrap();
+    }
+  }
+
+  /// Sets the number of tests of a test module that run. Returns true for the
+  /// first worker that loaded the module, which reports its plan.
+  pub fn start(&self, module: usize, total: usize) -> bool {
+    let mut state = self.state.lock().unwrap();
+    let queue = &mut state.queues[module];
+    if queue.total.is_some() {
+      return false;
+    }
+    queue.total = Some(total);
+    self.condvar.notify_all();
+    true
+  }
+
+  /// Takes the index of the next test of a test module to run.
+  pub fn next_test(&self, module: usize) -> Option<usize> {
+    let mut state = self.state.lock().unwrap();
+    let queue = &mut state.queues[module];
+    match queue.total {
+      Some(total) if queue.next < total => {
+        queue.next += 1;
+        Some(queue.next - 1)
+      }
+      _ => None,
+    }
+  }
+
+  /// Called when a worker that loaded a test module failed, so workers that
+  /// wait for the module to be loaded don't wait forever.
+  fn abandon(&self, module: usize) {
+    let mut state = self.state.lock().unwrap();
+    let queue = &mut state.queues[module];
+    if queue.total.is_none() {
+      queue.total = Some(0);
+      self.condvar.notify_all();
+    }
+  }
+}
+
 pub async fn run_test_file(
   program_state: Arc<ProgramState>,
   main_module: ModuleSpecifier,
@@ -318,8 +464,118 @@ pub async fn run_test_file(
   Ok(())
 }
 
+/// Runs the test modules handed out by `scheduler` on a single worker, which is
+/// reused for as many of them as possible. `modules` holds each test module
+/// along with the module that runs its tests.
+async fn run_test_queues(
+  program_state: Arc<ProgramState>,
+  permissions: Permissions,
+  channel: Sender<TestEvent>,
+  scheduler: Arc<TestScheduler>,
+  modules: Arc<Vec<(ModuleSpecifier, ModuleSpecifier)>>,
+  loaded: &mut HashSet<usize>,
+) -> Result<(), AnyError> {
+  let first_index = match scheduler.next_module(loaded) {
+    Some(index) => index,
+    None => return Ok(()),
+  };
+  loaded.insert(first_index);
+  let mut worker = create_main_worker(
+    &program_state,
+    modules[first_index].0.clone(),
+    permissions,
+    true,
+  );
+
+  {
+    let op_state = worker.js_runtime.op_state();
+    let mut op_state = op_state.borrow_mut();
+    op_state.put::<Sender<TestEvent>>(channel);
+    op_state.put::<Arc<TestScheduler>>(scheduler.clone());
+  }
+
+  let mut maybe_coverage_collector = if let Some(ref coverage_dir) =
+    program_state.coverage_dir
+  {
+    let session = worker.create_inspector_session().await;
+    let coverage_dir = PathBuf::from(coverage_dir);
+    let mut coverage_collector = CoverageCollector::new(coverage_dir, session);
+    worker
+      .with_event_loop(coverage_collector.start_collecting().boxed_local())
+      .await?;
+
+    Some(coverage_collector)
+  } else {
+    None
+  };
+
+  let mut maybe_index = Some(first_index);
+  while let Some(index) = maybe_index {
+    loaded.insert(index);
+    let (test_module, runner_module) = &modules[index];
+    // The test origin and `Deno.mainModule` follow the module being run.
+    worker
+      .js_runtime
+      .op_state()
+      .borrow_mut()
+      .put::<ModuleSpecifier>(test_module.clone());
+
+    worker.execute_module(test_module).await?;
+    if index == first_index {
+      worker.execute_script(
+        &located_script_name!(),
+        "window.dispatchEvent(new Event('load'))",
+      )?;
+    }
+    worker.execute_module(runner_module).await?;
+    worker
+      .run_event_loop(maybe_coverage_collector.is_none())
+      .await?;
+
+    maybe_index = scheduler.next_module(loaded);
+  }
+
+  worker.execute_script(
+    &located_script_name!(),
+    "window.dispatchEvent(new Event('unload'))",
+  )?;
+
+  if let Some(coverage_collector) = maybe_coverage_collector.as_mut() {
+    worker
+      .with_event_loop(coverage_collector.stop_collecting().boxed_local())
+      .await?;
+  }
+
+  Ok(())
+}
+
+/// Inserts a module that runs the tests registered by test modules into the
+/// cache. Because scripts, and therefore worker.execute cannot detect
+/// unresolved promises at the moment, the tests are run by a module.
+fn insert_runner_module(
+  program_state: &ProgramState,
+  name: &str,
+  options: &Value,
+) -> Result<ModuleSpecifier, AnyError> {
+  let specifier = deno_core::resolve_path(name)?;
+  let source = format!("await Deno[Deno.internal].runTests({});", options);
+  program_state.file_fetcher.insert_cached(File {
+    local: specifier.to_file_path().unwrap(),
+    maybe_types: None,
+    media_type: MediaType::JavaScript,
+    source,
+    specifier: specifier.clone(),
+  });
+  Ok(specifier)
+}
+
 /// Runs tests.
 ///
+/// With more than one concurrent job, the tests are run by a pool of workers
+/// that share their test modules through a `TestScheduler`, unless
+/// `isolate_files` is set, in which case every test module is run by a fresh
+/// worker.
+///
 /// Returns a boolean indicating whether the tests failed.
 #[allow(clippy::too_many_arguments)]
 pub async fn run_tests(
@@ -335,6 +591,7 @@ pub async fn run_tests(
   filter: Option<String>,
   shuffle: Option<u64>,
   concurrent_jobs: usize,
+  isolate_files: bool,
 ) -> Result<bool, AnyError> {
   let test_modules = if let Some(seed) = shuffle {
     let mut rng = SmallRng::seed_from_u64(seed);
@@ -446,56 +703,106 @@ pub async fn run_tests(
     return Ok(false);
   }
 
-  // Because scripts, and therefore worker.execute cannot detect unresolved promises at the moment
-  // we generate a module for the actual test execution.
   let test_options = json!({
       "disableLog": quiet,
       "filter": filter,
       "shuffle": shuffle,
   });
 
-  let test_module = deno_core::resolve_path("$deno$test.js")?;
-  let test_source =
-    format!("await Deno[Deno.internal].runTests({});", test_options);
-  let test_file = File {
-    local: test_module.to_file_path().unwrap(),
-    maybe_types: None,
-    media_type: MediaType::JavaScript,
-    source: test_source.clone(),
-    specifier: test_module.clone(),
-  };
-
-  program_state.file_fetcher.insert_cached(test_file);
-
   let (sender, receiver) = channel::<TestEvent>();
 
-  let join_handles = test_modules.iter().map(move |main_module| {
-    let program_state = program_state.clone();
-    let main_module = main_module.clone();
-    let test_module = test_module.clone();
-    let permissions = permissions.clone();
-    let sender = sender.clone();
-
-    tokio::task::spawn_blocking(move || {
-      let join_handle = std::thread::spawn(move || {
-        let future = run_test_file(
-          program_state,
-          main_module,
-          test_module,
-          permissions,
-          sender,
-        );
-
-        tokio_util::run_basic(future)
-      });
+  let join_futures = if concurrent_jobs > 1 && !isolate_files {
+    let modules = test_modules
+      .iter()
+      .enumerate()
+      .map(|(index, test_module)| {
+        let mut options = test_options.clone();
+        options["queue"] = json!(index);
+        let runner_module = insert_runner_module(
+          &program_state,
+          &format!("$deno$test${}.js", index),
+          &options,
+        )?;
+        Ok((test_module.clone(), runner_module))
+      })
+      .collect::<Result<Vec<_>, AnyError>>()?;
+    let modules = Arc::new(modules);
+    let scheduler = Arc::new(TestScheduler::new(modules.len()));
+
+    let join_handles = (0..concurrent_jobs.min(modules.len())).map(move |_| {
+      let program_state = program_state.clone();
+      let permissions = permissions.clone();
+      let sender = sender.clone();
+      let scheduler = scheduler.clone();
+      let modules = modules.clone();
+
+      tokio::task::spawn_blocking(move || {
+        let join_handle = std::thread::spawn(move || {
+          let mut loaded = HashSet::new();
+          let mut result = Ok(());
+          // A worker that failed is replaced by a fresh one, which picks up
+          // the modules that are left.
+          loop {
+            let future = run_test_queues(
+              program_state.clone(),
+              permissions.clone(),
+              sender.clone(),
+              scheduler.clone(),
+              modules.clone(),
+              &mut loaded,
+            );
+            match tokio_util::run_basic(future) {
+              Ok(()) => break result,
+              Err(err) => {
+                for index in &loaded {
+                  scheduler.abandon(*index);
+                }
+                if result.is_ok() {
+                  result = Err(err);
+                }
+              }
+            }
+          }
+        });
 
-      join_handle.join().unwrap()
-    })
-  });
+        join_handle.join().unwrap()
+      })
+    });
 
-  let join_futures = stream::iter(join_handles)
-    .buffer_unordered(concurrent_jobs)
-    .collect::<Vec<Result<Result<(), AnyError>, tokio::task::JoinError>>>();
+    future::join_all(join_handles.collect::<Vec<_>>()).boxed()
+  } else {
+    let test_module =
+      insert_runner_module(&program_state, "$deno$test.js", &test_options)?;
+
+    let join_handles = test_modules.iter().map(move |main_module| {
+      let program_state = program_state.clone();
+      let main_module = main_module.clone();
+      let test_module = test_module.clone();
+      let permissions = permissions.clone();
+      let sender = sender.clone();
+
+      tokio::task::spawn_blocking(move || {
+        let join_handle = std::thread::spawn(move || {
+          let future = run_test_file(
+            program_state,
+            main_module,
+            test_module,
+            permissions,
+            sender,
+          );
+
+          tokio_util::run_basic(future)
+        });
+
+        join_handle.join().unwrap()
+      })
+    });
+
+    stream::iter(join_handles)
+      .buffer_unordered(concurrent_jobs)
+      .collect::<Vec<Result<Result<(), AnyError>, tokio::task::JoinError>>>()
+      .boxed()
+  };
 
   let mut reporter = create_reporter(concurrent_jobs > 1);
   let handler = {
@@ -538,6 +845,7 @@ pub async fn run_tests(
             }
 
             reporter.report_result(&description, &result, elapsed);
+            summary.timings.push((description, elapsed));
           }
         }
 
@@ -582,6 +890,37 @@ pub async fn run_tests(
 mod tests {
   use super::*;
 
+  #[test]
+  fn test_scheduler() {
+    let scheduler = TestScheduler::new(2);
+    let mut first = HashSet::new();
+    let mut second = HashSet::new();
+    assert_eq!(scheduler.next_module(&first), Some(0));
+    first.insert(0);
+    assert_eq!(scheduler.next_module(&second), Some(1));
+    second.insert(1);
+
+    assert!(scheduler.start(0, 5));
+    assert_eq!(scheduler.next_test(0), Some(0));
+    assert!(scheduler.start(1, 1));
+    assert_eq!(scheduler.next_test(1), Some(0));
+    assert_eq!(scheduler.next_test(1), None);
+
+    // The second worker steals from the first module, and both take its
+    // tests from the same queue.
+    assert_eq!(scheduler.next_module(&second), Some(0));
+    second.insert(0);
+    assert!(!scheduler.start(0, 5));
+    assert_eq!(scheduler.next_test(0), Some(1));
+    assert_eq!(scheduler.next_test(0), Some(2));
+    assert_eq!(scheduler.next_test(0), Some(3));
+    // A single remaining test isn't worth loading the module for.
+    assert_eq!(scheduler.next_module(&HashSet::new()), None);
+    assert_eq!(scheduler.next_test(0), Some(4));
+    assert_eq!(scheduler.next_test(0), None);
+    assert_eq!(scheduler.next_module(&first), None);
+  }
+
   #[test]
   fn test_collect_test_module_specifiers() {
     let test_data_path = test_util::root_path().join("cli/tests/subdir");
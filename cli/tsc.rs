@@ -27,7 +27,9 @@ use deno_core::RuntimeOptions;
 use deno_core::Snapshot;
 use std::collections::HashMap;
 use std::path::PathBuf;
+use std::sync::mpsc;
 use std::sync::Arc;
+use std::thread;
 
 // Declaration files
 
@@ -490,14 +492,45 @@ fn op_respond(state: &mut State, args: Value) -> Result<Value, AnyError> {
   Ok(json!(true))
 }
 
-/// Execute a request on the supplied snapshot, returning a response which
-/// contains information, like any emitted files, diagnostics, statistics and
-/// optionally an updated TypeScript build info.
-pub fn exec(request: Request) -> Result<Response, AnyError> {
+/// Creates a compiler runtime from the snapshot, with the ops registered and
+/// the compiler started, ready to execute requests.
+fn create_runtime() -> Result<JsRuntime, AnyError> {
   let mut runtime = JsRuntime::new(RuntimeOptions {
     startup_snapshot: Some(compiler_snapshot()),
     ..Default::default()
   });
+
+  runtime.register_op("op_cwd", op(op_cwd));
+  runtime.register_op("op_create_hash", op(op_create_hash));
+  runtime.register_op("op_emit", op(op_emit));
+  runtime.register_op("op_exists", op(op_exists));
+  runtime.register_op("op_load", op(op_load));
+  runtime.register_op("op_resolve", op(op_resolve));
+  runtime.register_op("op_respond", op(op_respond));
+  runtime.sync_ops_cache();
+
+  let startup_source = "globalThis.startup({ legacyFlag: false })";
+  runtime
+    .execute_script(&located_script_name!(), startup_source)
+    .context("Could not properly start the compiler runtime.")?;
+
+  Ok(runtime)
+}
+
+/// Execute a request on the supplied snapshot, returning a response which
+/// contains information, like any emitted files, diagnostics, statistics and
+/// optionally an updated TypeScript build info.
+pub fn exec(request: Request) -> Result<Response, AnyError> {
+  let mut runtime = create_runtime()?;
+  exec_with_runtime(&mut runtime, request)
+}
+
+/// Execute a request on a compiler runtime that has already been started,
+/// possibly by a previous request.
+fn exec_with_runtime(
+  runtime: &mut JsRuntime,
+  request: Request,
+) -> Result<Response, AnyError> {
   // tsc cannot handle root specifiers that don't have one of the "acceptable"
   // extensions.  Therefore, we have to check the root modules against their
   // extensions and remap any that are unacceptable to tsc and add them to the
@@ -543,16 +576,6 @@ pub fn exec(request: Request) -> Result<Response, AnyError> {
     ));
   }
 
-  runtime.register_op("op_cwd", op(op_cwd));
-  runtime.register_op("op_create_hash", op(op_create_hash));
-  runtime.register_op("op_emit", op(op_emit));
-  runtime.register_op("op_exists", op(op_exists));
-  runtime.register_op("op_load", op(op_load));
-  runtime.register_op("op_resolve", op(op_resolve));
-  runtime.register_op("op_respond", op(op_respond));
-  runtime.sync_ops_cache();
-
-  let startup_source = "globalThis.startup({ legacyFlag: false })";
   let request_value = json!({
     "config": request.config,
     "debug": request.debug,
@@ -561,9 +584,6 @@ pub fn exec(request: Request) -> Result<Response, AnyError> {
   let request_str = request_value.to_string();
   let exec_source = format!("globalThis.exec({})", request_str);
 
-  runtime
-    .execute_script(&located_script_name!(), startup_source)
-    .context("Could not properly start the compiler runtime.")?;
   runtime.execute_script(&located_script_name!(), &exec_source)?;
 
   let op_state = runtime.op_state();
@@ -587,6 +607,100 @@ pub fn exec(request: Request) -> Result<Response, AnyError> {
   }
 }
 
+/// Execute a request on a runtime of `maybe_pool` if there is one, otherwise
+/// on a new runtime.
+pub fn exec_with_pool(
+  maybe_pool: Option<&CompilerPool>,
+  request: Request,
+) -> Result<Response, AnyError> {
+  match maybe_pool {
+    Some(pool) => pool.exec(request),
+    None => exec(request),
+  }
+}
+
+/// The number of started compiler runtimes that a `CompilerPool` keeps around
+/// once they are no longer in use.
+const MAX_IDLE_COMPILERS: usize = 2;
+
+/// A pool of compiler runtimes that are kept warm between requests, so that
+/// repeated type checks in the same process (watch mode, `deno test`,
+/// `Deno.emit()`) don't pay for restoring the snapshot and starting the
+/// compiler again, and reuse the lib files that tsc has already parsed.
+///
+/// `JsRuntime` can't be shared between threads, so each runtime lives on its
+/// own thread and requests are passed to it over a channel.
+#[derive(Debug, Clone, Default)]
+pub struct CompilerPool(Arc<Mutex<Vec<CompilerWorker>>>);
+
+impl CompilerPool {
+  /// Execute a request on an idle compiler runtime of the pool, starting a
+  /// new one if there is none.
+  pub fn exec(&self, request: Request) -> Result<Response, AnyError> {
+    let maybe_worker = self.0.lock().pop();
+    let worker = match maybe_worker {
+      Some(worker) => worker,
+      None => CompilerWorker::spawn()?,
+    };
+    let (worker, response) = worker.exec(request)?;
+    // A runtime whose request errored is dropped, as its state is unknown.
+    let mut idle = self.0.lock();
+    if idle.len() < MAX_IDLE_COMPILERS {
+      idle.push(worker);
+    }
+    Ok(response)
+  }
+}
+
+#[derive(Debug)]
+struct CompilerWorker {
+  request_tx: mpsc::Sender<Request>,
+  response_rx: mpsc::Receiver<Result<Response, AnyError>>,
+  handle: Option<thread::JoinHandle<()>>,
+}
+
+impl CompilerWorker {
+  fn spawn() -> Result<Self, AnyError> {
+    let (request_tx, request_rx) = mpsc::channel::<Request>();
+    let (response_tx, response_rx) = mpsc::channel();
+    let handle =
+      thread::Builder::new()
+        .name("tsc".to_string())
+        .spawn(move || {
+          let mut maybe_runtime = create_runtime();
+          for request in request_rx {
+            let result = match &mut maybe_runtime {
+              Ok(runtime) => exec_with_runtime(runtime, request),
+              Err(err) => Err(anyhow!("{}", err)),
+            };
+            let is_err = result.is_err();
+            if response_tx.send(result).is_err() || is_err {
+              break;
+            }
+          }
+        })?;
+    Ok(Self {
+      request_tx,
+      response_rx,
+      handle: Some(handle),
+    })
+  }
+
+  fn exec(mut self, request: Request) -> Result<(Self, Response), AnyError> {
+    let _ = self.request_tx.send(request);
+    match self.response_rx.recv() {
+      Ok(Ok(response)) => Ok((self, response)),
+      Ok(Err(err)) => Err(err),
+      // The compiler thread panicked, surface the panic on this thread like
+      // it would have been if the request was executed here.
+      Err(_) => match self.handle.take().unwrap().join() {
+        Err(panic) => std::panic::resume_unwind(panic),
+        Ok(()) => Err(anyhow!("The compiler runtime exited unexpectedly.")),
+      },
+    }
+  }
+}
+
 #[cfg(test)]
 mod tests {
   use super::*;
@@ -631,6 +745,13 @@ mod tests {
 
   async fn test_exec(
     specifier: &ModuleSpecifier,
+  ) -> Result<Response, AnyError> {
+    test_exec_with_pool(specifier, None).await
+  }
+
+  async fn test_exec_with_pool(
+    specifier: &ModuleSpecifier,
+    maybe_pool: Option<&CompilerPool>,
   ) -> Result<Response, AnyError> {
     let hash_data = vec![b"something".to_vec()];
     let c = PathBuf::from(env::var_os("CARGO_MANIFEST_DIR").unwrap());
@@ -668,7 +789,7 @@ mod tests {
       maybe_tsbuildinfo: None,
       root_names: vec![(specifier.clone(), MediaType::TypeScript)],
     };
-    exec(request)
+    exec_with_pool(maybe_pool, request)
   }
 
   #[test]
@@ -954,6 +1075,22 @@ mod tests {
     assert_eq!(actual.stats.0.len(), 12);
   }
 
+  #[tokio::test]
+  async fn test_exec_compiler_pool() {
+    let pool = CompilerPool::default();
+    let specifier = resolve_url_or_path("https://deno.land/x/a.ts").unwrap();
+    for _ in 0..2 {
+      let actual = test_exec_with_pool(&specifier, Some(&pool))
+        .await
+        .expect("exec should not have errored");
+      assert!(actual.diagnostics.is_empty());
+      assert!(actual.maybe_tsbuildinfo.is_some());
+      assert_eq!(actual.stats.0.len(), 12);
+    }
+    // The runtime was returned to the pool and reused.
+    assert_eq!(pool.0.lock().len(), 1);
+  }
+
   #[tokio::test]
   async fn test_exec_reexport_dts() {
     let specifier = resolve_url_or_path("file:///reexports.ts").unwrap();
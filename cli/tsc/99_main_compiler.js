@@ -75,6 +75,34 @@ delete Object.prototype.__proto__;
   /** @type {Map<string, ts.SourceFile>} */
   const sourceFileCache = new Map();
 
+  /** Source files that were loaded by the previous `exec()` request on this
+   * runtime, which can be reused if their contents haven't changed.
+   * @type {Map<string, ts.SourceFile>} */
+  let previousSourceFiles = new Map();
+
+  /** The compiler options that a parsed source file depends on. Source files
+   * are only reused by a request that has the same values for all of them. */
+  const SOURCE_FILE_AFFECTING_OPTIONS = [
+    "alwaysStrict",
+    "isolatedModules",
+    "jsx",
+    "module",
+    "preserveConstEnums",
+    "strict",
+    "target",
+  ];
+
+  /** The `SOURCE_FILE_AFFECTING_OPTIONS` of the previous `exec()` request.
+   * @type {string | null} */
+  let previousSourceFileOptions = null;
+
+  /** @param {ts.CompilerOptions} options */
+  function getSourceFileOptions(options) {
+    return JSON.stringify(
+      SOURCE_FILE_AFFECTING_OPTIONS.map((name) => options[name] ?? null),
+    );
+  }
+
   /** @type {Map<string, string>} */
   const scriptVersionCache = new Map();
 
@@ -290,6 +318,15 @@ delete Object.prototype.__proto__;
         data != null,
         `"data" is unexpectedly null for "${specifier}".`,
       );
+      const previousSourceFile = previousSourceFiles.get(specifier);
+      if (
+        hash != null && previousSourceFile?.version === hash &&
+        previousSourceFile.languageVersion === languageVersion
+      ) {
+        debug(`  reusing source file from previous request`);
+        sourceFileCache.set(specifier, previousSourceFile);
+        return previousSourceFile;
+      }
       sourceFile = ts.createSourceFile(
         specifier,
         data,
@@ -486,11 +523,27 @@ delete Object.prototype.__proto__;
     }
   }
 
+  /** The runtime is reused by Rust for subsequent requests, so anything that
+   * was loaded for a previous request has to be forgotten. The lib files that
+   * are loaded from assets never change and are kept in the cache, other
+   * source files are set aside to be reused if their hash is the same. */
+  function resetState() {
+    normalizedToOriginalMap.clear();
+    previousSourceFiles = new Map();
+    for (const [specifier, sourceFile] of sourceFileCache) {
+      if (!specifier.startsWith(ASSETS)) {
+        previousSourceFiles.set(specifier, sourceFile);
+        sourceFileCache.delete(specifier);
+      }
+    }
+  }
+
   /** The API that is called by Rust when executing a request.
    * @param {Request} request
    */
   function exec({ config, debug: debugFlag, rootNames }) {
     setLogDebug(debugFlag, "TS");
+    resetState();
     performanceStart();
     debug(">>> exec start", { rootNames });
     debug(config);
@@ -504,6 +557,11 @@ delete Object.prototype.__proto__;
     // URLs which Deno supports. So we need to either ignore the diagnostic, or
     // inject it ourselves.
     Object.assign(options, { allowNonTsExtensions: true });
+    const sourceFileOptions = getSourceFileOptions(options);
+    if (sourceFileOptions !== previousSourceFileOptions) {
+      previousSourceFiles = new Map();
+      previousSourceFileOptions = sourceFileOptions;
+    }
     const program = ts.createIncrementalProgram({
       rootNames,
       options,
@@ -527,6 +585,7 @@ delete Object.prototype.__proto__;
       diagnostics: fromTypeScriptDiagnostic(diagnostics),
       stats: performanceEnd(),
     });
+    previousSourceFiles = new Map();
     debug("<<< exec stop");
   }
 
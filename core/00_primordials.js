@@ -185,6 +185,7 @@
 
   // Create copies of the namespace objects
   [
+    "Atomics",
     "JSON",
     "Math",
     "Proxy",
@@ -221,6 +222,7 @@
     "ReferenceError",
     "RegExp",
     "Set",
+    "SharedArrayBuffer",
     "String",
     "Symbol",
     "SyntaxError",
@@ -12,6 +12,7 @@
     Map,
     Array,
     ArrayPrototypeFill,
+    Float64Array,
     Promise,
     ObjectFreeze,
     ObjectFromEntries,
@@ -23,7 +24,7 @@
   } = window.__bootstrap.primordials;
 
   // Available on start due to bindings.
-  const { opcall } = window.Deno.core;
+  const { opcall, loadExtension: loadExtensionBinding } = window.Deno.core;
 
   let opsCache = {};
   const errorMap = {};
@@ -79,6 +80,18 @@
     return promise;
   }
 
+  // Async op completions are written by Rust into this buffer, in the order
+  // they completed: slot 0 holds the number of completions, followed by
+  // `[promiseId, kind, value]` triples. A completion whose result isn't a
+  // scalar has kind ASYNC_OP_KIND_ARG, and its promise id and result are the
+  // next pair of arguments to handleAsyncMsgFromRust. Completions that don't
+  // fit in the buffer come after it, as more pairs of arguments.
+  const ASYNC_OP_BATCH_SIZE = 1024;
+  const ASYNC_OP_KIND_NULL = 0;
+  const ASYNC_OP_KIND_BOOL = 1;
+  const ASYNC_OP_KIND_ARG = 3;
+  const asyncOpBatch = new Float64Array(1 + 3 * ASYNC_OP_BATCH_SIZE);
+
   function ops() {
     return opsCache;
   }
@@ -88,12 +101,41 @@
     opsCache = ObjectFreeze(ObjectFromEntries(opcall(0)));
   }
 
+  function loadExtension(name) {
+    let loaded;
+    try {
+      loaded = loadExtensionBinding(name);
+    } finally {
+      // The extension registers its ops before its JS is evaluated, so they
+      // have to be synced even if that throws.
+      if (loaded !== false) {
+        syncOpsCache();
+      }
+    }
+    return loaded;
+  }
+
   function handleAsyncMsgFromRust() {
-    for (let i = 0; i < arguments.length; i += 2) {
-      const promiseId = arguments[i];
-      const res = arguments[i + 1];
-      const promise = getPromise(promiseId);
-      promise.resolve(res);
+    const count = asyncOpBatch[0];
+    asyncOpBatch[0] = 0;
+    let arg = 0;
+    for (let i = 1; i < 1 + 3 * count; i += 3) {
+      const kind = asyncOpBatch[i + 1];
+      if (kind === ASYNC_OP_KIND_ARG) {
+        getPromise(arguments[arg]).resolve(arguments[arg + 1]);
+        arg += 2;
+        continue;
+      }
+      const value = asyncOpBatch[i + 2];
+      const res = kind === ASYNC_OP_KIND_NULL
+        ? null
+        : kind === ASYNC_OP_KIND_BOOL
+        ? value !== 0
+        : value;
+      getPromise(asyncOpBatch[i]).resolve(res);
+    }
+    for (; arg < arguments.length; arg += 2) {
+      getPromise(arguments[arg]).resolve(arguments[arg + 1]);
     }
   }
 
@@ -180,7 +222,9 @@
     registerErrorBuilder,
     registerErrorClass,
     handleAsyncMsgFromRust,
+    asyncOpBatch,
     syncOpsCache,
+    loadExtension,
     BadResource,
     Interrupted,
   });
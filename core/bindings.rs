@@ -1,6 +1,7 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
 use crate::error::AnyError;
+use crate::extensions::LazyExtension;
 use crate::modules::ModuleMap;
 use crate::resolve_url_or_path;
 use crate::JsRuntime;
@@ -10,6 +11,8 @@ use crate::OpPayload;
 use crate::OpTable;
 use crate::PromiseId;
 use crate::ResourceId;
+use crate::SerializedValue;
+use crate::SharedArrayBufferStore;
 use crate::ZeroCopyBuf;
 use log::debug;
 use rusty_v8 as v8;
@@ -39,6 +42,9 @@ lazy_static::lazy_static! {
       v8::ExternalReference {
         function: eval_context.map_fn_to()
       },
+      v8::ExternalReference {
+        function: load_extension.map_fn_to()
+      },
       v8::ExternalReference {
         function: queue_microtask.map_fn_to()
       },
@@ -48,6 +54,9 @@ lazy_static::lazy_static! {
       v8::ExternalReference {
         function: encode.map_fn_to()
       },
+      v8::ExternalReference {
+        function: encode_into.map_fn_to()
+      },
       v8::ExternalReference {
         function: decode.map_fn_to()
       },
@@ -143,7 +152,9 @@ pub fn initialize_context<'s>(
     set_macrotask_callback,
   );
   set_func(scope, core_val, "evalContext", eval_context);
+  set_func(scope, core_val, "loadExtension", load_extension);
   set_func(scope, core_val, "encode", encode);
+  set_func(scope, core_val, "encodeInto", encode_into);
   set_func(scope, core_val, "decode", decode);
   set_func(scope, core_val, "serialize", serialize);
   set_func(scope, core_val, "deserialize", deserialize);
@@ -485,6 +496,75 @@ fn eval_context(
   rv.set(to_v8(tc_scope, output).unwrap());
 }
 
+/// Registers the ops of the lazy extension with the given name and evaluates
+/// its JS. Returns false if there is no such extension or it has already been
+/// loaded. Exceptions thrown by the JS of the extension are rethrown.
+///
+/// If one of its JS files fails, the extension is put back with that file and
+/// the ones after it, and without its ops, which stay registered. Loading it
+/// again picks up where the failed load stopped.
+fn load_extension(
+  scope: &mut v8::HandleScope,
+  args: v8::FunctionCallbackArguments,
+  mut rv: v8::ReturnValue,
+) {
+  let name = match v8::Local::<v8::String>::try_from(args.get(0)) {
+    Ok(s) => s.to_rust_string_lossy(scope),
+    Err(_) => {
+      throw_type_error(scope, "Invalid extension name");
+      return;
+    }
+  };
+
+  let state_rc = JsRuntime::state(scope);
+  let maybe_extension =
+    state_rc.borrow_mut().lazy_extensions.remove_entry(&*name);
+  let (name, extension) = match maybe_extension {
+    Some(entry) => entry,
+    None => {
+      rv.set(v8::Boolean::new(scope, false).into());
+      return;
+    }
+  };
+
+  let op_state = state_rc.borrow().op_state.clone();
+  for (name, opfn) in extension.ops {
+    op_state.borrow_mut().op_table.register_op(name, opfn);
+  }
+
+  let mut js_files = extension.js_files.into_iter();
+  while let Some((filename, source)) = js_files.next() {
+    let ok = match source() {
+      Ok(source) => {
+        let source = v8::String::new(scope, &source).unwrap();
+        let script_name = v8::String::new(scope, filename).unwrap();
+        let origin = script_origin(scope, script_name);
+        v8::Script::compile(scope, source, Some(&origin))
+          .and_then(|script| script.run(scope))
+          .is_some()
+      }
+      Err(err) => {
+        throw_type_error(scope, err.to_string());
+        false
+      }
+    };
+    if !ok {
+      let js_files = std::iter::once((filename, source)).chain(js_files);
+      let extension = LazyExtension {
+        js_files: js_files.collect(),
+        ops: vec![],
+      };
+      state_rc
+        .borrow_mut()
+        .lazy_extensions
+        .insert(name, extension);
+      return;
+    }
+  }
+
+  rv.set(v8::Boolean::new(scope, true).into());
+}
+
 /// This binding should be used if there's a custom console implementation
 /// available. Using it will make sure that proper stack frames are displayed
 /// in the inspector console.
@@ -654,12 +734,72 @@ fn encode(
       return;
     }
   };
-  let text_str = text.to_rust_string_lossy(scope);
-  let zbuf: ZeroCopyBuf = text_str.into_bytes().into();
+  // Write straight into the buffer that is handed over to V8, instead of
+  // going through an intermediate Rust `String`. A string whose UTF-8 length
+  // equals its length is all ASCII, and its one-byte form is already UTF-8.
+  let len = text.utf8_length(scope);
+  let mut buf = vec![0; len];
+  if len == text.length() {
+    text.write_one_byte(
+      scope,
+      &mut buf,
+      0,
+      v8::WriteOptions::NO_NULL_TERMINATION,
+    );
+  } else {
+    text.write_utf8(
+      scope,
+      &mut buf,
+      None,
+      v8::WriteOptions::NO_NULL_TERMINATION
+        | v8::WriteOptions::REPLACE_INVALID_UTF8,
+    );
+  }
+  let zbuf: ZeroCopyBuf = buf.into();
 
   rv.set(to_v8(scope, zbuf).unwrap())
 }
 
+#[derive(Serialize)]
+struct EncodeIntoResult {
+  read: usize,
+  written: usize,
+}
+
+fn encode_into(
+  scope: &mut v8::HandleScope,
+  args: v8::FunctionCallbackArguments,
+  mut rv: v8::ReturnValue,
+) {
+  let text = match v8::Local::<v8::String>::try_from(args.get(0)) {
+    Ok(s) => s,
+    Err(_) => {
+      throw_type_error(scope, "Invalid argument");
+      return;
+    }
+  };
+  let mut dest: ZeroCopyBuf = match serde_v8::from_v8(scope, args.get(1)) {
+    Ok(zbuf) => zbuf,
+    Err(_) => {
+      throw_type_error(scope, "Invalid argument");
+      return;
+    }
+  };
+
+  // `write_utf8` only writes whole code points and reports how many UTF-16
+  // code units it consumed, which is exactly what `encodeInto` returns.
+  let mut read = 0;
+  let written = text.write_utf8(
+    scope,
+    &mut dest,
+    Some(&mut read),
+    v8::WriteOptions::NO_NULL_TERMINATION
+      | v8::WriteOptions::REPLACE_INVALID_UTF8,
+  );
+
+  rv.set(to_v8(scope, EncodeIntoResult { read, written }).unwrap())
+}
+
 fn decode(
   scope: &mut v8::HandleScope,
   args: v8::FunctionCallbackArguments,
@@ -690,7 +830,14 @@ fn decode(
   // - https://encoding.spec.whatwg.org/#dom-textdecoder-decode
   // - https://github.com/denoland/deno/issues/6649
   // - https://github.com/v8/v8/blob/d68fb4733e39525f9ff0a9222107c02c28096e2a/include/v8.h#L3277-L3278
-  match v8::String::new_from_utf8(scope, &buf, v8::NewStringType::Normal) {
+  // ASCII is valid Latin-1, so V8 can copy it into a one-byte string as is
+  // and skip UTF-8 decoding. `is_ascii` checks a word at a time.
+  let text = if buf.is_ascii() {
+    v8::String::new_from_one_byte(scope, &buf, v8::NewStringType::Normal)
+  } else {
+    v8::String::new_from_utf8(scope, &buf, v8::NewStringType::Normal)
+  };
+  match text {
     Some(text) => rv.set(text.into()),
     None => {
       let msg = v8::String::new(scope, "string too long").unwrap();
@@ -702,6 +849,9 @@ fn decode(
 
 struct SerializeDeserialize<'a> {
   host_objects: Option<v8::Local<'a, v8::Array>>,
+  /// Maps each host object passed to `serialize` to its index, so looking
+  /// them up doesn't take a scan of `host_objects` per object.
+  host_object_ids: Option<v8::Local<'a, v8::Map>>,
 }
 
 impl<'a> v8::ValueSerializerImpl for SerializeDeserialize<'a> {
@@ -737,13 +887,13 @@ impl<'a> v8::ValueSerializerImpl for SerializeDeserialize<'a> {
     object: v8::Local<'s, v8::Object>,
     value_serializer: &mut dyn v8::ValueSerializerHelper,
   ) -> Option<bool> {
-    if let Some(host_objects) = self.host_objects {
-      for i in 0..host_objects.length() {
-        let value = host_objects.get_index(scope, i).unwrap();
-        if value == object {
-          value_serializer.write_uint32(i);
-          return Some(true);
-        }
+    if let Some(host_object_ids) = self.host_object_ids {
+      let id = host_object_ids
+        .get(scope, object.into())
+        .filter(|id| id.is_uint32());
+      if let Some(id) = id {
+        value_serializer.write_uint32(id.uint32_value(scope).unwrap());
+        return Some(true);
       }
     }
     let message = v8::String::new(scope, "Unsupported object type").unwrap();
@@ -810,8 +960,7 @@ fn serialize(
       }
     };
 
-  let options =
-    options.unwrap_or(SerializeDeserializeOptions { host_objects: None });
+  let options = options.unwrap_or_default();
 
   let host_objects = match options.host_objects {
     Some(value) => match v8::Local::<v8::Array>::try_from(value.v8_value) {
@@ -824,14 +973,92 @@ fn serialize(
     None => None,
   };
 
-  let serialize_deserialize = Box::new(SerializeDeserialize { host_objects });
+  let transferred = match options.transferred_array_buffers {
+    Some(value) => match transferred_array_buffers(scope, value) {
+      Some(transferred) => Some(transferred),
+      None => return,
+    },
+    None => None,
+  };
+
+  let host_object_ids = host_objects.map(|host_objects| {
+    let host_object_ids = v8::Map::new(scope);
+    // Go backwards so that an object that is listed more than once gets the
+    // index of its first occurrence.
+    for i in (0..host_objects.length()).rev() {
+      let value = host_objects.get_index(scope, i).unwrap();
+      let id = v8::Integer::new_from_unsigned(scope, i).into();
+      host_object_ids.set(scope, value, id);
+    }
+    host_object_ids
+  });
+
+  let serialize_deserialize = Box::new(SerializeDeserialize {
+    host_objects,
+    host_object_ids,
+  });
   let mut value_serializer =
     v8::ValueSerializer::new(scope, serialize_deserialize);
+
+  let mut array_buffers = Vec::new();
+  if let Some((ref list, _)) = transferred {
+    for i in 0..list.length() {
+      let value = list.get_index(scope, i).unwrap();
+      match v8::Local::<v8::ArrayBuffer>::try_from(value) {
+        // Detaching it would silently do nothing, and the backing store
+        // would end up shared with the receiving side.
+        Ok(array_buffer) if !array_buffer.is_detachable() => {
+          throw_type_error(scope, "ArrayBuffer is not detachable");
+          return;
+        }
+        Ok(array_buffer) => {
+          v8::ValueSerializerHelper::transfer_array_buffer(
+            &mut value_serializer,
+            i,
+            array_buffer,
+          );
+          array_buffers.push(array_buffer);
+        }
+        Err(_) => {
+          throw_type_error(scope, "Transferred value is not an ArrayBuffer");
+          return;
+        }
+      }
+    }
+  }
+
   match value_serializer.write_value(scope.get_current_context(), value) {
     Some(true) => {
+      // Transferred ArrayBuffers are only written as an index into the
+      // transfer list. Their backing stores are handed over through the
+      // `SharedArrayBufferStore` without being copied, and replaced by their
+      // ids in the transfer list.
+      let mut ids = Vec::with_capacity(array_buffers.len());
+      let mut maybe_store = None;
+      if let Some((list, store)) = transferred {
+        for (i, array_buffer) in array_buffers.into_iter().enumerate() {
+          let backing_store = array_buffer.get_backing_store();
+          array_buffer.detach();
+          let id = store.insert(backing_store);
+          ids.push(id);
+          let id = v8::Integer::new_from_unsigned(scope, id).into();
+          list.set_index(scope, i as u32, id);
+        }
+        maybe_store = Some(store);
+      }
       let vector = value_serializer.release();
-      let zbuf: ZeroCopyBuf = vector.into();
-      rv.set(to_v8(scope, zbuf).unwrap());
+      if options.into_resource {
+        // The backing stores belong to the `SerializedValue` until they are
+        // deserialized, so they are dropped with it if that never happens.
+        let value = SerializedValue::new(vector, ids, maybe_store);
+        let state_rc = JsRuntime::state(scope);
+        let op_state = state_rc.borrow().op_state.clone();
+        let rid = op_state.borrow_mut().resource_table.add(value);
+        rv.set(v8::Integer::new_from_unsigned(scope, rid).into());
+      } else {
+        let zbuf: ZeroCopyBuf = vector.into();
+        rv.set(to_v8(scope, zbuf).unwrap());
+      }
     }
     _ => {
       throw_type_error(scope, "Failed to serialize response");
@@ -839,10 +1066,42 @@ fn serialize(
   }
 }
 
-#[derive(Serialize, Deserialize)]
+/// Returns the list of transferred ArrayBuffers passed to `serialize` or
+/// `deserialize`, along with the store their backing stores go through.
+/// Throws if it is not an array, or if it isn't empty and the runtime has no
+/// store.
+fn transferred_array_buffers<'s>(
+  scope: &mut v8::HandleScope<'s>,
+  value: serde_v8::Value<'s>,
+) -> Option<(v8::Local<'s, v8::Array>, SharedArrayBufferStore)> {
+  let list = match v8::Local::<v8::Array>::try_from(value.v8_value) {
+    Ok(list) => list,
+    Err(_) => {
+      throw_type_error(scope, "transferred_array_buffers not an array");
+      return None;
+    }
+  };
+  let state_rc = JsRuntime::state(scope);
+  let maybe_store = state_rc.borrow().shared_array_buffer_store.clone();
+  match maybe_store {
+    Some(store) => Some((list, store)),
+    // Nothing goes through the store.
+    None if list.length() == 0 => Some((list, Default::default())),
+    None => {
+      throw_type_error(scope, "Transferring ArrayBuffers is not supported");
+      None
+    }
+  }
+}
+
+#[derive(Default, Serialize, Deserialize)]
 #[serde(rename_all = "camelCase")]
 struct SerializeDeserializeOptions<'a> {
   host_objects: Option<serde_v8::Value<'a>>,
+  transferred_array_buffers: Option<serde_v8::Value<'a>>,
+  /// Only used by `serialize`.
+  #[serde(default)]
+  into_resource: bool,
 }
 
 fn deserialize(
@@ -850,12 +1109,33 @@ fn deserialize(
   args: v8::FunctionCallbackArguments,
   mut rv: v8::ReturnValue,
 ) {
-  let zero_copy: ZeroCopyBuf = match serde_v8::from_v8(scope, args.get(0)) {
-    Ok(zbuf) => zbuf,
-    Err(_) => {
-      throw_type_error(scope, "Invalid argument 1");
-      return;
-    }
+  // The serialized value is either a buffer or the id of a `SerializedValue`.
+  // The latter is dropped when this returns, together with any of its
+  // transferred ArrayBuffers that were not deserialized.
+  let owned: SerializedValue;
+  let zero_copy: ZeroCopyBuf;
+  let data: &[u8] = if args.get(0).is_number() {
+    let rid = args.get(0).uint32_value(scope).unwrap();
+    let state_rc = JsRuntime::state(scope);
+    let op_state = state_rc.borrow().op_state.clone();
+    let result = SerializedValue::take(&mut op_state.borrow_mut(), rid);
+    owned = match result {
+      Ok(value) => value,
+      Err(_) => {
+        throw_type_error(scope, "Invalid argument 1");
+        return;
+      }
+    };
+    owned.bytes()
+  } else {
+    zero_copy = match serde_v8::from_v8(scope, args.get(0)) {
+      Ok(zbuf) => zbuf,
+      Err(_) => {
+        throw_type_error(scope, "Invalid argument 1");
+        return;
+      }
+    };
+    &zero_copy
   };
 
   let options: Option<SerializeDeserializeOptions> =
@@ -867,8 +1147,7 @@ fn deserialize(
       }
     };
 
-  let options =
-    options.unwrap_or(SerializeDeserializeOptions { host_objects: None });
+  let options = options.unwrap_or_default();
 
   let host_objects = match options.host_objects {
     Some(value) => match v8::Local::<v8::Array>::try_from(value.v8_value) {
@@ -881,9 +1160,43 @@ fn deserialize(
     None => None,
   };
 
-  let serialize_deserialize = Box::new(SerializeDeserialize { host_objects });
+  let transferred = match options.transferred_array_buffers {
+    Some(value) => match transferred_array_buffers(scope, value) {
+      Some(transferred) => Some(transferred),
+      None => return,
+    },
+    None => None,
+  };
+
+  let serialize_deserialize = Box::new(SerializeDeserialize {
+    host_objects,
+    host_object_ids: None,
+  });
   let mut value_deserializer =
-    v8::ValueDeserializer::new(scope, serialize_deserialize, &zero_copy);
+    v8::ValueDeserializer::new(scope, serialize_deserialize, data);
+
+  if let Some((list, store)) = transferred {
+    for i in 0..list.length() {
+      let id = list.get_index(scope, i).unwrap();
+      let maybe_backing_store =
+        id.uint32_value(scope).and_then(|id| store.take(id));
+      let backing_store = match maybe_backing_store {
+        Some(backing_store) => backing_store,
+        None => {
+          throw_type_error(scope, "Invalid ArrayBuffer transfer");
+          return;
+        }
+      };
+      let array_buffer =
+        v8::ArrayBuffer::with_backing_store(scope, &backing_store);
+      v8::ValueDeserializerHelper::transfer_array_buffer(
+        &mut value_deserializer,
+        i,
+        array_buffer,
+      );
+    }
+  }
+
   let value = value_deserializer.read_value(scope.get_current_context());
 
   match value {
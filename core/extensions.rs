@@ -13,9 +13,16 @@ pub struct Extension {
   ops: Option<Vec<OpPair>>,
   opstate_fn: Option<Box<OpStateFn>>,
   middleware_fn: Option<Box<OpMiddlewareFn>>,
+  lazy_name: Option<&'static str>,
   initialized: bool,
 }
 
+/// The JS and ops of a lazy extension that haven't been loaded yet.
+pub(crate) struct LazyExtension {
+  pub js_files: Vec<SourcePair>,
+  pub ops: Vec<OpPair>,
+}
+
 // Note: this used to be a trait, but we "downgraded" it to a single concrete type
 // for the initial iteration, it will likely become a trait in the future
 impl Extension {
@@ -32,6 +39,16 @@ impl Extension {
     }
   }
 
+  /// Returns the name of the extension if it is lazy, see
+  /// `ExtensionBuilder::lazy`.
+  pub fn lazy_name(&self) -> Option<&'static str> {
+    self.lazy_name
+  }
+
+  pub(crate) fn take_js(&mut self) -> Vec<SourcePair> {
+    self.js_files.take().unwrap_or_default()
+  }
+
   /// Called at JsRuntime startup to initialize ops in the isolate.
   pub fn init_ops(&mut self) -> Option<Vec<OpPair>> {
     // TODO(@AaronO): maybe make op registration idempotent
@@ -64,6 +81,7 @@ pub struct ExtensionBuilder {
   ops: Vec<OpPair>,
   state: Option<Box<OpStateFn>>,
   middleware: Option<Box<OpMiddlewareFn>>,
+  lazy_name: Option<&'static str>,
 }
 
 impl ExtensionBuilder {
@@ -93,6 +111,16 @@ impl ExtensionBuilder {
     self
   }
 
+  /// Makes the extension lazy: its JS is neither evaluated at startup nor
+  /// included in snapshots, and its ops are not registered, until JS calls
+  /// `Deno.core.loadExtension(name)`. Its state is still initialized at
+  /// startup. As the JS of a lazy extension is loaded at runtime, it has to be
+  /// embedded with `include_js_files!(embed ...)`.
+  pub fn lazy(&mut self, name: &'static str) -> &mut Self {
+    self.lazy_name = Some(name);
+    self
+  }
+
   pub fn build(&mut self) -> Extension {
     let js_files = Some(std::mem::take(&mut self.js));
     let ops = Some(std::mem::take(&mut self.ops));
@@ -101,6 +129,7 @@ impl ExtensionBuilder {
       ops,
       opstate_fn: self.state.take(),
       middleware_fn: self.middleware.take(),
+      lazy_name: self.lazy_name.take(),
       initialized: false,
     }
   }
@@ -109,6 +138,9 @@ impl ExtensionBuilder {
 /// representing the filename and source code. This is only meant for extensions
 /// that will be snapshotted, as code will be loaded at runtime.
 ///
+/// With `embed`, the source code is included in the binary instead, which is
+/// needed for lazy extensions.
+///
 /// Example:
 /// ```ignore
 /// include_js_files!(
@@ -119,6 +151,16 @@ impl ExtensionBuilder {
 /// ```
 #[macro_export]
 macro_rules! include_js_files {
+  (embed prefix $prefix:literal, $($file:literal,)+) => {
+    vec![
+      $((
+        concat!($prefix, "/", $file),
+        Box::new(|| {
+          Ok(include_str!(concat!(env!("CARGO_MANIFEST_DIR"), "/", $file)).to_string())
+        }),
+      ),)+
+    ]
+  };
   (prefix $prefix:literal, $($file:literal,)+) => {
     vec![
       $((
@@ -73,6 +73,12 @@ declare namespace __bootstrap {
     export const decodeURIComponent: typeof globalThis.decodeURIComponent;
     export const encodeURI: typeof globalThis.encodeURI;
     export const encodeURIComponent: typeof globalThis.encodeURIComponent;
+    export const AtomicsAdd: typeof Atomics.add;
+    export const AtomicsCompareExchange: typeof Atomics.compareExchange;
+    export const AtomicsLoad: typeof Atomics.load;
+    export const AtomicsNotify: typeof Atomics.notify;
+    export const AtomicsStore: typeof Atomics.store;
+    export const AtomicsWait: typeof Atomics.wait;
     export const JSONParse: typeof JSON.parse;
     export const JSONStringify: typeof JSON.stringify;
     export const MathAbs: typeof Math.abs;
@@ -665,6 +671,8 @@ declare namespace __bootstrap {
     export const SetPrototypeForEach: UncurryThis<typeof Set.prototype.forEach>;
     export const SetPrototypeValues: UncurryThis<typeof Set.prototype.values>;
     export const SetPrototypeKeys: UncurryThis<typeof Set.prototype.keys>;
+    export const SharedArrayBuffer: typeof globalThis.SharedArrayBuffer;
+    export const SharedArrayBufferPrototype: typeof SharedArrayBuffer.prototype;
     export const String: typeof globalThis.String;
     export const StringLength: typeof String.length;
     export const StringName: typeof String.name;
@@ -33,6 +33,13 @@ declare namespace Deno {
      */
     function resources(): Record<string, string>;
 
+    /**
+     * Load a lazy extension: register its ops and evaluate its JS. Returns
+     * false if there is no lazy extension with that name, or if it has already
+     * been loaded.
+     */
+    function loadExtension(name: string): boolean;
+
     /** Close the resource with the specified op id. */
     function close(rid: number): void;
 
@@ -42,6 +49,15 @@ declare namespace Deno {
     /** Encode a string to its Uint8Array representation. */
     function encode(input: string): Uint8Array;
 
+    /**
+     * Encode a string into `dest` as UTF-8, writing only whole code points.
+     * Returns the number of UTF-16 code units read and bytes written.
+     */
+    function encodeInto(
+      input: string,
+      dest: Uint8Array,
+    ): { read: number; written: number };
+
     /**
      * Set a callback that will be called when the WebAssembly streaming APIs
      * (`WebAssembly.compileStreaming` and `WebAssembly.instantiateStreaming`)
@@ -15,6 +15,7 @@ mod ops_builtin;
 mod ops_json;
 mod resources;
 mod runtime;
+mod stall_detector;
 
 // Re-exports
 pub use futures;
@@ -58,12 +59,15 @@ pub use crate::modules::ModuleLoader;
 pub use crate::modules::ModuleSource;
 pub use crate::modules::ModuleSourceFuture;
 pub use crate::modules::NoopModuleLoader;
+pub use crate::runtime::SerializedValue;
 pub use crate::runtime::SharedArrayBufferStore;
 // TODO(bartlomieju): this struct should be implementation
 // detail nad not be public
 pub use crate::modules::RecursiveModuleLoad;
 pub use crate::normalize_path::normalize_path;
 pub use crate::ops::serialize_op_result;
+pub use crate::ops::FastArg;
+pub use crate::ops::FastValue;
 pub use crate::ops::Op;
 pub use crate::ops::OpAsyncFuture;
 pub use crate::ops::OpFn;
@@ -79,9 +83,12 @@ pub use crate::ops_builtin::op_resources;
 pub use crate::ops_json::op_async;
 pub use crate::ops_json::op_async_unref;
 pub use crate::ops_json::op_sync;
+pub use crate::ops_json::op_sync_fast;
 pub use crate::resources::Resource;
 pub use crate::resources::ResourceId;
 pub use crate::resources::ResourceTable;
+pub use crate::runtime::EventLoopObserver;
+pub use crate::runtime::EventLoopTurn;
 pub use crate::runtime::GetErrorClassFn;
 pub use crate::runtime::JsErrorCreateFn;
 pub use crate::runtime::JsRuntime;
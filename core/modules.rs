@@ -107,6 +107,39 @@ pub trait ModuleLoader {
   ) -> Pin<Box<dyn Future<Output = Result<(), AnyError>>>> {
     async { Ok(()) }.boxed_local()
   }
+
+  /// Returns `true` if this loader keeps V8 code caches for the modules it
+  /// loads. When it does, `get_code_cache` is consulted before a module is
+  /// compiled and `code_cache_ready` is called once it has been evaluated.
+  ///
+  /// It's not required to implement this method.
+  fn uses_code_cache(&self) -> bool {
+    false
+  }
+
+  /// Returns a V8 code cache previously handed to `code_cache_ready` for
+  /// the module with the given source code, if there is one.
+  ///
+  /// A cache that V8 rejects (eg. because it was produced by a different
+  /// V8 version) is discarded and a fresh one is produced.
+  fn get_code_cache(
+    &self,
+    _module_specifier: &ModuleSpecifier,
+    _code: &str,
+  ) -> Option<Vec<u8>> {
+    None
+  }
+
+  /// Called with a freshly created V8 code cache for a module that was
+  /// compiled without a usable cache. The cache is created after the module
+  /// has been evaluated, so it also covers functions that were compiled
+  /// lazily during evaluation.
+  fn code_cache_ready(
+    &self,
+    _module_specifier: &ModuleSpecifier,
+    _code_cache: &[u8],
+  ) {
+  }
 }
 
 /// Placeholder structure used when creating
@@ -484,6 +517,9 @@ pub struct ModuleMap {
   info: HashMap<ModuleId, ModuleInfo>,
   by_name: HashMap<String, SymbolicModule>,
   next_module_id: ModuleId,
+  /// Modules compiled without a usable code cache, for which one should be
+  /// created once they are evaluated.
+  code_cache_pending: Vec<ModuleId>,
 
   // Handling of futures for loading module sources
   pub loader: Rc<dyn ModuleLoader>,
@@ -507,6 +543,7 @@ impl ModuleMap {
       info: HashMap::new(),
       by_name: HashMap::new(),
       next_module_id: 1,
+      code_cache_pending: vec![],
       loader,
       op_state,
       dynamic_import_map: HashMap::new(),
@@ -542,11 +579,47 @@ impl ModuleMap {
     let source_str = v8::String::new(scope, source).unwrap();
 
     let origin = bindings::module_origin(scope, name_str);
-    let source = v8::script_compiler::Source::new(source_str, Some(&origin));
+
+    let maybe_specifier = if self.loader.uses_code_cache() {
+      crate::resolve_url(name).ok()
+    } else {
+      None
+    };
+    let maybe_code_cache = maybe_specifier
+      .as_ref()
+      .and_then(|specifier| self.loader.get_code_cache(specifier, source));
 
     let tc_scope = &mut v8::TryCatch::new(scope);
 
-    let maybe_module = v8::script_compiler::compile_module(tc_scope, source);
+    let (maybe_module, code_cache_rejected) = match maybe_code_cache {
+      Some(code_cache) => {
+        let cached_data = v8::script_compiler::CachedData::new(&code_cache);
+        let mut source = v8::script_compiler::Source::new_with_cached_data(
+          source_str,
+          Some(&origin),
+          cached_data,
+        );
+        let maybe_module = v8::script_compiler::compile_module2(
+          tc_scope,
+          &mut source,
+          v8::script_compiler::CompileOptions::ConsumeCodeCache,
+          v8::script_compiler::NoCacheReason::NoReason,
+        );
+        let rejected = source
+          .get_cached_data()
+          .map(|cached_data| cached_data.rejected())
+          .unwrap_or(true);
+        if rejected {
+          debug!("V8 rejected code cache for module: {}", name);
+        }
+        (maybe_module, rejected)
+      }
+      None => {
+        let source =
+          v8::script_compiler::Source::new(source_str, Some(&origin));
+        (v8::script_compiler::compile_module(tc_scope, source), true)
+      }
+    };
 
     if tc_scope.has_caught() {
       assert!(maybe_module.is_none());
@@ -592,10 +665,50 @@ impl ModuleMap {
         import_specifiers,
       },
     );
+    if maybe_specifier.is_some() && code_cache_rejected {
+      self.code_cache_pending.push(id);
+    }
 
     Ok(id)
   }
 
+  /// Creates V8 code caches for evaluated modules that were compiled without
+  /// a usable one and hands them to the loader.
+  pub(crate) fn create_code_caches(&mut self, scope: &mut v8::HandleScope) {
+    if self.code_cache_pending.is_empty() {
+      return;
+    }
+
+    let mut still_pending = vec![];
+    for id in std::mem::take(&mut self.code_cache_pending) {
+      let module = match self.handles_by_id.get(&id) {
+        Some(handle) => v8::Local::new(scope, handle),
+        None => continue,
+      };
+      match module.get_status() {
+        v8::ModuleStatus::Evaluated => {}
+        v8::ModuleStatus::Errored => continue,
+        // Not evaluated yet, eg. part of a dynamic import that is still
+        // loading.
+        _ => {
+          still_pending.push(id);
+          continue;
+        }
+      }
+      let info = self.info.get(&id).unwrap();
+      let specifier = match crate::resolve_url(&info.name) {
+        Ok(specifier) => specifier,
+        Err(_) => continue,
+      };
+      let unbound_module_script = module.get_unbound_module_script(scope);
+      if let Some(code_cache) = unbound_module_script.create_code_cache() {
+        debug!("Created code cache for module: {}", info.name);
+        self.loader.code_cache_ready(&specifier, &code_cache);
+      }
+    }
+    self.code_cache_pending = still_pending;
+  }
+
   pub fn get_children(&self, id: ModuleId) -> Option<&Vec<ModuleSpecifier>> {
     self.info.get(&id).map(|i| &i.import_specifiers)
   }
@@ -1622,4 +1735,89 @@ mod tests {
     );
     assert_eq!(modules.get_children(d_id), Some(&vec![]));
   }
+
+  #[test]
+  fn code_cache() {
+    #[derive(Default)]
+    struct CodeCacheLoader {
+      code_caches: Arc<Mutex<HashMap<String, Vec<u8>>>>,
+      hits: Arc<AtomicUsize>,
+    }
+
+    impl ModuleLoader for CodeCacheLoader {
+      fn resolve(
+        &self,
+        _op_state: Rc<RefCell<OpState>>,
+        specifier: &str,
+        referrer: &str,
+        _is_main: bool,
+      ) -> Result<ModuleSpecifier, AnyError> {
+        Ok(crate::resolve_import(specifier, referrer)?)
+      }
+
+      fn load(
+        &self,
+        _op_state: Rc<RefCell<OpState>>,
+        specifier: &ModuleSpecifier,
+        _maybe_referrer: Option<ModuleSpecifier>,
+        _is_dyn_import: bool,
+      ) -> Pin<Box<ModuleSourceFuture>> {
+        let info = ModuleSource {
+          module_url_specified: specifier.to_string(),
+          module_url_found: specifier.to_string(),
+          code: "export function b() { return 'b' }; b();".to_owned(),
+        };
+        async move { Ok(info) }.boxed()
+      }
+
+      fn uses_code_cache(&self) -> bool {
+        true
+      }
+
+      fn get_code_cache(
+        &self,
+        specifier: &ModuleSpecifier,
+        _code: &str,
+      ) -> Option<Vec<u8>> {
+        let maybe_code_cache =
+          self.code_caches.lock().get(specifier.as_str()).cloned();
+        if maybe_code_cache.is_some() {
+          self.hits.fetch_add(1, Ordering::Relaxed);
+        }
+        maybe_code_cache
+      }
+
+      fn code_cache_ready(
+        &self,
+        specifier: &ModuleSpecifier,
+        code_cache: &[u8],
+      ) {
+        self
+          .code_caches
+          .lock()
+          .insert(specifier.to_string(), code_cache.to_vec());
+      }
+    }
+
+    let code_caches = Arc::new(Mutex::new(HashMap::new()));
+    let hits = Arc::new(AtomicUsize::new(0));
+    let spec = crate::resolve_url("file:///b.js").unwrap();
+
+    for expected_hits in 0..2 {
+      let loader = Rc::new(CodeCacheLoader {
+        code_caches: code_caches.clone(),
+        hits: hits.clone(),
+      });
+      let mut runtime = JsRuntime::new(RuntimeOptions {
+        module_loader: Some(loader),
+        ..Default::default()
+      });
+      let id = futures::executor::block_on(runtime.load_module(&spec, None))
+        .expect("Failed to load");
+      assert_eq!(hits.load(Ordering::Relaxed), expected_hits);
+      runtime.mod_evaluate(id);
+      futures::executor::block_on(runtime.run_event_loop(false)).unwrap();
+      assert!(code_caches.lock().contains_key("file:///b.js"));
+    }
+  }
 }
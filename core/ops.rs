@@ -10,7 +10,9 @@ use indexmap::IndexMap;
 use rusty_v8 as v8;
 use serde::de::DeserializeOwned;
 use serde::Serialize;
+use std::any::Any;
 use std::cell::RefCell;
+use std::convert::TryFrom;
 use std::iter::once;
 use std::ops::Deref;
 use std::ops::DerefMut;
@@ -42,6 +44,197 @@ impl<'a, 'b, 'c> OpPayload<'a, 'b, 'c> {
       .map_err(|e| type_error(format!("Error parsing args: {}", e)))?;
     Ok((a, b))
   }
+
+  /// Reads the arguments of a fast op (see `op_sync_fast`) straight from
+  /// their V8 values, without going through serde_v8.
+  pub fn deserialize_fast<T: FastArg, U: FastArg>(
+    self,
+  ) -> Result<(T, U), AnyError> {
+    let a = T::from_v8(self.scope, self.a)?;
+    let b = U::from_v8(self.scope, self.b)?;
+    Ok((a, b))
+  }
+
+  /// Returns the combined length of the arguments that are `ArrayBufferView`s.
+  pub fn byte_length(&self) -> usize {
+    [self.a, self.b]
+      .iter()
+      .filter_map(|v| v8::Local::<v8::ArrayBufferView>::try_from(*v).ok())
+      .map(|v| v.byte_length())
+      .sum()
+  }
+}
+
+/// An argument type that fast ops can read directly from a V8 value.
+///
+/// Implemented for `()`, `bool`, `u32`, `i32`, `f64`, `ZeroCopyBuf` and
+/// `Option`s of those, where `null` and `undefined` map to `None`.
+pub trait FastArg: Sized {
+  /// Errors are returned as is by `OpPayload::deserialize_fast()`, see
+  /// `fast_arg_error()`.
+  fn from_v8(
+    scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError>;
+}
+
+/// The error for a fast op argument that isn't of the `expected` type, with
+/// the same prefix as the errors of `OpPayload::deserialize()`.
+fn fast_arg_error(expected: &str) -> AnyError {
+  type_error(format!("Error parsing args: expected {}", expected))
+}
+
+impl FastArg for () {
+  fn from_v8(
+    _scope: &mut v8::HandleScope,
+    _value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    Ok(())
+  }
+}
+
+impl FastArg for bool {
+  fn from_v8(
+    _scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    if value.is_boolean() {
+      Ok(value.is_true())
+    } else {
+      Err(fast_arg_error("boolean"))
+    }
+  }
+}
+
+impl FastArg for u32 {
+  fn from_v8(
+    _scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    v8::Local::<v8::Uint32>::try_from(value)
+      .map(|v| v.value())
+      .map_err(|_| fast_arg_error("u32"))
+  }
+}
+
+impl FastArg for i32 {
+  fn from_v8(
+    _scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    v8::Local::<v8::Int32>::try_from(value)
+      .map(|v| v.value())
+      .map_err(|_| fast_arg_error("i32"))
+  }
+}
+
+impl FastArg for f64 {
+  fn from_v8(
+    _scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    v8::Local::<v8::Number>::try_from(value)
+      .map(|v| v.value())
+      .map_err(|_| fast_arg_error("number"))
+  }
+}
+
+impl FastArg for serde_v8::Buffer {
+  fn from_v8(
+    scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    v8::Local::<v8::ArrayBufferView>::try_from(value)
+      .map(|view| serde_v8::Buffer::new(scope, view))
+      .map_err(|_| fast_arg_error("ArrayBufferView"))
+  }
+}
+
+impl<T: FastArg> FastArg for Option<T> {
+  fn from_v8(
+    scope: &mut v8::HandleScope,
+    value: v8::Local<v8::Value>,
+  ) -> Result<Self, AnyError> {
+    if value.is_null_or_undefined() {
+      Ok(None)
+    } else {
+      T::from_v8(scope, value).map(Some)
+    }
+  }
+}
+
+/// The result of a fast op, converted to a V8 value without going through
+/// serde_v8. `Void` becomes `null`, just like a serialized `()`.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum FastValue {
+  Void,
+  Bool(bool),
+  U32(u32),
+  I32(i32),
+  F64(f64),
+}
+
+impl FastValue {
+  pub fn to_v8<'a>(
+    self,
+    scope: &mut v8::HandleScope<'a>,
+  ) -> v8::Local<'a, v8::Value> {
+    match self {
+      Self::Void => v8::null(scope).into(),
+      Self::Bool(v) => v8::Boolean::new(scope, v).into(),
+      Self::U32(v) => v8::Integer::new_from_unsigned(scope, v).into(),
+      Self::I32(v) => v8::Integer::new(scope, v).into(),
+      Self::F64(v) => v8::Number::new(scope, v).into(),
+    }
+  }
+
+  /// Returns the `FastValue` for op results whose type is one of the
+  /// scalar types above, so they can skip serde_v8.
+  pub fn from_any(value: &dyn Any) -> Option<Self> {
+    if value.is::<()>() {
+      Some(Self::Void)
+    } else if let Some(v) = value.downcast_ref::<bool>() {
+      Some(Self::Bool(*v))
+    } else if let Some(v) = value.downcast_ref::<u32>() {
+      Some(Self::U32(*v))
+    } else if let Some(v) = value.downcast_ref::<i32>() {
+      Some(Self::I32(*v))
+    } else if let Some(v) = value.downcast_ref::<f64>() {
+      Some(Self::F64(*v))
+    } else {
+      None
+    }
+  }
+}
+
+impl From<()> for FastValue {
+  fn from(_: ()) -> Self {
+    Self::Void
+  }
+}
+
+impl From<bool> for FastValue {
+  fn from(v: bool) -> Self {
+    Self::Bool(v)
+  }
+}
+
+impl From<u32> for FastValue {
+  fn from(v: u32) -> Self {
+    Self::U32(v)
+  }
+}
+
+impl From<i32> for FastValue {
+  fn from(v: i32) -> Self {
+    Self::I32(v)
+  }
+}
+
+impl From<f64> for FastValue {
+  fn from(v: f64) -> Self {
+    Self::F64(v)
+  }
 }
 
 pub enum Op {
@@ -55,6 +248,7 @@ pub enum Op {
 
 pub enum OpResult {
   Ok(serde_v8::SerializablePkg),
+  Fast(FastValue),
   Err(OpError),
 }
 
@@ -65,6 +259,7 @@ impl OpResult {
   ) -> Result<v8::Local<'a, v8::Value>, serde_v8::Error> {
     match self {
       Self::Ok(x) => x.to_v8(scope),
+      Self::Fast(x) => Ok(x.to_v8(scope)),
       Self::Err(err) => serde_v8::to_v8(scope, err),
     }
   }
@@ -83,7 +278,10 @@ pub fn serialize_op_result<R: Serialize + 'static>(
   state: Rc<RefCell<OpState>>,
 ) -> OpResult {
   match result {
-    Ok(v) => OpResult::Ok(v.into()),
+    Ok(v) => match FastValue::from_any(&v) {
+      Some(fast) => OpResult::Fast(fast),
+      None => OpResult::Ok(v.into()),
+    },
     Err(err) => OpResult::Err(OpError {
       class_name: (state.borrow().get_error_class_fn)(&err),
       message: err.to_string(),
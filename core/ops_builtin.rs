@@ -3,6 +3,7 @@ use crate::error::type_error;
 use crate::error::AnyError;
 use crate::include_js_files;
 use crate::op_sync;
+use crate::op_sync_fast;
 use crate::resources::ResourceId;
 use crate::Extension;
 use crate::OpState;
@@ -17,7 +18,7 @@ pub(crate) fn init_builtins() -> Extension {
       "02_error.js",
     ))
     .ops(vec![
-      ("op_close", op_sync(op_close)),
+      ("op_close", op_sync_fast(op_close)),
       ("op_print", op_sync(op_print)),
       ("op_resources", op_sync(op_resources)),
     ])
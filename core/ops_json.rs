@@ -2,8 +2,11 @@
 
 use crate::error::AnyError;
 use crate::serialize_op_result;
+use crate::FastArg;
+use crate::FastValue;
 use crate::Op;
 use crate::OpFn;
+use crate::OpResult;
 use crate::OpState;
 use serde::de::DeserializeOwned;
 use serde::Serialize;
@@ -49,6 +52,46 @@ where
   })
 }
 
+/// Creates a sync op that bypasses serde_v8 for its arguments and result.
+///
+/// This is a faster alternative to `op_sync` for hot ops whose arguments are
+/// limited to `()`, `bool`, `u32`, `i32`, `f64`, `ZeroCopyBuf` (or `Option`s
+/// of those) and whose result is one of `()`, `bool`, `u32`, `i32` or `f64`.
+/// Arguments are read directly from the V8 call arguments and the result is
+/// written directly into the call's return value. Errors are returned to
+/// JavaScript the same way as for `op_sync`.
+///
+/// When registering an op like this...
+/// ```ignore
+/// let mut runtime = JsRuntime::new(...);
+/// runtime.register_op("hello", deno_core::op_sync_fast(Self::hello_op));
+/// runtime.sync_ops_cache();
+/// ```
+///
+/// ...it can be invoked from JS like any other sync op:
+/// ```js
+/// let result = Deno.core.opSync("hello", rid, buf);
+/// ```
+pub fn op_sync_fast<F, A, B, R>(op_fn: F) -> Box<OpFn>
+where
+  F: Fn(&mut OpState, A, B) -> Result<R, AnyError> + 'static,
+  A: FastArg,
+  B: FastArg,
+  R: Into<FastValue>,
+{
+  Box::new(move |state, payload| -> Op {
+    let result = payload
+      .deserialize_fast()
+      .and_then(|(a, b)| op_fn(&mut state.borrow_mut(), a, b));
+    match result {
+      Ok(v) => Op::Sync(OpResult::Fast(v.into())),
+      Err(err) => {
+        Op::Sync(serialize_op_result(Err::<(), AnyError>(err), state))
+      }
+    }
+  })
+}
+
 /// Creates an op that passes data asynchronously using JSON.
 ///
 /// When this op is dispatched, the runtime doesn't exit while processing it.
@@ -136,6 +179,62 @@ where
 #[cfg(test)]
 mod tests {
   use super::*;
+  use crate::ZeroCopyBuf;
+
+  #[test]
+  fn op_sync_fast_args() {
+    let mut runtime = crate::JsRuntime::new(Default::default());
+
+    fn op_len(
+      _state: &mut OpState,
+      offset: u32,
+      buf: Option<ZeroCopyBuf>,
+    ) -> Result<u32, AnyError> {
+      let buf = buf.ok_or_else(|| crate::error::type_error("no buffer"))?;
+      Ok(buf.len() as u32 - offset)
+    }
+
+    runtime.register_op("op_len", op_sync_fast(op_len));
+    runtime.sync_ops_cache();
+    runtime
+      .execute_script(
+        "<init>",
+        r#"
+    if (Deno.core.opSync('op_len', 1, new Uint8Array(4)) !== 3) {
+      throw new Error("wrong result");
+    }
+    let thrown;
+    try {
+      Deno.core.opSync('op_len', "1", new Uint8Array(4));
+    } catch (e) {
+      thrown = e;
+    }
+    if (
+      !(thrown instanceof TypeError) ||
+      thrown.message !== "Error parsing args: expected u32"
+    ) {
+      throw new Error("expected TypeError");
+    }
+    try {
+      Deno.core.opSync('op_len', 1, [1, 2]);
+    } catch (e) {
+      thrown = e;
+    }
+    if (thrown.message !== "Error parsing args: expected ArrayBufferView") {
+      throw new Error("expected TypeError for the buffer");
+    }
+    try {
+      Deno.core.opSync('op_len', 1);
+    } catch (e) {
+      thrown = e;
+    }
+    if (thrown.message !== "no buffer") {
+      throw new Error("expected op error");
+    }
+    "#,
+      )
+      .unwrap();
+  }
 
   #[tokio::test]
   async fn op_async_stack_trace() {
@@ -6,11 +6,13 @@
 // resources. Resources may or may not correspond to a real operating system
 // file descriptor (hence the different name).
 
+use crate::error::generic_error;
+use crate::error::AnyError;
 use std::any::type_name;
 use std::any::Any;
 use std::any::TypeId;
 use std::borrow::Cow;
-use std::collections::BTreeMap;
+use std::collections::VecDeque;
 use std::iter::Iterator;
 use std::rc::Rc;
 
@@ -56,6 +58,30 @@ impl dyn Resource {
 // TODO: use `u64` instead?
 pub type ResourceId = u32;
 
+/// The low bits of a rid are the index of its slot in the resource table, and
+/// the high bits are the generation of the slot, which is incremented every
+/// time a resource is removed from it. A rid that outlives its resource thus
+/// doesn't refer to the next resource in the same slot. Together they take up
+/// 30 bits, so rids are small integers in V8.
+///
+/// A slot whose generation reaches `MAX_GENERATION` is retired, and new slots
+/// are used instead, so no rid is handed out twice until all of them have
+/// been. Only then do retired slots start over from generation 0.
+const INDEX_BITS: u32 = 20;
+const INDEX_MASK: ResourceId = (1 << INDEX_BITS) - 1;
+const MAX_GENERATION: ResourceId = (1 << (30 - INDEX_BITS)) - 1;
+
+struct Entry {
+  type_id: TypeId,
+  resource: Rc<dyn Resource>,
+}
+
+#[derive(Default)]
+struct Slot {
+  generation: ResourceId,
+  entry: Option<Entry>,
+}
+
 /// Map-like data structure storing Deno's resources (equivalent to file
 /// descriptors).
 ///
@@ -64,11 +90,16 @@ pub type ResourceId = u32;
 /// with a name for description.
 ///
 /// Each resource is identified through a _resource ID (rid)_, which acts as
-/// the key in the map.
+/// the key in the map. Resources are stored in a vector of slots, so looking
+/// one up is a bounds check and a comparison of its type.
 #[derive(Default)]
 pub struct ResourceTable {
-  index: BTreeMap<ResourceId, Rc<dyn Resource>>,
-  next_rid: ResourceId,
+  slots: Vec<Slot>,
+  /// Indices of empty slots, oldest first. Slots are reused in the order they
+  /// were emptied, so their generations run out as slowly as possible.
+  free: VecDeque<ResourceId>,
+  /// Indices of the empty slots whose generations have run out.
+  retired: Vec<ResourceId>,
 }
 
 impl ResourceTable {
@@ -78,6 +109,8 @@ impl ResourceTable {
   /// when retrieving it through `get()`.
   ///
   /// Returns a unique resource ID, which acts as a key for this resource.
+  ///
+  /// Panics if every rid is in use, see `try_add()`.
   pub fn add<T: Resource>(&mut self, resource: T) -> ResourceId {
     self.add_rc(Rc::new(resource))
   }
@@ -88,33 +121,94 @@ impl ResourceTable {
   /// when retrieving it through `get()`.
   ///
   /// Returns a unique resource ID, which acts as a key for this resource.
+  ///
+  /// Panics if every rid is in use, see `try_add()`.
   pub fn add_rc<T: Resource>(&mut self, resource: Rc<T>) -> ResourceId {
-    let resource = resource as Rc<dyn Resource>;
-    let rid = self.next_rid;
-    let removed_resource = self.index.insert(rid, resource);
-    assert!(removed_resource.is_none());
-    self.next_rid += 1;
-    rid
+    self.insert(resource).expect("Too many resources")
+  }
+
+  /// Like `add()`, but returns an error instead of panicking when every rid
+  /// is in use.
+  pub fn try_add<T: Resource>(
+    &mut self,
+    resource: T,
+  ) -> Result<ResourceId, AnyError> {
+    self
+      .insert(Rc::new(resource))
+      .ok_or_else(|| generic_error("Too many resources"))
+  }
+
+  fn insert<T: Resource>(&mut self, resource: Rc<T>) -> Option<ResourceId> {
+    let entry = Entry {
+      type_id: TypeId::of::<T>(),
+      resource: resource as Rc<dyn Resource>,
+    };
+    let index = match self.free.pop_front() {
+      Some(index) => index,
+      None if self.slots.len() <= INDEX_MASK as usize => {
+        self.slots.push(Slot::default());
+        (self.slots.len() - 1) as ResourceId
+      }
+      None => {
+        // Every index has been taken, so the retired slots start over.
+        for &index in &self.retired {
+          self.slots[index as usize].generation = 0;
+        }
+        self.free.extend(self.retired.drain(..));
+        self.free.pop_front()?
+      }
+    };
+    let slot = &mut self.slots[index as usize];
+    assert!(slot.entry.is_none());
+    slot.entry = Some(entry);
+    Some(slot.generation << INDEX_BITS | index)
+  }
+
+  fn entry(&self, rid: ResourceId) -> Option<&Entry> {
+    let slot = self.slots.get((rid & INDEX_MASK) as usize)?;
+    if slot.generation == rid >> INDEX_BITS {
+      slot.entry.as_ref()
+    } else {
+      None
+    }
+  }
+
+  fn remove(&mut self, rid: ResourceId) -> Option<Rc<dyn Resource>> {
+    self.entry(rid)?;
+    let index = rid & INDEX_MASK;
+    let slot = &mut self.slots[index as usize];
+    if slot.generation < MAX_GENERATION {
+      slot.generation += 1;
+      self.free.push_back(index);
+    } else {
+      // Its last rid keeps not matching until the slot starts over.
+      self.retired.push(index);
+    }
+    slot.entry.take().map(|entry| entry.resource)
   }
 
   /// Returns true if any resource with the given `rid` exists.
   pub fn has(&self, rid: ResourceId) -> bool {
-    self.index.contains_key(&rid)
+    self.entry(rid).is_some()
   }
 
   /// Returns a reference counted pointer to the resource of type `T` with the
   /// given `rid`. If `rid` is not present or has a type different than `T`,
   /// this function returns `None`.
   pub fn get<T: Resource>(&self, rid: ResourceId) -> Option<Rc<T>> {
-    self
-      .index
-      .get(&rid)
-      .and_then(|rc| rc.downcast_rc::<T>())
-      .map(Clone::clone)
+    let entry = self.entry(rid)?;
+    if entry.type_id == TypeId::of::<T>() {
+      // The type was checked above, without going through the vtable as
+      // `downcast_rc()` does.
+      let ptr = &entry.resource as *const Rc<_> as *const Rc<T>;
+      Some(unsafe { &*ptr }.clone())
+    } else {
+      None
+    }
   }
 
   pub fn get_any(&self, rid: ResourceId) -> Option<Rc<dyn Resource>> {
-    self.index.get(&rid).map(Clone::clone)
+    self.entry(rid).map(|entry| entry.resource.clone())
   }
 
   /// Removes a resource of type `T` from the resource table and returns it.
@@ -123,14 +217,14 @@ impl ResourceTable {
   /// `close()` method is *not* called.
   pub fn take<T: Resource>(&mut self, rid: ResourceId) -> Option<Rc<T>> {
     let resource = self.get::<T>(rid)?;
-    self.index.remove(&rid);
+    self.remove(rid);
     Some(resource)
   }
 
   /// Removes a resource from the resource table and returns it. Note that the
   /// resource's `close()` method is *not* called.
   pub fn take_any(&mut self, rid: ResourceId) -> Option<Rc<dyn Resource>> {
-    self.index.remove(&rid)
+    self.remove(rid)
   }
 
   /// Removes the resource with the given `rid` from the resource table. If the
@@ -140,7 +234,7 @@ impl ResourceTable {
   /// may implement the `close()` method to perform clean-ups such as canceling
   /// ops.
   pub fn close(&mut self, rid: ResourceId) -> Option<()> {
-    self.index.remove(&rid).map(|resource| resource.close())
+    self.remove(rid).map(|resource| resource.close())
   }
 
   /// Returns an iterator that yields a `(id, name)` pair for every resource
@@ -156,9 +250,86 @@ impl ResourceTable {
   /// let resource_names = resource_table.names().collect::<Vec<_>>();
   /// ```
   pub fn names(&self) -> impl Iterator<Item = (ResourceId, Cow<str>)> {
-    self
-      .index
-      .iter()
-      .map(|(&id, resource)| (id, resource.name()))
+    self.slots.iter().zip(0..).filter_map(|(slot, index)| {
+      let entry = slot.entry.as_ref()?;
+      Some((slot.generation << INDEX_BITS | index, entry.resource.name()))
+    })
+  }
+}
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+
+  struct TestResource(&'static str);
+
+  impl Resource for TestResource {
+    fn name(&self) -> Cow<str> {
+      self.0.into()
+    }
+  }
+
+  struct OtherResource;
+
+  impl Resource for OtherResource {}
+
+  #[test]
+  fn resource_table() {
+    let mut table = ResourceTable::default();
+    let a = table.add(TestResource("a"));
+    let b = table.add(TestResource("b"));
+    assert_eq!((a, b), (0, 1));
+    assert_eq!(table.get::<TestResource>(a).unwrap().0, "a");
+    assert!(table.get::<OtherResource>(a).is_none());
+    assert!(table.take::<OtherResource>(a).is_none());
+    assert!(table.has(a));
+
+    assert!(table.close(a).is_some());
+    assert!(!table.has(a));
+    assert!(table.close(a).is_none());
+    // The slot of `a` is reused, but its old rid doesn't refer to the new
+    // resource.
+    let c = table.add(OtherResource);
+    assert_eq!(c & INDEX_MASK, a);
+    assert_ne!(c, a);
+    assert!(table.get_any(a).is_none());
+    assert!(table.get::<OtherResource>(c).is_some());
+
+    let names = table.names().collect::<Vec<_>>();
+    assert_eq!(names.len(), 2);
+    assert_eq!(names[1], (b, Cow::Borrowed("b")));
+    assert!(table.take::<TestResource>(b).is_some());
+    assert!(table.get_any(b).is_none());
+    assert!(table.get_any(ResourceId::MAX).is_none());
+  }
+
+  #[test]
+  fn resource_table_retires_slots() {
+    let mut table = ResourceTable::default();
+    let a = table.add(OtherResource);
+    table.slots[a as usize].generation = MAX_GENERATION;
+    let a = MAX_GENERATION << INDEX_BITS | a;
+    // The largest rid still fits in a V8 small integer.
+    assert_eq!(a, (1 << 30) - 1 - INDEX_MASK);
+    assert!(table.has(a));
+    assert!(table.close(a).is_some());
+    // The slot is not reused, so the next resource gets a fresh one.
+    let b = table.add(OtherResource);
+    assert_eq!(b, 1);
+    assert!(table.get_any(a).is_none());
+  }
+
+  #[test]
+  fn resource_table_exhausted() {
+    let mut table = ResourceTable::default();
+    for _ in 0..=INDEX_MASK {
+      table.add(OtherResource);
+    }
+    let err = table.try_add(OtherResource).unwrap_err();
+    assert_eq!(err.to_string(), "Too many resources");
+    // A retired slot starts over once there are no other ones left.
+    table.slots[7].generation = MAX_GENERATION;
+    assert!(table.close(MAX_GENERATION << INDEX_BITS | 7).is_some());
+    assert_eq!(table.try_add(OtherResource).unwrap(), 7);
   }
 }
@@ -4,10 +4,13 @@ use rusty_v8 as v8;
 
 use crate::bindings;
 use crate::error::attach_handle_to_error;
+use crate::error::bad_resource_id;
 use crate::error::generic_error;
+use crate::error::resource_unavailable;
 use crate::error::AnyError;
 use crate::error::ErrWithV8Handle;
 use crate::error::JsError;
+use crate::extensions::LazyExtension;
 use crate::inspector::JsRuntimeInspector;
 use crate::module_specifier::ModuleSpecifier;
 use crate::modules::ModuleId;
@@ -16,12 +19,15 @@ use crate::modules::ModuleLoader;
 use crate::modules::ModuleMap;
 use crate::modules::NoopModuleLoader;
 use crate::ops::*;
+use crate::stall_detector::StallDetector;
 use crate::Extension;
 use crate::OpMiddlewareFn;
 use crate::OpPayload;
 use crate::OpResult;
 use crate::OpState;
 use crate::PromiseId;
+use crate::Resource;
+use crate::ResourceId;
 use futures::channel::mpsc;
 use futures::future::poll_fn;
 use futures::future::FutureExt;
@@ -30,6 +36,8 @@ use futures::stream::StreamExt;
 use futures::task::AtomicWaker;
 use futures::Future;
 use std::any::Any;
+use std::borrow::Cow;
+use std::cell::Cell;
 use std::cell::RefCell;
 use std::collections::HashMap;
 use std::convert::TryFrom;
@@ -43,6 +51,8 @@ use std::sync::Mutex;
 use std::sync::Once;
 use std::task::Context;
 use std::task::Poll;
+use std::time::Duration;
+use std::time::Instant;
 
 type PendingOpFuture = Pin<Box<dyn Future<Output = (PromiseId, OpResult)>>>;
 
@@ -129,11 +139,165 @@ impl SharedArrayBufferStore {
   }
 }
 
+/// The output of `Deno.core.serialize()` when it is called with the
+/// `intoResource` option. The bytes stay on the Rust side instead of being
+/// wrapped in a `Uint8Array`, so an op that is passed the resource id can take
+/// ownership of them without copying. `Deno.core.deserialize()` also accepts
+/// the id of one of these in place of a buffer, and takes it.
+///
+/// The value also owns the backing stores of the ArrayBuffers that were
+/// transferred with it. If it is dropped before they are deserialized, for
+/// example because the message it holds is never received, they are removed
+/// from the `SharedArrayBufferStore`.
+pub struct SerializedValue {
+  bytes: Vec<u8>,
+  array_buffers: Vec<u32>,
+  store: Option<SharedArrayBufferStore>,
+}
+
+impl Resource for SerializedValue {
+  fn name(&self) -> Cow<str> {
+    "serializedValue".into()
+  }
+}
+
+impl Drop for SerializedValue {
+  fn drop(&mut self) {
+    if let Some(store) = &self.store {
+      for id in &self.array_buffers {
+        store.take(*id);
+      }
+    }
+  }
+}
+
+impl SerializedValue {
+  pub(crate) fn new(
+    bytes: Vec<u8>,
+    array_buffers: Vec<u32>,
+    store: Option<SharedArrayBufferStore>,
+  ) -> Self {
+    Self {
+      bytes,
+      array_buffers,
+      store,
+    }
+  }
+
+  /// Removes the serialized value with id `rid` from the resource table and
+  /// returns it.
+  pub fn take(state: &mut OpState, rid: ResourceId) -> Result<Self, AnyError> {
+    let value = state
+      .resource_table
+      .take::<Self>(rid)
+      .ok_or_else(bad_resource_id)?;
+    Rc::try_unwrap(value).map_err(|_| resource_unavailable())
+  }
+
+  pub(crate) fn bytes(&self) -> &[u8] {
+    &self.bytes
+  }
+}
+
+/// A view of the `Float64Array` created by `core/01_core.js` as
+/// `Deno.core.asyncOpBatch`, through which a batch of async op completions is
+/// passed to `handleAsyncMsgFromRust`.
+///
+/// Slot 0 holds the number of completions in the batch, followed by
+/// `[promise_id, kind, value]` triples in completion order. Scalar results are
+/// stored in the buffer itself, so they don't need to be materialized as V8
+/// values. Other results have `KIND_ARG`, and are passed in order as pairs of
+/// arguments. JS drains the whole batch and resets the count before resolving
+/// any promise, so the buffer is always empty when Rust starts writing the
+/// next batch.
+#[derive(Clone)]
+pub(crate) struct AsyncOpBatch(v8::SharedRef<v8::BackingStore>);
+
+impl AsyncOpBatch {
+  const KIND_NULL: f64 = 0.0;
+  const KIND_BOOL: f64 = 1.0;
+  const KIND_NUMBER: f64 = 2.0;
+  const KIND_ARG: f64 = 3.0;
+
+  fn slots(&self) -> &[Cell<f64>] {
+    let bytes: &[Cell<u8>] = &self.0;
+    let ptr = bytes.as_ptr() as *const Cell<f64>;
+    assert_eq!(ptr as usize % std::mem::align_of::<f64>(), 0);
+    // SAFETY: the backing store of a Float64Array is aligned for f64 and
+    // V8 doesn't touch it while Rust holds the isolate.
+    unsafe { std::slice::from_raw_parts(ptr, bytes.len() / 8) }
+  }
+
+  fn capacity(&self) -> usize {
+    (self.slots().len() - 1) / 3
+  }
+
+  /// Writes `value` at position `index` of the batch.
+  fn set(&self, index: usize, promise_id: PromiseId, value: FastValue) {
+    let (kind, value) = match value {
+      FastValue::Void => (Self::KIND_NULL, 0.0),
+      FastValue::Bool(v) => (Self::KIND_BOOL, if v { 1.0 } else { 0.0 }),
+      FastValue::U32(v) => (Self::KIND_NUMBER, v as f64),
+      FastValue::I32(v) => (Self::KIND_NUMBER, v as f64),
+      FastValue::F64(v) => (Self::KIND_NUMBER, v),
+    };
+    self.set_slots(index, promise_id, kind, value);
+  }
+
+  /// Marks position `index` of the batch as the next pair of arguments.
+  fn set_arg(&self, index: usize, promise_id: PromiseId) {
+    self.set_slots(index, promise_id, Self::KIND_ARG, 0.0);
+  }
+
+  fn set_slots(&self, index: usize, promise_id: PromiseId, kind: f64, v: f64) {
+    let slots = &self.slots()[1 + 3 * index..];
+    slots[0].set(promise_id as f64);
+    slots[1].set(kind);
+    slots[2].set(v);
+  }
+
+  fn set_len(&self, len: usize) {
+    self.slots()[0].set(len as f64);
+  }
+}
+
+/// How long each phase of one turn of `JsRuntime::poll_event_loop()` took.
+/// `total` also covers the time between the phases.
+#[derive(Default, Debug, Clone, Copy)]
+pub struct EventLoopTurn {
+  pub v8_message_loop: Duration,
+  pub poll_ops: Duration,
+  pub op_responses: Duration,
+  pub macrotasks: Duration,
+  pub promise_exceptions: Duration,
+  pub dyn_imports: Duration,
+  pub module_evaluation: Duration,
+  pub total: Duration,
+  /// The number of async op completions delivered to JS.
+  pub ops_completed: usize,
+  /// Whether completions were left for a later turn because the op budget ran
+  /// out, see `JsRuntime::set_op_budget()`.
+  pub op_budget_exhausted: bool,
+}
+
+/// Called with the timings of every turn of the event loop that gets through
+/// all of its phases, see `JsRuntime::set_event_loop_observer()`.
+pub type EventLoopObserver = dyn FnMut(&EventLoopTurn);
+
+/// Returns the time since `start` and moves `start` to now.
+fn lap(start: &mut Instant) -> Duration {
+  let now = Instant::now();
+  let elapsed = now - *start;
+  *start = now;
+  elapsed
+}
+
 /// Internal state for JsRuntime which is stored in one of v8::Isolate's
 /// embedder slots.
 pub(crate) struct JsRuntimeState {
   pub global_context: Option<v8::Global<v8::Context>>,
   pub(crate) js_recv_cb: Option<v8::Global<v8::Function>>,
+  pub(crate) async_op_batch: Option<AsyncOpBatch>,
   pub(crate) js_macrotask_cb: Option<v8::Global<v8::Function>>,
   pub(crate) js_wasm_streaming_cb: Option<v8::Global<v8::Function>>,
   pub(crate) pending_promise_exceptions:
@@ -149,6 +313,14 @@ pub(crate) struct JsRuntimeState {
   pub(crate) have_unpolled_ops: bool,
   pub(crate) op_state: Rc<RefCell<OpState>>,
   pub(crate) shared_array_buffer_store: Option<SharedArrayBufferStore>,
+  /// Lazy extensions that haven't been loaded yet, by name.
+  pub(crate) lazy_extensions: HashMap<&'static str, LazyExtension>,
+  event_loop_observer: Option<Box<EventLoopObserver>>,
+  stall_detector: Option<StallDetector>,
+  op_budget: Option<usize>,
+  /// A completion that was polled after the op budget ran out, delivered at
+  /// the start of the next turn.
+  deferred_op_response: Option<(PromiseId, OpResult)>,
   waker: AtomicWaker,
 }
 
@@ -242,6 +414,7 @@ pub struct RuntimeOptions {
   /// If multiple isolates should have the possibility of sharing
   /// SharedArrayBuffers, they should use the same SharedArrayBufferStore. If no
   /// SharedArrayBufferStore is specified, SharedArrayBuffer can not be serialized.
+  /// The backing stores of transferred ArrayBuffers go through it as well.
   pub shared_array_buffer_store: Option<SharedArrayBufferStore>,
 }
 
@@ -328,6 +501,7 @@ impl JsRuntime {
       pending_mod_evaluate: None,
       dyn_module_evaluate_idle_counter: 0,
       js_recv_cb: None,
+      async_op_batch: None,
       js_macrotask_cb: None,
       js_wasm_streaming_cb: None,
       js_error_create_fn,
@@ -336,6 +510,11 @@ impl JsRuntime {
       shared_array_buffer_store: options.shared_array_buffer_store,
       op_state: op_state.clone(),
       have_unpolled_ops: false,
+      lazy_extensions: HashMap::new(),
+      event_loop_observer: None,
+      stall_detector: None,
+      op_budget: None,
+      deferred_op_response: None,
       waker: AtomicWaker::new(),
     })));
 
@@ -376,6 +555,32 @@ impl JsRuntime {
     state.global_context.clone().unwrap()
   }
 
+  /// Installs a callback that is passed the time spent in each phase of every
+  /// turn of the event loop.
+  pub fn set_event_loop_observer(&mut self, observer: Box<EventLoopObserver>) {
+    let state_rc = Self::state(self.v8_isolate());
+    state_rc.borrow_mut().event_loop_observer = Some(observer);
+  }
+
+  /// Prints the JS stack to stderr whenever a turn of the event loop runs for
+  /// longer than `threshold`.
+  pub fn set_stall_threshold(&mut self, threshold: Duration) {
+    let handle = self.v8_isolate().thread_safe_handle();
+    let state_rc = Self::state(self.v8_isolate());
+    state_rc.borrow_mut().stall_detector =
+      Some(StallDetector::new(handle, threshold));
+  }
+
+  /// Caps the number of async op completions that are delivered to JS in one
+  /// turn of the event loop. The rest are left for the following turns, so a
+  /// burst of completions is spread over several turns, and timers and
+  /// microtasks get to run in between.
+  pub fn set_op_budget(&mut self, budget: usize) {
+    assert!(budget > 0, "The op budget must be at least 1");
+    let state_rc = Self::state(self.v8_isolate());
+    state_rc.borrow_mut().op_budget = Some(budget);
+  }
+
   pub fn v8_isolate(&mut self) -> &mut v8::OwnedIsolate {
     self.v8_isolate.as_mut().unwrap()
   }
@@ -416,6 +621,9 @@ impl JsRuntime {
     // Take extensions to avoid double-borrow
     let mut extensions: Vec<Extension> = std::mem::take(&mut self.extensions);
     for m in extensions.iter_mut() {
+      if m.lazy_name().is_some() {
+        continue;
+      }
       let js_files = m.init_js();
       for (filename, source) in js_files {
         let source = source()?;
@@ -449,6 +657,23 @@ impl JsRuntime {
       e.init_state(&mut op_state.borrow_mut())?;
       // Register each op after middlewaring it
       let ops = e.init_ops().unwrap_or_default();
+      if let Some(name) = e.lazy_name() {
+        // Ops of lazy extensions are registered by `Deno.core.loadExtension`
+        let ops = ops
+          .into_iter()
+          .map(|(name, opfn)| (name, macroware(name, opfn)))
+          .collect();
+        let lazy_extension = LazyExtension {
+          js_files: e.take_js(),
+          ops,
+        };
+        let state_rc = Self::state(self.v8_isolate());
+        state_rc
+          .borrow_mut()
+          .lazy_extensions
+          .insert(name, lazy_extension);
+        continue;
+      }
       for (name, opfn) in ops {
         self.register_op(name, macroware(name, opfn));
       }
@@ -476,6 +701,14 @@ impl JsRuntime {
     let mut state = state_rc.borrow_mut();
     let cb = v8::Local::<v8::Function>::try_from(v8_value).unwrap();
     state.js_recv_cb.replace(v8::Global::new(scope, cb));
+
+    // Get Deno.core.asyncOpBatch
+    let code = v8::String::new(scope, "Deno.core.asyncOpBatch").unwrap();
+    let script = v8::Script::compile(scope, code, None).unwrap();
+    let v8_value = script.run(scope).unwrap();
+    let batch = v8::Local::<v8::Float64Array>::try_from(v8_value).unwrap();
+    let backing_store = batch.buffer(scope).unwrap().get_backing_store();
+    state.async_op_batch.replace(AsyncOpBatch(backing_store));
   }
 
   /// Ensures core.js has the latest op-name to op-id mappings
@@ -568,6 +801,7 @@ impl JsRuntime {
       ))));
     // Drop other v8::Global handles before snapshotting
     std::mem::take(&mut state.borrow_mut().js_recv_cb);
+    std::mem::take(&mut state.borrow_mut().async_op_batch);
 
     let snapshot_creator = self.snapshot_creator.as_mut().unwrap();
     let snapshot = snapshot_creator
@@ -675,19 +909,31 @@ impl JsRuntime {
 
     let state_rc = Self::state(self.v8_isolate());
     let module_map_rc = Self::module_map(self.v8_isolate());
-    {
+    let _turn_guard = {
       let state = state_rc.borrow();
       state.waker.register(cx.waker());
-    }
+      state.stall_detector.as_ref().map(StallDetector::start_turn)
+    };
+
+    let turn_start = Instant::now();
+    let mut phase_start = turn_start;
+    let mut turn = EventLoopTurn::default();
 
     self.pump_v8_message_loop();
+    turn.v8_message_loop = lap(&mut phase_start);
 
     // Ops
     {
-      let async_responses = self.poll_pending_ops(cx);
+      let (async_responses, op_budget_exhausted) = self.poll_pending_ops(cx);
+      turn.poll_ops = lap(&mut phase_start);
+      turn.ops_completed = async_responses.len();
+      turn.op_budget_exhausted = op_budget_exhausted;
       self.async_op_response(async_responses)?;
+      turn.op_responses = lap(&mut phase_start);
       self.drain_macrotasks()?;
+      turn.macrotasks = lap(&mut phase_start);
       self.check_promise_exceptions()?;
+      turn.promise_exceptions = lap(&mut phase_start);
     }
 
     // Dynamic module loading - ie. modules loaded using "import()"
@@ -699,17 +945,30 @@ impl JsRuntime {
       assert!(poll_imports.is_ready());
 
       self.evaluate_dyn_imports();
+      turn.dyn_imports = lap(&mut phase_start);
 
       self.check_promise_exceptions()?;
+      turn.promise_exceptions += lap(&mut phase_start);
     }
 
     // Top level module
     self.evaluate_pending_module();
+    turn.module_evaluation = lap(&mut phase_start);
+
+    turn.total = turn_start.elapsed();
+    // The observer is taken out of the state while it runs, so that it can
+    // use the runtime's `OpState`.
+    let maybe_observer = state_rc.borrow_mut().event_loop_observer.take();
+    if let Some(mut observer) = maybe_observer {
+      observer(&turn);
+      state_rc.borrow_mut().event_loop_observer = Some(observer);
+    }
 
     let mut state = state_rc.borrow_mut();
     let module_map = module_map_rc.borrow();
 
-    let has_pending_ops = !state.pending_ops.is_empty();
+    let has_pending_ops =
+      !state.pending_ops.is_empty() || state.deferred_op_response.is_some();
 
     let has_pending_dyn_imports = module_map.has_pending_dynamic_imports();
     let has_pending_dyn_module_evaluation =
@@ -1100,6 +1359,7 @@ impl JsRuntime {
     resolver.resolve(scope, module_namespace).unwrap();
     state_rc.borrow_mut().dyn_module_evaluate_idle_counter = 0;
     scope.perform_microtask_checkpoint();
+    module_map_rc.borrow_mut().create_code_caches(scope);
   }
 
   fn prepare_dyn_imports(
@@ -1226,6 +1486,7 @@ impl JsRuntime {
   /// then another turn of event loop must be performed.
   fn evaluate_pending_module(&mut self) {
     let state_rc = Self::state(self.v8_isolate());
+    let module_map_rc = Self::module_map(self.v8_isolate());
 
     let maybe_module_evaluation =
       state_rc.borrow_mut().pending_mod_evaluate.take();
@@ -1249,6 +1510,7 @@ impl JsRuntime {
       }
       v8::PromiseState::Fulfilled => {
         scope.perform_microtask_checkpoint();
+        module_map_rc.borrow_mut().create_code_caches(scope);
         // Receiver end might have been already dropped, ignore the result
         let _ = sender.try_send(Ok(()));
       }
@@ -1343,10 +1605,13 @@ impl JsRuntime {
     Ok(root_id)
   }
 
+  /// Collects the completed async ops, up to the op budget if there is one.
+  /// Ref'ed and unref'ed ops take turns, so that neither can crowd out the
+  /// other when the budget runs out. Also returns whether it did.
   fn poll_pending_ops(
     &mut self,
     cx: &mut Context,
-  ) -> Vec<(PromiseId, OpResult)> {
+  ) -> (Vec<(PromiseId, OpResult)>, bool) {
     let state_rc = Self::state(self.v8_isolate());
     let mut async_responses: Vec<(PromiseId, OpResult)> = Vec::new();
 
@@ -1355,29 +1620,63 @@ impl JsRuntime {
     // Now handle actual ops.
     state.have_unpolled_ops = false;
 
-    loop {
-      let pending_r = state.pending_ops.poll_next_unpin(cx);
-      match pending_r {
-        Poll::Ready(None) => break,
-        Poll::Pending => break,
-        Poll::Ready(Some((promise_id, resp))) => {
-          async_responses.push((promise_id, resp));
+    // A completion that was pulled past the budget in the previous turn goes
+    // first, so that completions are still delivered in the order they came in.
+    async_responses.extend(state.deferred_op_response.take());
+
+    let budget = state.op_budget.unwrap_or(usize::MAX);
+    let mut ops_done = false;
+    let mut unref_ops_done = false;
+    while !ops_done || !unref_ops_done {
+      if !ops_done {
+        match state.pending_ops.poll_next_unpin(cx) {
+          Poll::Ready(Some(response)) => {
+            if async_responses.len() >= budget {
+              return Self::defer_op_response(
+                &mut state,
+                cx,
+                async_responses,
+                response,
+              );
+            }
+            async_responses.push(response);
+          }
+          Poll::Ready(None) | Poll::Pending => ops_done = true,
         }
-      };
-    }
-
-    loop {
-      let unref_r = state.pending_unref_ops.poll_next_unpin(cx);
-      match unref_r {
-        Poll::Ready(None) => break,
-        Poll::Pending => break,
-        Poll::Ready(Some((promise_id, resp))) => {
-          async_responses.push((promise_id, resp));
+      }
+      if !unref_ops_done {
+        match state.pending_unref_ops.poll_next_unpin(cx) {
+          Poll::Ready(Some(response)) => {
+            if async_responses.len() >= budget {
+              return Self::defer_op_response(
+                &mut state,
+                cx,
+                async_responses,
+                response,
+              );
+            }
+            async_responses.push(response);
+          }
+          Poll::Ready(None) | Poll::Pending => unref_ops_done = true,
         }
-      };
+      }
     }
 
-    async_responses
+    (async_responses, false)
+  }
+
+  /// Keeps a completion that didn't fit in this turn's op budget for the next
+  /// turn. The futures that are left won't wake the event loop again for it,
+  /// so another turn is requested here.
+  fn defer_op_response(
+    state: &mut JsRuntimeState,
+    cx: &mut Context,
+    async_responses: Vec<(PromiseId, OpResult)>,
+    response: (PromiseId, OpResult),
+  ) -> (Vec<(PromiseId, OpResult)>, bool) {
+    state.deferred_op_response = Some(response);
+    cx.waker().wake_by_ref();
+    (async_responses, true)
   }
 
   fn check_promise_exceptions(&mut self) -> Result<(), AnyError> {
@@ -1411,29 +1710,48 @@ impl JsRuntime {
   ) -> Result<(), AnyError> {
     let state_rc = Self::state(self.v8_isolate());
 
-    let async_responses_size = async_responses.len();
-    if async_responses_size == 0 {
+    if async_responses.is_empty() {
       return Ok(());
     }
 
     let js_recv_cb_handle = state_rc.borrow().js_recv_cb.clone().unwrap();
+    let batch = state_rc.borrow().async_op_batch.clone().unwrap();
+    let batch_capacity = batch.capacity();
 
     let scope = &mut self.handle_scope();
 
-    // We return async responses to JS in unbounded batches (may change),
-    // each batch is a flat vector of tuples:
+    // Responses are written to the shared `AsyncOpBatch` in completion order,
+    // up to its capacity. Those whose result is a plain scalar (see
+    // `FastValue`) are stored in it, so that they don't need to be
+    // materialized as V8 values.
+    //
+    // Everything else is passed to JS as arguments, in the same order. They
+    // are a flat vector of tuples:
     // `[promise_id1, op_result1, promise_id2, op_result2, ...]`
     // promise_id is a simple integer, op_result is an ops::OpResult
     // which contains a value OR an error, encoded as a tuple.
     // This batch is received in JS via the special `arguments` variable
     // and then each tuple is used to resolve or reject promises
-    let mut args: Vec<v8::Local<v8::Value>> =
-      Vec::with_capacity(2 * async_responses_size);
-    for overflown_response in async_responses {
-      let (promise_id, resp) = overflown_response;
+    let mut batch_len = 0;
+    let mut args: Vec<v8::Local<v8::Value>> = Vec::new();
+    for (promise_id, resp) in async_responses {
+      if batch_len < batch_capacity {
+        match resp {
+          OpResult::Fast(value) => {
+            batch.set(batch_len, promise_id, value);
+            batch_len += 1;
+            continue;
+          }
+          _ => {
+            batch.set_arg(batch_len, promise_id);
+            batch_len += 1;
+          }
+        }
+      }
       args.push(v8::Integer::new(scope, promise_id as i32).into());
       args.push(resp.to_v8(scope).unwrap());
     }
+    batch.set_len(batch_len);
 
     let tc_scope = &mut v8::TryCatch::new(scope);
     let js_recv_cb = js_recv_cb_handle.get(tc_scope);
@@ -1483,6 +1801,7 @@ pub mod tests {
   use super::*;
   use crate::error::custom_error;
   use crate::modules::ModuleSourceFuture;
+  use crate::op_async;
   use crate::op_sync;
   use crate::ZeroCopyBuf;
   use futures::future::lazy;
@@ -1609,6 +1928,250 @@ pub mod tests {
     assert_eq!(dispatch_count.load(Ordering::Relaxed), 1);
   }
 
+  #[test]
+  fn test_async_op_batch() {
+    async fn op_echo_num(
+      _: Rc<RefCell<OpState>>,
+      n: u32,
+      _: (),
+    ) -> Result<u32, AnyError> {
+      Ok(n)
+    }
+
+    async fn op_echo_str(
+      _: Rc<RefCell<OpState>>,
+      n: u32,
+      _: (),
+    ) -> Result<String, AnyError> {
+      Ok(format!("n{}", n))
+    }
+
+    async fn op_is_even(
+      _: Rc<RefCell<OpState>>,
+      n: u32,
+      _: (),
+    ) -> Result<bool, AnyError> {
+      Ok(n % 2 == 0)
+    }
+
+    run_in_task(|cx| {
+      let mut runtime = JsRuntime::new(Default::default());
+      runtime.register_op("op_echo_num", op_async(op_echo_num));
+      runtime.register_op("op_echo_str", op_async(op_echo_str));
+      runtime.register_op("op_is_even", op_async(op_is_even));
+      runtime.sync_ops_cache();
+      // More scalar completions than fit in the batch, interleaved with
+      // completions that have to go through serde_v8.
+      runtime
+        .execute_script(
+          "async_op_batch.js",
+          r#"
+          (async () => {
+            const promises = [];
+            for (let i = 0; i < 3000; i++) {
+              promises.push(Deno.core.opAsync("op_echo_num", i));
+              promises.push(Deno.core.opAsync("op_echo_str", i));
+              promises.push(Deno.core.opAsync("op_is_even", i));
+            }
+            const results = await Promise.all(promises);
+            for (let i = 0; i < 3000; i++) {
+              if (
+                results[3 * i] !== i ||
+                results[3 * i + 1] !== `n${i}` ||
+                results[3 * i + 2] !== (i % 2 === 0)
+              ) {
+                throw new Error(`unexpected results for ${i}`);
+              }
+            }
+            globalThis.done = true;
+          })();
+          "#,
+        )
+        .unwrap();
+      assert!(matches!(
+        runtime.poll_event_loop(cx, false),
+        Poll::Ready(Ok(()))
+      ));
+      runtime
+        .execute_script("check.js", "if (!globalThis.done) throw Error('x')")
+        .unwrap();
+    });
+  }
+
+  #[test]
+  fn test_async_op_batch_order() {
+    struct Completions(u32);
+
+    async fn op_next_num(
+      state: Rc<RefCell<OpState>>,
+      _: (),
+      _: (),
+    ) -> Result<u32, AnyError> {
+      let mut state = state.borrow_mut();
+      let completions = state.borrow_mut::<Completions>();
+      completions.0 += 1;
+      Ok(completions.0)
+    }
+
+    async fn op_next_str(
+      state: Rc<RefCell<OpState>>,
+      _: (),
+      _: (),
+    ) -> Result<String, AnyError> {
+      op_next_num(state, (), ()).await.map(|n| n.to_string())
+    }
+
+    run_in_task(|cx| {
+      let mut runtime = JsRuntime::new(Default::default());
+      runtime.op_state().borrow_mut().put(Completions(0));
+      runtime.register_op("op_next_num", op_async(op_next_num));
+      runtime.register_op("op_next_str", op_async(op_next_str));
+      runtime.sync_ops_cache();
+      // Promises are resolved in the order their ops completed, whether their
+      // results are scalars or not, and whether they fit in the batch or not.
+      runtime
+        .execute_script(
+          "async_op_batch_order.js",
+          r#"
+          globalThis.order = [];
+          for (let i = 0; i < 3000; i++) {
+            const op = i % 3 === 0 ? "op_next_str" : "op_next_num";
+            Deno.core.opAsync(op).then((n) => order.push(Number(n)));
+          }
+          "#,
+        )
+        .unwrap();
+      assert!(matches!(
+        runtime.poll_event_loop(cx, false),
+        Poll::Ready(Ok(()))
+      ));
+      runtime
+        .execute_script(
+          "check.js",
+          r#"
+          if (order.length !== 3000 || order.some((n, i) => n !== i + 1)) {
+            throw Error("out of order");
+          }
+          "#,
+        )
+        .unwrap();
+    });
+  }
+
+  #[test]
+  fn test_op_budget() {
+    async fn op_echo_num(
+      _: Rc<RefCell<OpState>>,
+      n: u32,
+      _: (),
+    ) -> Result<u32, AnyError> {
+      Ok(n)
+    }
+
+    run_in_task(|cx| {
+      let mut runtime = JsRuntime::new(Default::default());
+      runtime.register_op("op_echo_num", op_async(op_echo_num));
+      runtime.sync_ops_cache();
+      runtime.set_op_budget(4);
+      let turns = Rc::new(RefCell::new(vec![]));
+      let turns_ = turns.clone();
+      runtime.set_event_loop_observer(Box::new(move |turn| {
+        turns_.borrow_mut().push(*turn);
+      }));
+      runtime
+        .execute_script(
+          "op_budget.js",
+          r#"
+          globalThis.resolved = 0;
+          for (let i = 0; i < 10; i++) {
+            Deno.core.opAsync("op_echo_num", i).then(() => resolved++);
+          }
+          "#,
+        )
+        .unwrap();
+
+      // 10 completions with a budget of 4 take three turns.
+      for expected in &[4, 8] {
+        assert!(runtime.poll_event_loop(cx, false).is_pending());
+        runtime
+          .execute_script(
+            "check.js",
+            &format!("if (resolved !== {}) throw Error(resolved)", expected),
+          )
+          .unwrap();
+      }
+      assert!(matches!(
+        runtime.poll_event_loop(cx, false),
+        Poll::Ready(Ok(()))
+      ));
+      runtime
+        .execute_script("check.js", "if (resolved !== 10) throw Error()")
+        .unwrap();
+
+      let turns = turns.borrow();
+      let ops_completed: Vec<usize> =
+        turns.iter().map(|turn| turn.ops_completed).collect();
+      assert_eq!(ops_completed, vec![4, 4, 2]);
+      let exhausted: Vec<bool> =
+        turns.iter().map(|turn| turn.op_budget_exhausted).collect();
+      assert_eq!(exhausted, vec![true, true, false]);
+    });
+  }
+
+  #[test]
+  fn test_op_budget_exact() {
+    async fn op_echo_num(
+      _: Rc<RefCell<OpState>>,
+      n: u32,
+      _: (),
+    ) -> Result<u32, AnyError> {
+      Ok(n)
+    }
+
+    run_in_task(|cx| {
+      let mut runtime = JsRuntime::new(Default::default());
+      runtime.register_op("op_echo_num", op_async(op_echo_num));
+      runtime.sync_ops_cache();
+      runtime.set_op_budget(4);
+      let turns = Rc::new(RefCell::new(vec![]));
+      let turns_ = turns.clone();
+      runtime.set_event_loop_observer(Box::new(move |turn| {
+        turns_.borrow_mut().push(*turn);
+      }));
+      runtime
+        .execute_script(
+          "op_budget.js",
+          r#"
+          globalThis.resolved = 0;
+          for (let i = 0; i < 8; i++) {
+            Deno.core.opAsync("op_echo_num", i).then(() => resolved++);
+          }
+          "#,
+        )
+        .unwrap();
+
+      // The budget only runs out in the first turn, where a fifth completion
+      // is pulled and kept for the next one. The second turn delivers exactly
+      // the budget without finding anything more, so it needs no third turn.
+      assert!(runtime.poll_event_loop(cx, false).is_pending());
+      assert!(matches!(
+        runtime.poll_event_loop(cx, false),
+        Poll::Ready(Ok(()))
+      ));
+      runtime
+        .execute_script("check.js", "if (resolved !== 8) throw Error()")
+        .unwrap();
+
+      let turns = turns.borrow();
+      let ops_completed: Vec<usize> =
+        turns.iter().map(|turn| turn.ops_completed).collect();
+      assert_eq!(ops_completed, vec![4, 4]);
+      let exhausted: Vec<bool> =
+        turns.iter().map(|turn| turn.op_budget_exhausted).collect();
+      assert_eq!(exhausted, vec![true, false]);
+    });
+  }
+
   #[test]
   fn test_execute_script_return_value() {
     let mut runtime = JsRuntime::new(Default::default());
@@ -1747,6 +2310,64 @@ pub mod tests {
     });
   }
 
+  #[test]
+  fn test_transfer_array_buffer() {
+    let mut runtime = JsRuntime::new(RuntimeOptions {
+      shared_array_buffer_store: Some(Default::default()),
+      ..Default::default()
+    });
+    runtime
+      .execute_script(
+        "transfer_array_buffer.js",
+        r#"
+        const view = new Uint8Array([1, 2, 3]);
+        const transferred = [view.buffer];
+        const data = Deno.core.serialize(view, {
+          transferredArrayBuffers: transferred,
+        });
+        if (view.buffer.byteLength !== 0) throw new Error("not detached");
+        if (typeof transferred[0] !== "number") throw new Error("no id");
+        const result = Deno.core.deserialize(data, {
+          transferredArrayBuffers: transferred,
+        });
+        if (result.join() !== "1,2,3") throw new Error(result.join());
+        "#,
+      )
+      .unwrap();
+
+    // Without a store, transferring ArrayBuffers isn't supported.
+    let mut runtime = JsRuntime::new(Default::default());
+    let result = runtime.execute_script(
+      "transfer_array_buffer.js",
+      "Deno.core.serialize(0, { transferredArrayBuffers: [new ArrayBuffer(1)] })",
+    );
+    assert!(result.is_err());
+  }
+
+  #[test]
+  fn test_transfer_array_buffer_dropped() {
+    let store = SharedArrayBufferStore::default();
+    let mut runtime = JsRuntime::new(RuntimeOptions {
+      shared_array_buffer_store: Some(store.clone()),
+      ..Default::default()
+    });
+    runtime
+      .execute_script(
+        "transfer_array_buffer_dropped.js",
+        r#"
+        const transferred = [new ArrayBuffer(8)];
+        const rid = Deno.core.serialize(0, {
+          transferredArrayBuffers: transferred,
+          intoResource: true,
+        });
+        Deno.core.close(rid);
+        "#,
+      )
+      .unwrap();
+    // Closing the serialized value dropped the backing store it owned.
+    assert!(store.0.lock().unwrap().buffers.is_empty());
+  }
+
   #[test]
   fn test_error_builder() {
     fn op_err(
@@ -1823,6 +2444,100 @@ pub mod tests {
       .unwrap();
   }
 
+  fn lazy_extension() -> Extension {
+    Extension::builder()
+      .js(vec![(
+        "lazy.js",
+        Box::new(|| {
+          Ok("globalThis.lazy = Deno.core.opSync('op_lazy');".to_string())
+        }),
+      )])
+      .ops(vec![("op_lazy", op_sync(|_, _: (), _: ()| Ok(42)))])
+      .lazy("lazy")
+      .build()
+  }
+
+  #[test]
+  fn test_lazy_extension() {
+    let snapshot = {
+      let mut runtime = JsRuntime::new(RuntimeOptions {
+        will_snapshot: true,
+        extensions: vec![lazy_extension()],
+        ..Default::default()
+      });
+      runtime
+        .execute_script(
+          "check.js",
+          "if (globalThis.lazy !== undefined) throw Error('evaluated')",
+        )
+        .unwrap();
+      let snap: &[u8] = &*runtime.snapshot();
+      Vec::from(snap).into_boxed_slice()
+    };
+
+    let mut runtime = JsRuntime::new(RuntimeOptions {
+      startup_snapshot: Some(Snapshot::Boxed(snapshot)),
+      extensions: vec![lazy_extension()],
+      ..Default::default()
+    });
+    runtime
+      .execute_script(
+        "check.js",
+        r#"
+        if (globalThis.lazy !== undefined) throw Error("evaluated");
+        if ("op_lazy" in Deno.core.ops()) throw Error("registered");
+        if (!Deno.core.loadExtension("lazy")) throw Error("not loaded");
+        if (globalThis.lazy !== 42) throw Error("not evaluated");
+        if (Deno.core.loadExtension("lazy")) throw Error("loaded twice");
+        if (Deno.core.loadExtension("other")) throw Error("loaded other");
+        "#,
+      )
+      .unwrap();
+  }
+
+  #[test]
+  fn test_lazy_extension_failed_load() {
+    let extension = Extension::builder()
+      .js(vec![(
+        "lazy.js",
+        Box::new(|| {
+          Ok(
+            r#"
+            if (globalThis.fail) throw Error("fail");
+            globalThis.lazy = Deno.core.opSync("op_lazy");
+            "#
+            .to_string(),
+          )
+        }),
+      )])
+      .ops(vec![("op_lazy", op_sync(|_, _: (), _: ()| Ok(42)))])
+      .lazy("lazy")
+      .build();
+    let mut runtime = JsRuntime::new(RuntimeOptions {
+      extensions: vec![extension],
+      ..Default::default()
+    });
+    runtime
+      .execute_script(
+        "check.js",
+        r#"
+        globalThis.fail = true;
+        let threw = false;
+        try {
+          Deno.core.loadExtension("lazy");
+        } catch {
+          threw = true;
+        }
+        if (!threw) throw Error("did not throw");
+        if (Deno.core.opSync("op_lazy") !== 42) throw Error("ops not synced");
+        globalThis.fail = false;
+        if (!Deno.core.loadExtension("lazy")) throw Error("not retried");
+        if (globalThis.lazy !== 42) throw Error("not evaluated");
+        "#,
+      )
+      .unwrap();
+  }
+
   #[test]
   fn test_heap_limits() {
     let create_params =
@@ -64,6 +64,33 @@ function main() {
     new Uint8Array(circularObjectSerialized),
   );
   assert(deserializedCircularObject.test == deserializedCircularObject);
+
+  // With `intoResource`, the serialized value is kept in a resource which
+  // `deserialize` takes.
+  const rid = Deno.core.serialize(primitiveValueArray, { intoResource: true });
+  assert(typeof rid === "number");
+  assertArrayEquals(Deno.core.deserialize(rid), primitiveValueArray);
+  let threw = false;
+  try {
+    Deno.core.deserialize(rid);
+  } catch {
+    threw = true;
+  }
+  assert(threw);
+
+  // Host objects are written as their index in `hostObjects`.
+  const hostObjects = [];
+  for (let i = 0; i < 100; i++) {
+    hostObjects.push(Deno.core.createHostObject());
+  }
+  const withHostObjects = [hostObjects[42], hostObjects[7], hostObjects[42]];
+  const deserializedHostObjects = Deno.core.deserialize(
+    Deno.core.serialize(withHostObjects, { hostObjects }),
+    { hostObjects },
+  );
+  assert(deserializedHostObjects[0] === hostObjects[42]);
+  assert(deserializedHostObjects[1] === hostObjects[7]);
+  assert(deserializedHostObjects[2] === hostObjects[42]);
 }
 
 main();
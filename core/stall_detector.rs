@@ -0,0 +1,125 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+
+use crate::JsRuntime;
+use rusty_v8 as v8;
+use std::ffi::c_void;
+use std::sync::atomic::AtomicBool;
+use std::sync::atomic::AtomicU64;
+use std::sync::atomic::Ordering;
+use std::sync::Arc;
+use std::thread;
+use std::time::Duration;
+use std::time::Instant;
+
+/// The number of JS frames printed for a stalled turn.
+const STACK_FRAME_LIMIT: usize = 20;
+
+#[derive(Default)]
+struct Shared {
+  /// Incremented when a turn of the event loop starts and when it ends, so it
+  /// is odd while a turn is running.
+  turn: AtomicU64,
+  stopped: AtomicBool,
+}
+
+/// Watches the turns of the event loop from another thread, and prints the JS
+/// stack when one of them runs for longer than a threshold, which means
+/// nothing else on the loop can make progress in the meantime.
+///
+/// The stack is printed from an isolate interrupt, so it shows what JS was
+/// running at that moment. A turn that is stuck in Rust code prints it once
+/// control returns to JS.
+pub(crate) struct StallDetector {
+  shared: Arc<Shared>,
+}
+
+/// Marks a turn of the event loop as running until it is dropped.
+pub(crate) struct TurnGuard(Arc<Shared>);
+
+impl Drop for TurnGuard {
+  fn drop(&mut self) {
+    self.0.turn.fetch_add(1, Ordering::Release);
+  }
+}
+
+impl StallDetector {
+  pub fn new(handle: v8::IsolateHandle, threshold: Duration) -> Self {
+    let shared = Arc::new(Shared::default());
+    let shared_ = shared.clone();
+    // Turns are sampled four times per threshold, so a stall is reported
+    // within 1.25 times the threshold.
+    let interval = (threshold / 4).max(Duration::from_millis(1));
+    thread::spawn(move || {
+      let mut last_turn = 0;
+      let mut last_change = Instant::now();
+      let mut reported = false;
+      while !shared_.stopped.load(Ordering::Relaxed) {
+        thread::sleep(interval);
+        let turn = shared_.turn.load(Ordering::Acquire);
+        if turn != last_turn {
+          last_turn = turn;
+          last_change = Instant::now();
+          reported = false;
+        } else if turn % 2 == 1
+          && !reported
+          && last_change.elapsed() >= threshold
+        {
+          reported = true;
+          eprintln!(
+            "Warning: a turn of the event loop has been running for more than {}ms",
+            threshold.as_millis()
+          );
+          handle.request_interrupt(print_stack, std::ptr::null_mut());
+        }
+      }
+    });
+    Self { shared }
+  }
+
+  pub fn start_turn(&self) -> TurnGuard {
+    self.shared.turn.fetch_add(1, Ordering::Release);
+    TurnGuard(self.shared.clone())
+  }
+}
+
+impl Drop for StallDetector {
+  fn drop(&mut self) {
+    self.shared.stopped.store(true, Ordering::Relaxed);
+  }
+}
+
+extern "C" fn print_stack(isolate: &mut v8::Isolate, _data: *mut c_void) {
+  let state_rc = JsRuntime::state(isolate);
+  let context = match state_rc.try_borrow() {
+    Ok(state) => state.global_context.clone().unwrap(),
+    Err(_) => return,
+  };
+  let scope = &mut v8::HandleScope::with_context(isolate, context);
+  let stack =
+    match v8::StackTrace::current_stack_trace(scope, STACK_FRAME_LIMIT) {
+      Some(stack) if stack.get_frame_count() > 0 => stack,
+      _ => {
+        eprintln!("    (no JS on the stack)");
+        return;
+      }
+    };
+  for i in 0..stack.get_frame_count() {
+    let frame = stack.get_frame(scope, i).unwrap();
+    let function_name = frame
+      .get_function_name(scope)
+      .map(|name| name.to_rust_string_lossy(scope))
+      .filter(|name| !name.is_empty())
+      .unwrap_or_else(|| "<anonymous>".to_string());
+    let script_name = frame
+      .get_script_name(scope)
+      .map(|name| name.to_rust_string_lossy(scope))
+      .unwrap_or_else(|| "<unknown>".to_string());
+    eprintln!(
+      "    at {} ({}:{}:{})",
+      function_name,
+      script_name,
+      frame.get_line_number(),
+      frame.get_column()
+    );
+  }
+}
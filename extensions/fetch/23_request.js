@@ -44,6 +44,8 @@
 
   const _request = Symbol("request");
   const _headers = Symbol("headers");
+  const _headersCache = Symbol("headers cache");
+  const _getHeaders = Symbol("get headers");
   const _signal = Symbol("signal");
   const _mimeType = Symbol("mime type");
   const _body = Symbol("body");
@@ -76,14 +78,24 @@
   /**
    * @param {string} method
    * @param {string} url
-   * @param {[string, string][]} headerList
+   * @param {[string, string][] | (() => [string, string][])} headerList The
+   * header list, or a function that creates it when it is first accessed.
    * @param {typeof __window.bootstrap.fetchBody.InnerBody} body
    * @returns
    */
   function newInnerRequest(method, url, headerList = [], body = null) {
+    let headerListInner = typeof headerList === "function" ? null : headerList;
     return {
       method: method,
-      headerList,
+      get headerList() {
+        if (headerListInner === null) {
+          headerListInner = headerList();
+        }
+        return headerListInner;
+      },
+      set headerList(value) {
+        headerListInner = value;
+      },
       body,
       urlList: [url],
       ...defaultInnerRequest,
@@ -161,10 +173,27 @@
   class Request {
     /** @type {InnerRequest} */
     [_request];
-    /** @type {Headers} */
-    [_headers];
+    /** @type {Headers | undefined} */
+    [_headersCache];
+    /** @type {() => Headers} */
+    [_getHeaders];
     /** @type {AbortSignal} */
     [_signal];
+
+    // Requests created by `fromInnerRequest` only build their `Headers` when
+    // they are first used.
+    /** @type {Headers} */
+    get [_headers]() {
+      if (this[_headersCache] === undefined) {
+        this[_headersCache] = this[_getHeaders]();
+      }
+      return this[_headersCache];
+    }
+
+    set [_headers](value) {
+      this[_headersCache] = value;
+    }
+
     get [_mimeType]() {
       let charset = null;
       let essence = null;
@@ -472,7 +501,7 @@
     const request = webidl.createBranded(Request);
     request[_request] = inner;
     request[_signal] = signal;
-    request[_headers] = headersFromHeaderList(inner.headerList, guard);
+    request[_getHeaders] = () => headersFromHeaderList(inner.headerList, guard);
     return request;
   }
 
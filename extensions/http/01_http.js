@@ -23,6 +23,7 @@
     ArrayPrototypeIncludes,
     ArrayPrototypePush,
     Promise,
+    PromisePrototypeThen,
     StringPrototypeIncludes,
     StringPrototypeSplit,
     Symbol,
@@ -33,12 +34,36 @@
   } = window.__bootstrap.primordials;
 
   const connErrorSymbol = Symbol("connError");
+  const bodyBufferSizeSymbol = Symbol("bodyBufferSize");
+
+  // While a chunk of a streamed response body is being written, the chunks
+  // after it are collected and written together once it is done. Reading
+  // from the stream pauses when this many bytes are waiting.
+  const MAX_PENDING_WRITE_SIZE = 64 * 1024;
+
+  // Methods that `op_http_request_next` sends as an index into this list.
+  // Keep in sync with `KNOWN_METHODS` in `lib.rs`.
+  const KNOWN_METHODS = [
+    "GET",
+    "HEAD",
+    "POST",
+    "PUT",
+    "DELETE",
+    "OPTIONS",
+    "CONNECT",
+    "PATCH",
+    "TRACE",
+  ];
 
   class HttpConn {
     #rid = 0;
+    // The origin of the previous request. `op_http_request_next` only sends
+    // it when it changes.
+    #origin = "";
 
-    constructor(rid) {
+    constructor(rid, options = {}) {
       this.#rid = rid;
+      this[bodyBufferSizeSymbol] = options.responseBodyBufferSize ?? 0;
     }
 
     /** @returns {number} */
@@ -75,21 +100,39 @@
       const [
         requestRid,
         responseSenderRid,
-        method,
-        headersList,
-        url,
+        requestHeadersRid,
+        methodOrIndex,
+        origin,
+        pathAndQuery,
       ] = nextRequest;
 
+      const method = typeof methodOrIndex === "number"
+        ? KNOWN_METHODS[methodOrIndex]
+        : methodOrIndex;
+      if (origin !== null) {
+        this.#origin = origin;
+      }
+      const url = this.#origin + pathAndQuery;
+
       /** @type {ReadableStream<Uint8Array> | undefined} */
       let body = null;
       if (typeof requestRid === "number") {
         body = createRequestBodyStream(requestRid);
       }
 
+      // The headers are only copied out of the request when they are first
+      // used, or when the response is finished if that comes first. The
+      // resource that holds them is closed then.
+      let headersRid = requestHeadersRid;
+      const readHeaders = () => {
+        const rid = headersRid;
+        headersRid = null;
+        return core.opSync("op_http_request_headers", rid);
+      };
       const innerRequest = newInnerRequest(
         method,
         url,
-        headersList,
+        readHeaders,
         body !== null ? new InnerBody(body) : null,
       );
       const signal = abortSignal.newSignal();
@@ -99,6 +142,12 @@
         this,
         responseSenderRid,
         requestRid,
+        () => {
+          // Keeps the headers readable after the response is sent.
+          if (headersRid !== null) {
+            innerRequest.headerList = readHeaders();
+          }
+        },
       );
 
       return { request, respondWith };
@@ -130,150 +179,252 @@
     );
   }
 
-  function createRespondWith(httpConn, responseSenderRid, requestRid) {
-    return async function respondWith(resp) {
-      if (resp instanceof Promise) {
-        resp = await resp;
-      }
+  // Whether `promise` is already settled, so that awaiting it would not wait
+  // for anything but the microtask queue.
+  async function isSettled(promise) {
+    let settled = false;
+    const onSettled = () => {
+      settled = true;
+    };
+    PromisePrototypeThen(promise, onSettled, onSettled);
+    await null;
+    return settled;
+  }
 
-      if (!(resp instanceof Response)) {
-        throw new TypeError(
-          "First argument to respondWith must be a Response or a promise resolving to a Response.",
+  /**
+   * @param {HttpConn} httpConn
+   * @param {ReadableStreamDefaultReader<Uint8Array>} reader
+   * @param {number} responseBodyRid
+   * @param {boolean} corked
+   */
+  async function writeResponseBody(httpConn, reader, responseBodyRid, corked) {
+    /** @type {Uint8Array[]} */
+    let pending = [];
+    let pendingSize = 0;
+    /** @type {Promise<void> | null} */
+    let writing = null;
+    let writeError = null;
+    // Whether chunks were written to the corked body since it was last
+    // uncorked.
+    let hasCorked = false;
+    // Set when the body is to be uncorked once the writes in flight are done.
+    let uncorkPending = false;
+
+    function write(promise) {
+      writing = PromisePrototypeThen(promise, () => {
+        writing = null;
+        if (pending.length > 0) {
+          flush();
+        } else if (uncorkPending) {
+          uncork();
+        }
+      }, (error) => {
+        writing = null;
+        const connError = httpConn[connErrorSymbol];
+        if (error instanceof BadResource && connError != null) {
+          error = new connError.constructor(connError.message);
+        }
+        writeError = error;
+      });
+    }
+
+    function flush() {
+      const chunks = pending;
+      pending = [];
+      pendingSize = 0;
+      hasCorked = corked;
+      const promise = chunks.length === 1
+        ? core.opAsync("op_http_response_write", responseBodyRid, chunks[0])
+        : core.opAsync(
+          "op_http_response_write_vectored",
+          responseBodyRid,
+          chunks,
         );
-      }
+      write(promise);
+    }
 
-      const innerResp = toInnerResponse(resp);
-
-      // If response body length is known, it will be sent synchronously in a
-      // single op, in other case a "response body" resource will be created and
-      // we'll be streaming it.
-      /** @type {ReadableStream<Uint8Array> | Uint8Array | null} */
-      let respBody = null;
-      if (innerResp.body !== null) {
-        if (innerResp.body.unusable()) throw new TypeError("Body is unusable.");
-        if (innerResp.body.streamOrStatic instanceof ReadableStream) {
-          if (
-            innerResp.body.length === null ||
-            innerResp.body.source instanceof Blob
-          ) {
-            respBody = innerResp.body.stream;
-          } else {
-            const reader = innerResp.body.stream.getReader();
-            const r1 = await reader.read();
-            if (r1.done) {
-              respBody = new Uint8Array(0);
-            } else {
-              respBody = r1.value;
-              const r2 = await reader.read();
-              if (!r2.done) throw new TypeError("Unreachable");
-            }
-          }
+    function uncork() {
+      uncorkPending = false;
+      hasCorked = false;
+      write(core.opAsync("op_http_response_uncork", responseBodyRid));
+    }
+
+    while (true) {
+      const read = reader.read();
+      // When the stream has nothing else ready, the chunks that the corked
+      // body has collected are sent rather than held back until more
+      // arrive, which might take arbitrarily long.
+      if (hasCorked && !(await isSettled(read))) {
+        if (writing === null) {
+          uncork();
         } else {
-          innerResp.body.streamOrStatic.consumed = true;
-          respBody = innerResp.body.streamOrStatic.body;
+          uncorkPending = true;
         }
-      } else {
-        respBody = new Uint8Array(0);
       }
+      const { value, done } = await read;
+      if (writeError !== null) break;
+      if (done) break;
+      if (!(value instanceof Uint8Array)) {
+        await reader.cancel(new TypeError("Value not a Uint8Array"));
+        break;
+      }
+      ArrayPrototypePush(pending, value);
+      pendingSize += value.byteLength;
+      if (writing === null) {
+        flush();
+      } else if (pendingSize >= MAX_PENDING_WRITE_SIZE) {
+        await writing;
+      }
+    }
+    while (writing !== null) {
+      await writing;
+    }
+    if (writeError !== null) {
+      await reader.cancel(writeError);
+      throw writeError;
+    }
+  }
 
-      let responseBodyRid;
+  function createRespondWith(
+    httpConn,
+    responseSenderRid,
+    requestRid,
+    finishRequest,
+  ) {
+    return async function respondWith(resp) {
       try {
-        responseBodyRid = await core.opAsync("op_http_response", [
-          responseSenderRid,
-          innerResp.status ?? 200,
-          innerResp.headerList,
-        ], respBody instanceof Uint8Array ? respBody : null);
-      } catch (error) {
-        const connError = httpConn[connErrorSymbol];
-        if (error instanceof BadResource && connError != null) {
-          // deno-lint-ignore no-ex-assign
-          error = new connError.constructor(connError.message);
+        if (resp instanceof Promise) {
+          resp = await resp;
         }
-        if (respBody !== null && respBody instanceof ReadableStream) {
-          await respBody.cancel(error);
+
+        if (!(resp instanceof Response)) {
+          throw new TypeError(
+            "First argument to respondWith must be a Response or a promise resolving to a Response.",
+          );
         }
-        throw error;
-      }
 
-      // If `respond` returns a responseBodyRid, we should stream the body
-      // to that resource.
-      if (responseBodyRid !== null) {
-        try {
-          if (respBody === null || !(respBody instanceof ReadableStream)) {
-            throw new TypeError("Unreachable");
+        const innerResp = toInnerResponse(resp);
+
+        // If response body length is known, it will be sent synchronously in
+        // a single op, in other case a "response body" resource will be
+        // created and we'll be streaming it.
+        /** @type {ReadableStream<Uint8Array> | Uint8Array | null} */
+        let respBody = null;
+        if (innerResp.body !== null) {
+          if (innerResp.body.unusable()) {
+            throw new TypeError("Body is unusable.");
           }
-          const reader = respBody.getReader();
-          while (true) {
-            const { value, done } = await reader.read();
-            if (done) break;
-            if (!(value instanceof Uint8Array)) {
-              await reader.cancel(new TypeError("Value not a Uint8Array"));
-              break;
-            }
-            try {
-              await core.opAsync(
-                "op_http_response_write",
-                responseBodyRid,
-                value,
-              );
-            } catch (error) {
-              const connError = httpConn[connErrorSymbol];
-              if (error instanceof BadResource && connError != null) {
-                // deno-lint-ignore no-ex-assign
-                error = new connError.constructor(connError.message);
+          if (innerResp.body.streamOrStatic instanceof ReadableStream) {
+            if (
+              innerResp.body.length === null ||
+              innerResp.body.source instanceof Blob
+            ) {
+              respBody = innerResp.body.stream;
+            } else {
+              const reader = innerResp.body.stream.getReader();
+              const r1 = await reader.read();
+              if (r1.done) {
+                respBody = new Uint8Array(0);
+              } else {
+                respBody = r1.value;
+                const r2 = await reader.read();
+                if (!r2.done) throw new TypeError("Unreachable");
               }
-              await reader.cancel(error);
-              throw error;
             }
+          } else {
+            innerResp.body.streamOrStatic.consumed = true;
+            respBody = innerResp.body.streamOrStatic.body;
           }
-        } finally {
-          // Once all chunks are sent, and the request body is closed, we can
-          // close the response body.
+        } else {
+          respBody = new Uint8Array(0);
+        }
+
+        let responseBodyRid;
+        try {
+          responseBodyRid = await core.opAsync("op_http_response", [
+            responseSenderRid,
+            innerResp.status ?? 200,
+            innerResp.headerList,
+          ], respBody instanceof Uint8Array ? respBody : null);
+        } catch (error) {
+          const connError = httpConn[connErrorSymbol];
+          if (error instanceof BadResource && connError != null) {
+            // deno-lint-ignore no-ex-assign
+            error = new connError.constructor(connError.message);
+          }
+          if (respBody !== null && respBody instanceof ReadableStream) {
+            await respBody.cancel(error);
+          }
+          throw error;
+        }
+
+        // If `respond` returns a responseBodyRid, we should stream the body
+        // to that resource.
+        if (responseBodyRid !== null) {
           try {
-            await core.opAsync("op_http_response_close", responseBodyRid);
-          } catch { /* pass */ }
+            if (respBody === null || !(respBody instanceof ReadableStream)) {
+              throw new TypeError("Unreachable");
+            }
+            const bufferSize = httpConn[bodyBufferSizeSymbol];
+            if (bufferSize > 0) {
+              core.opSync("op_http_response_cork", responseBodyRid, bufferSize);
+            }
+            await writeResponseBody(
+              httpConn,
+              respBody.getReader(),
+              responseBodyRid,
+            );
+          } finally {
+            // Once all chunks are sent, and the request body is closed, we can
+            // close the response body.
+            try {
+              await core.opAsync("op_http_response_close", responseBodyRid);
+            } catch { /* pass */ }
+          }
         }
-      }
 
-      const ws = resp[_ws];
-      if (ws) {
-        if (typeof requestRid !== "number") {
-          throw new TypeError(
-            "This request can not be upgraded to a websocket connection.",
+        const ws = resp[_ws];
+        if (ws) {
+          if (typeof requestRid !== "number") {
+            throw new TypeError(
+              "This request can not be upgraded to a websocket connection.",
+            );
+          }
+
+          const wsRid = await core.opAsync(
+            "op_http_upgrade_websocket",
+            requestRid,
           );
-        }
+          ws[_rid] = wsRid;
+          ws[_protocol] = resp.headers.get("sec-websocket-protocol");
 
-        const wsRid = await core.opAsync(
-          "op_http_upgrade_websocket",
-          requestRid,
-        );
-        ws[_rid] = wsRid;
-        ws[_protocol] = resp.headers.get("sec-websocket-protocol");
+          if (ws[_readyState] === WebSocket.CLOSING) {
+            await core.opAsync("op_ws_close", { rid: wsRid });
 
-        if (ws[_readyState] === WebSocket.CLOSING) {
-          await core.opAsync("op_ws_close", { rid: wsRid });
+            ws[_readyState] = WebSocket.CLOSED;
 
-          ws[_readyState] = WebSocket.CLOSED;
+            const errEvent = new ErrorEvent("error");
+            ws.dispatchEvent(errEvent);
 
-          const errEvent = new ErrorEvent("error");
-          ws.dispatchEvent(errEvent);
+            const event = new CloseEvent("close");
+            ws.dispatchEvent(event);
 
-          const event = new CloseEvent("close");
-          ws.dispatchEvent(event);
+            try {
+              core.close(wsRid);
+            } catch (err) {
+              // Ignore error if the socket has already been closed.
+              if (!(err instanceof Deno.errors.BadResource)) throw err;
+            }
+          } else {
+            ws[_readyState] = WebSocket.OPEN;
+            const event = new Event("open");
+            ws.dispatchEvent(event);
 
-          try {
-            core.close(wsRid);
-          } catch (err) {
-            // Ignore error if the socket has already been closed.
-            if (!(err instanceof Deno.errors.BadResource)) throw err;
+            ws[_eventLoop]();
           }
-        } else {
-          ws[_readyState] = WebSocket.OPEN;
-          const event = new Event("open");
-          ws.dispatchEvent(event);
-
-          ws[_eventLoop]();
         }
+      } finally {
+        finishRequest();
       }
     };
   }
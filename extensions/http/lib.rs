@@ -1,5 +1,7 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
+use bytes::Bytes;
+use bytes::BytesMut;
 use deno_core::error::bad_resource_id;
 use deno_core::error::null_opbuf;
 use deno_core::error::type_error;
@@ -31,6 +33,7 @@ use hyper::Response;
 use serde::Deserialize;
 use serde::Serialize;
 use std::borrow::Cow;
+use std::cell::Cell;
 use std::cell::RefCell;
 use std::future::Future;
 use std::net::SocketAddr;
@@ -57,9 +60,16 @@ pub fn init() -> Extension {
     ))
     .ops(vec![
       ("op_http_request_next", op_async(op_http_request_next)),
+      ("op_http_request_headers", op_sync(op_http_request_headers)),
       ("op_http_request_read", op_async(op_http_request_read)),
       ("op_http_response", op_async(op_http_response)),
       ("op_http_response_write", op_async(op_http_response_write)),
+      (
+        "op_http_response_write_vectored",
+        op_async(op_http_response_write_vectored),
+      ),
+      ("op_http_response_cork", op_sync(op_http_response_cork)),
+      ("op_http_response_uncork", op_async(op_http_response_uncork)),
       ("op_http_response_close", op_async(op_http_response_close)),
       (
         "op_http_websocket_accept_header",
@@ -125,6 +135,10 @@ struct ConnResource {
   hyper_connection: Conn,
   deno_service: Service,
   cancel: CancelHandle,
+  // The host of the last request that was passed to JS. Requests on the same
+  // connection almost always share it, so JS keeps the origin around and it is
+  // only sent again when it changes.
+  last_host: RefCell<Option<String>>,
 }
 
 impl ConnResource {
@@ -149,7 +163,36 @@ impl Resource for ConnResource {
   }
 }
 
+// The methods that are passed to JS as an index into `KNOWN_METHODS` in
+// `01_http.js` rather than as a string. Keep the two lists in sync.
+const KNOWN_METHODS: [&str; 9] = [
+  "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "CONNECT", "PATCH",
+  "TRACE",
+];
+
+#[derive(Serialize)]
+#[serde(untagged)]
+enum HttpMethod {
+  Known(u8),
+  // This is a String rather than a ByteString because hyper will only return
+  // the method as a str which is guaranteed to be ASCII-only.
+  Extension(String),
+}
+
+impl From<&http::Method> for HttpMethod {
+  fn from(method: &http::Method) -> Self {
+    let method = method.as_str();
+    match KNOWN_METHODS.iter().position(|m| *m == method) {
+      Some(index) => HttpMethod::Known(index as u8),
+      None => HttpMethod::Extension(method.to_string()),
+    }
+  }
+}
+
 // We use a tuple instead of struct to avoid serialization overhead of the keys.
+// The request headers are not part of it: they stay in a
+// `RequestHeadersResource` until JS asks for them with
+// `op_http_request_headers`.
 #[derive(Serialize)]
 #[serde(rename_all = "camelCase")]
 struct NextRequestResponse(
@@ -157,13 +200,15 @@ struct NextRequestResponse(
   Option<ResourceId>,
   // response_sender_rid:
   ResourceId,
+  // request_headers_rid:
+  ResourceId,
   // method:
-  // This is a String rather than a ByteString because reqwest will only return
-  // the method as a str which is guaranteed to be ASCII-only.
-  String,
-  // headers:
-  Vec<(ByteString, ByteString)>,
-  // url:
+  HttpMethod,
+  // origin:
+  // Only set when it differs from the one of the previous request on this
+  // connection.
+  Option<String>,
+  // path_and_query:
   String,
 );
 
@@ -214,48 +259,10 @@ async fn op_http_request_next(
       conn_resource.deno_service.inner.borrow_mut().take()
     {
       let tx = request_resource.response_tx;
-      let req = request_resource.request;
-      let method = req.method().to_string();
-
-      // We treat cookies specially, because we don't want them to get them
-      // mangled by the `Headers` object in JS. What we do is take all cookie
-      // headers and concat them into a single cookie header, seperated by
-      // semicolons.
-      let mut total_cookie_length = 0;
-      let mut cookies = vec![];
-
-      let mut headers = Vec::with_capacity(req.headers().len());
-      for (name, value) in req.headers().iter() {
-        if name == hyper::header::COOKIE {
-          let bytes = value.as_bytes();
-          total_cookie_length += bytes.len();
-          cookies.push(bytes);
-        } else {
-          let name: &[u8] = name.as_ref();
-          let value = value.as_bytes();
-          headers
-            .push((ByteString(name.to_owned()), ByteString(value.to_owned())));
-        }
-      }
-
-      if !cookies.is_empty() {
-        let cookie_count = cookies.len();
-        total_cookie_length += (cookie_count * 2) - 2;
-        let mut bytes = Vec::with_capacity(total_cookie_length);
-        for (i, cookie) in cookies.into_iter().enumerate() {
-          bytes.extend(cookie);
-          if i != cookie_count - 1 {
-            bytes.extend("; ".as_bytes());
-          }
-        }
-        headers.push((
-          ByteString("cookie".as_bytes().to_owned()),
-          ByteString(bytes),
-        ));
-      }
+      let mut req = request_resource.request;
+      let method = HttpMethod::from(req.method());
 
-      let url = {
-        let scheme = &conn_resource.hyper_connection.scheme;
+      let maybe_origin = {
         let host: Cow<str> = if let Some(host) = req.uri().host() {
           Cow::Borrowed(host)
         } else if let Some(host) = req.headers().get("HOST") {
@@ -263,9 +270,21 @@ async fn op_http_request_next(
         } else {
           Cow::Owned(conn_resource.hyper_connection.addr.to_string())
         };
-        let path = req.uri().path_and_query().map_or("/", |p| p.as_str());
-        format!("{}://{}{}", scheme, host, path)
+        let mut last_host = conn_resource.last_host.borrow_mut();
+        if last_host.as_deref() == Some(&*host) {
+          None
+        } else {
+          let scheme = &conn_resource.hyper_connection.scheme;
+          let origin = format!("{}://{}", scheme, host);
+          *last_host = Some(host.into_owned());
+          Some(origin)
+        }
       };
+      let path_and_query = req
+        .uri()
+        .path_and_query()
+        .map_or("/", |p| p.as_str())
+        .to_string();
 
       let is_websocket_request = req
         .headers()
@@ -288,6 +307,10 @@ async fn op_http_request_next(
         true
       };
 
+      // Nothing below needs the headers anymore, so they are moved out of
+      // the request rather than copied.
+      let headers = std::mem::take(req.headers_mut());
+
       let maybe_request_rid = if is_websocket_request || has_body {
         let mut state = state.borrow_mut();
         let request_rid = state.resource_table.add(RequestResource {
@@ -306,13 +329,16 @@ async fn op_http_request_next(
           sender: tx,
           conn_rid,
         });
+      let request_headers_rid =
+        state.resource_table.add(RequestHeadersResource(headers));
 
       Poll::Ready(Ok(Some(NextRequestResponse(
         maybe_request_rid,
         response_sender_rid,
+        request_headers_rid,
         method,
-        headers,
-        url,
+        maybe_origin,
+        path_and_query,
       ))))
     } else if connection_closed {
       Poll::Ready(Ok(None))
@@ -325,6 +351,60 @@ async fn op_http_request_next(
   .map_err(AnyError::from)
 }
 
+/// Returns the headers of a request and closes `rid`, the resource that held
+/// them. JS keeps the returned list, so the op is called at most once per
+/// request.
+fn op_http_request_headers(
+  state: &mut OpState,
+  rid: ResourceId,
+  _: (),
+) -> Result<Vec<(ByteString, ByteString)>, AnyError> {
+  let resource = state
+    .resource_table
+    .take::<RequestHeadersResource>(rid)
+    .ok_or_else(bad_resource_id)?;
+  let headers = &resource.0;
+
+  // We treat cookies specially, because we don't want them to get them
+  // mangled by the `Headers` object in JS. What we do is take all cookie
+  // headers and concat them into a single cookie header, seperated by
+  // semicolons.
+  let mut total_cookie_length = 0;
+  let mut cookies = vec![];
+
+  let mut header_list = Vec::with_capacity(headers.len());
+  for (name, value) in headers.iter() {
+    if name == hyper::header::COOKIE {
+      let bytes = value.as_bytes();
+      total_cookie_length += bytes.len();
+      cookies.push(bytes);
+    } else {
+      let name: &[u8] = name.as_ref();
+      let value = value.as_bytes();
+      header_list
+        .push((ByteString(name.to_owned()), ByteString(value.to_owned())));
+    }
+  }
+
+  if !cookies.is_empty() {
+    let cookie_count = cookies.len();
+    total_cookie_length += (cookie_count * 2) - 2;
+    let mut bytes = Vec::with_capacity(total_cookie_length);
+    for (i, cookie) in cookies.into_iter().enumerate() {
+      bytes.extend(cookie);
+      if i != cookie_count - 1 {
+        bytes.extend("; ".as_bytes());
+      }
+    }
+    header_list.push((
+      ByteString("cookie".as_bytes().to_owned()),
+      ByteString(bytes),
+    ));
+  }
+
+  Ok(header_list)
+}
+
 fn should_ignore_error(e: &AnyError) -> bool {
   if let Some(e) = e.downcast_ref::<hyper::Error>() {
     use std::error::Error;
@@ -360,6 +440,7 @@ pub fn start_http<IO: AsyncRead + AsyncWrite + Unpin + Send + 'static>(
     },
     deno_service,
     cancel: CancelHandle::default(),
+    last_host: RefCell::new(None),
   };
   let rid = state.resource_table.add(conn_resource);
   Ok(rid)
@@ -421,6 +502,8 @@ async fn op_http_response(
       state.borrow_mut().resource_table.add(ResponseBodyResource {
         body: AsyncRefCell::new(sender),
         conn_rid,
+        corked: RefCell::new(BytesMut::new()),
+        cork_threshold: Cell::new(0),
       });
 
     Some(response_body_rid)
@@ -464,6 +547,9 @@ async fn op_http_response_close(
     .resource_table
     .get::<ConnResource>(resource.conn_rid)
     .ok_or_else(bad_resource_id)?;
+
+  // Chunks that are still corked have to be sent before the body is ended.
+  send_corked_response_body(&resource, &conn_resource).await?;
   drop(resource);
 
   let r = poll_fn(|cx| match conn_resource.poll(cx) {
@@ -535,10 +621,48 @@ async fn op_http_response_write(
   data: Option<ZeroCopyBuf>,
 ) -> Result<(), AnyError> {
   let buf = data.ok_or_else(null_opbuf)?;
+  write_response_body(state, rid, &[buf]).await
+}
+
+/// Writes several chunks of a response body with a single op. They are
+/// handed to hyper together, as one buffer.
+async fn op_http_response_write_vectored(
+  state: Rc<RefCell<OpState>>,
+  rid: ResourceId,
+  chunks: Vec<ZeroCopyBuf>,
+) -> Result<(), AnyError> {
+  write_response_body(state, rid, &chunks).await
+}
+
+/// Corks a response body: from now on, written chunks are collected until
+/// there are at least `threshold` bytes of them, or until
+/// `op_http_response_uncork` or `op_http_response_close` is called, and only
+/// then sent to the connection.
+fn op_http_response_cork(
+  state: &mut OpState,
+  rid: ResourceId,
+  threshold: usize,
+) -> Result<(), AnyError> {
+  let resource = state
+    .resource_table
+    .get::<ResponseBodyResource>(rid)
+    .ok_or_else(bad_resource_id)?;
+  resource.cork_threshold.set(threshold);
+  Ok(())
+}
+
+/// Sends the chunks that were collected while the response body was corked,
+/// without waiting for the threshold. The body stays corked for the chunks
+/// that are written after this.
+async fn op_http_response_uncork(
+  state: Rc<RefCell<OpState>>,
+  rid: ResourceId,
+  _: (),
+) -> Result<(), AnyError> {
   let resource = state
     .borrow()
     .resource_table
-    .get::<ResponseBodyResource>(rid as u32)
+    .get::<ResponseBodyResource>(rid)
     .ok_or_else(bad_resource_id)?;
 
   let conn_resource = state
@@ -547,9 +671,61 @@ async fn op_http_response_write(
     .get::<ConnResource>(resource.conn_rid)
     .ok_or_else(bad_resource_id)?;
 
-  let mut body = RcRef::map(&resource, |r| &r.body).borrow_mut().await;
+  send_corked_response_body(&resource, &conn_resource).await
+}
 
-  let mut send_data_fut = body.send_data(Vec::from(&*buf).into()).boxed_local();
+async fn write_response_body(
+  state: Rc<RefCell<OpState>>,
+  rid: ResourceId,
+  chunks: &[ZeroCopyBuf],
+) -> Result<(), AnyError> {
+  let resource = state
+    .borrow()
+    .resource_table
+    .get::<ResponseBodyResource>(rid)
+    .ok_or_else(bad_resource_id)?;
+
+  let conn_resource = state
+    .borrow()
+    .resource_table
+    .get::<ConnResource>(resource.conn_rid)
+    .ok_or_else(bad_resource_id)?;
+
+  // Every chunk is copied once, into the buffer that is handed to hyper.
+  let bytes = {
+    let mut corked = resource.corked.borrow_mut();
+    corked.reserve(chunks.iter().map(|chunk| chunk.len()).sum());
+    for chunk in chunks {
+      corked.extend_from_slice(chunk);
+    }
+    if corked.is_empty() || corked.len() < resource.cork_threshold.get() {
+      return Ok(());
+    }
+    corked.split().freeze()
+  };
+
+  send_response_body(&resource, &conn_resource, bytes).await
+}
+
+async fn send_corked_response_body(
+  resource: &Rc<ResponseBodyResource>,
+  conn_resource: &ConnResource,
+) -> Result<(), AnyError> {
+  let corked = resource.corked.borrow_mut().split().freeze();
+  if corked.is_empty() {
+    return Ok(());
+  }
+  send_response_body(resource, conn_resource, corked).await
+}
+
+async fn send_response_body(
+  resource: &Rc<ResponseBodyResource>,
+  conn_resource: &ConnResource,
+  bytes: Bytes,
+) -> Result<(), AnyError> {
+  let mut body = RcRef::map(resource, |r| &r.body).borrow_mut().await;
+
+  let mut send_data_fut = body.send_data(bytes).boxed_local();
 
   poll_fn(|cx| {
     let r = send_data_fut.poll_unpin(cx).map_err(AnyError::from);
@@ -658,9 +834,25 @@ impl Resource for ResponseSenderResource {
   }
 }
 
+// The headers of a request that JS has not read yet. This is independent of
+// the response sender so that the headers can still be read after the
+// response was sent. JS takes it once the response is finished, if it hasn't
+// read the headers before.
+struct RequestHeadersResource(http::HeaderMap);
+
+impl Resource for RequestHeadersResource {
+  fn name(&self) -> Cow<str> {
+    "requestHeaders".into()
+  }
+}
+
 struct ResponseBodyResource {
   body: AsyncRefCell<hyper::body::Sender>,
   conn_rid: ResourceId,
+  // Chunks that were written but not sent yet, because there are fewer than
+  // `cork_threshold` bytes of them.
+  corked: RefCell<BytesMut>,
+  cork_threshold: Cell<usize>,
 }
 
 impl Resource for ResponseBodyResource {
@@ -130,6 +130,28 @@ declare namespace Deno {
     options: UnixListenOptions & { transport: "unix" },
   ): Listener;
 
+  export interface TcpListenOptions extends ListenOptions {
+    /** Sets `SO_REUSEPORT` on the listening socket, so that several
+   * listeners, for example one in each of a number of workers, can listen on
+   * the same address. The kernel then balances incoming connections between
+   * them. Not supported on Windows. */
+    reusePort?: boolean;
+  }
+
+  /** **UNSTABLE**: new API, yet to be vetted.
+*
+* Listen announces on the local transport address, with `SO_REUSEPORT`.
+*
+* ```ts
+* // In each of several workers:
+* const listener = Deno.listen({ port: 80, reusePort: true });
+* ```
+*
+* Requires `allow-net` permission. */
+  export function listen(
+    options: TcpListenOptions & { transport?: "tcp" },
+  ): Listener;
+
   /** **UNSTABLE**: new API, yet to be vetted
 *
 * Listen announces on the local transport address.
@@ -45,6 +45,8 @@ use super::ops_unix as net_unix;
 use crate::io::UnixStreamResource;
 #[cfg(unix)]
 use std::path::Path;
+#[cfg(all(unix, not(target_os = "solaris"), not(target_os = "illumos")))]
+use tokio::net::TcpSocket;
 
 pub fn init<P: NetPermissions + 'static>() -> Vec<OpPair> {
   vec![
@@ -394,9 +396,12 @@ impl Resource for UdpSocketResource {
 }
 
 #[derive(Deserialize)]
+#[serde(rename_all = "camelCase")]
 struct IpListenArgs {
   hostname: String,
   port: u16,
+  #[serde(default)]
+  reuse_port: bool,
 }
 
 #[derive(Deserialize)]
@@ -417,10 +422,15 @@ struct ListenArgs {
 fn listen_tcp(
   state: &mut OpState,
   addr: SocketAddr,
+  reuse_port: bool,
 ) -> Result<(u32, SocketAddr), AnyError> {
-  let std_listener = std::net::TcpListener::bind(&addr)?;
-  std_listener.set_nonblocking(true)?;
-  let listener = TcpListener::from_std(std_listener)?;
+  let listener = if reuse_port {
+    listen_tcp_reuse_port(addr)?
+  } else {
+    let std_listener = std::net::TcpListener::bind(&addr)?;
+    std_listener.set_nonblocking(true)?;
+    TcpListener::from_std(std_listener)?
+  };
   let local_addr = listener.local_addr()?;
   let listener_resource = TcpListenerResource {
     listener: AsyncRefCell::new(listener),
@@ -431,6 +441,28 @@ fn listen_tcp(
   Ok((rid, local_addr))
 }
 
+/// Binds a listener with `SO_REUSEPORT` set, so that several listeners (for
+/// example one per worker) can share the address and the kernel balances the
+/// incoming connections between them.
+#[cfg(all(unix, not(target_os = "solaris"), not(target_os = "illumos")))]
+fn listen_tcp_reuse_port(addr: SocketAddr) -> Result<TcpListener, AnyError> {
+  let socket = if addr.is_ipv4() {
+    TcpSocket::new_v4()?
+  } else {
+    TcpSocket::new_v6()?
+  };
+  // Match the options that std sets on listeners.
+  socket.set_reuseaddr(true)?;
+  socket.set_reuseport(true)?;
+  socket.bind(addr)?;
+  Ok(socket.listen(128)?)
+}
+
+#[cfg(not(all(unix, not(target_os = "solaris"), not(target_os = "illumos"))))]
+fn listen_tcp_reuse_port(_addr: SocketAddr) -> Result<TcpListener, AnyError> {
+  Err(deno_core::error::not_supported())
+}
+
 fn listen_udp(
   state: &mut OpState,
   addr: SocketAddr,
@@ -465,6 +497,9 @@ where
         if transport == "udp" {
           super::check_unstable(state, "Deno.listenDatagram");
         }
+        if args.reuse_port {
+          super::check_unstable(state, "Deno.listen({ reusePort: true })");
+        }
         state
           .borrow_mut::<NP>()
           .check_net(&(&args.hostname, Some(args.port)))?;
@@ -473,7 +508,7 @@ where
         .next()
         .ok_or_else(|| generic_error("No resolved address found"))?;
       let (rid, local_addr) = if transport == "tcp" {
-        listen_tcp(state, addr)?
+        listen_tcp(state, addr, args.reuse_port)?
       } else {
         listen_udp(state, addr)?
       };
@@ -4,10 +4,8 @@
 ((window) => {
   const core = window.Deno.core;
   const {
-    ArrayPrototypeIndexOf,
     ArrayPrototypePush,
     ArrayPrototypeShift,
-    ArrayPrototypeSplice,
     DateNow,
     Error,
     FunctionPrototypeBind,
@@ -16,8 +14,9 @@
     MapPrototypeGet,
     MapPrototypeHas,
     MapPrototypeSet,
+    MathClz32,
+    MathFloor,
     MathMax,
-    Number,
     String,
     TypeError,
   } = window.__bootstrap.primordials;
@@ -61,250 +60,208 @@
     return core.opSync("op_sleep_sync", millis);
   }
 
-  // Derived from https://github.com/vadimg/js_bintrees. MIT Licensed.
+  // A hierarchical timer wheel, in the style of the one in tokio. Inserting
+  // and removing a timer is O(1). Level `n` has `WHEEL_SLOTS` slots that
+  // each cover `WHEEL_SLOTS ** n` milliseconds, so together the levels cover
+  // `WHEEL_SLOTS ** WHEEL_LEVELS` milliseconds (about a year), more than
+  // `TIMEOUT_MAX`. A timer goes into the lowest level whose current rotation
+  // contains its due time. When the wheel time reaches the start of a slot in
+  // a higher level, the timers in it are moved down to the lower levels.
+  const WHEEL_SLOTS = 32;
+  const WHEEL_LEVELS = 7;
 
-  class RBNode {
-    constructor(data) {
-      this.data = data;
-      this.left = null;
-      this.right = null;
-      this.red = true;
-    }
-
-    getChild(dir) {
-      return dir ? this.right : this.left;
-    }
-
-    setChild(dir, val) {
-      if (dir) {
-        this.right = val;
+  /**
+   * A doubly linked list of timers, linked through `prev` and `next`. Timers
+   * are appended, so that timers that are due at the same time fire in the
+   * order they were created in.
+   */
+  class TimerList {
+    head = null;
+    tail = null;
+
+    push(timer) {
+      timer.list = this;
+      timer.prev = this.tail;
+      timer.next = null;
+      if (this.tail !== null) {
+        this.tail.next = timer;
       } else {
-        this.left = val;
+        this.head = timer;
       }
+      this.tail = timer;
     }
-  }
 
-  class RBTree {
-    #comparator = null;
-    #root = null;
-
-    constructor(comparator) {
-      this.#comparator = comparator;
-      this.#root = null;
-    }
-
-    /** Returns `null` if tree is empty. */
-    min() {
-      let res = this.#root;
-      if (res === null) {
-        return null;
+    remove(timer) {
+      if (timer.prev !== null) {
+        timer.prev.next = timer.next;
+      } else {
+        this.head = timer.next;
       }
-      while (res.left !== null) {
-        res = res.left;
+      if (timer.next !== null) {
+        timer.next.prev = timer.prev;
+      } else {
+        this.tail = timer.prev;
       }
-      return res.data;
+      timer.list = null;
+      timer.prev = null;
+      timer.next = null;
     }
 
-    /** Returns node `data` if found, `null` otherwise. */
-    find(data) {
-      let res = this.#root;
-      while (res !== null) {
-        const c = this.#comparator(data, res.data);
-        if (c === 0) {
-          return res.data;
-        } else {
-          res = res.getChild(c > 0);
-        }
-      }
-      return null;
+    /** Empties the list and returns its first timer. */
+    take() {
+      const head = this.head;
+      this.head = null;
+      this.tail = null;
+      return head;
     }
+  }
 
-    /** returns `true` if inserted, `false` if duplicate. */
-    insert(data) {
-      let ret = false;
-
-      if (this.#root === null) {
-        // empty tree
-        this.#root = new RBNode(data);
-        ret = true;
-      } else {
-        const head = new RBNode(null); // fake tree root
-
-        let dir = 0;
-        let last = 0;
-
-        // setup
-        let gp = null; // grandparent
-        let ggp = head; // grand-grand-parent
-        let p = null; // parent
-        let node = this.#root;
-        ggp.right = this.#root;
-
-        // search down
-        while (true) {
-          if (node === null) {
-            // insert new node at the bottom
-            node = new RBNode(data);
-            p.setChild(dir, node);
-            ret = true;
-          } else if (isRed(node.left) && isRed(node.right)) {
-            // color flip
-            node.red = true;
-            node.left.red = false;
-            node.right.red = false;
-          }
-
-          // fix red violation
-          if (isRed(node) && isRed(p)) {
-            const dir2 = ggp.right === gp;
-
-            assert(gp);
-            if (node === p.getChild(last)) {
-              ggp.setChild(dir2, singleRotate(gp, !last));
-            } else {
-              ggp.setChild(dir2, doubleRotate(gp, !last));
-            }
-          }
-
-          const cmp = this.#comparator(node.data, data);
-
-          // stop if found
-          if (cmp === 0) {
-            break;
-          }
+  function trailingZeros(bits) {
+    return 31 - MathClz32(bits & -bits);
+  }
 
-          last = dir;
-          dir = Number(cmp < 0); // Fix type
+  function rotateRight(bits, n) {
+    return n === 0 ? bits : ((bits >>> n) | (bits << (32 - n))) >>> 0;
+  }
 
-          // update helpers
-          if (gp !== null) {
-            ggp = gp;
-          }
-          gp = p;
-          p = node;
-          node = node.getChild(dir);
+  class TimerWheel {
+    /** The time up to which the wheel has been advanced. */
+    #time = 0;
+    #size = 0;
+    /** One `TimerList` per slot, for every level. */
+    #levels = [];
+    /** For every level, a bit mask of the slots that hold timers. */
+    #occupied = [];
+    /** Timers that were due by the time they were inserted. */
+    #expired = new TimerList();
+
+    constructor() {
+      for (let level = 0; level < WHEEL_LEVELS; level++) {
+        const slots = [];
+        for (let slot = 0; slot < WHEEL_SLOTS; slot++) {
+          ArrayPrototypePush(slots, new TimerList());
         }
-
-        // update root
-        this.#root = head.right;
+        ArrayPrototypePush(this.#levels, slots);
+        ArrayPrototypePush(this.#occupied, 0);
       }
+    }
 
-      // make root black
-      this.#root.red = false;
-
-      return ret;
+    get size() {
+      return this.#size;
     }
 
-    /** Returns `true` if removed, `false` if not found. */
-    remove(data) {
-      if (this.#root === null) {
-        return false;
+    insert(timer, now) {
+      if (this.#size === 0) {
+        // Nothing depends on the old wheel time, so catch up for free.
+        this.#time = now;
       }
+      this.#size++;
+      this.#place(timer);
+    }
 
-      const head = new RBNode(null); // fake tree root
-      let node = head;
-      node.right = this.#root;
-      let p = null; // parent
-      let gp = null; // grand parent
-      let found = null; // found item
-      let dir = 1;
-
-      while (node.getChild(dir) !== null) {
-        const last = dir;
-
-        // update helpers
-        gp = p;
-        p = node;
-        node = node.getChild(dir);
-
-        const cmp = this.#comparator(data, node.data);
+    remove(timer) {
+      const list = timer.list;
+      list.remove(timer);
+      if (list.head === null && list !== this.#expired) {
+        this.#occupied[timer.level] &= ~(1 << timer.slot);
+      }
+      this.#size--;
+    }
 
-        dir = cmp > 0;
+    /**
+     * Returns when the wheel has to be advanced next, or `null` if it is empty.
+     * This can be earlier than when the next timer is due, if that timer has
+     * to be moved down to a lower level first.
+     */
+    nextDue(now) {
+      if (this.#expired.head !== null) {
+        return now;
+      }
+      const next = this.#nextExpiration();
+      return next === null ? null : next.due;
+    }
 
-        // save found node
-        if (cmp === 0) {
-          found = node;
-        }
+    /** Removes all timers that are due at `now`, and calls `fn` for each. */
+    advance(now, fn) {
+      let timer = this.#expired.take();
+      while (timer !== null) {
+        const next = timer.next;
+        timer.list = null;
+        this.#size--;
+        fn(timer);
+        timer = next;
+      }
 
-        // push the red node down
-        if (!isRed(node) && !isRed(node.getChild(dir))) {
-          if (isRed(node.getChild(!dir))) {
-            const sr = singleRotate(node, dir);
-            p.setChild(last, sr);
-            p = sr;
-          } else if (!isRed(node.getChild(!dir))) {
-            const sibling = p.getChild(!last);
-            if (sibling !== null) {
-              if (
-                !isRed(sibling.getChild(!last)) &&
-                !isRed(sibling.getChild(last))
-              ) {
-                // color flip
-                p.red = false;
-                sibling.red = true;
-                node.red = true;
-              } else {
-                assert(gp);
-                const dir2 = gp.right === p;
-
-                if (isRed(sibling.getChild(last))) {
-                  gp.setChild(dir2, doubleRotate(p, last));
-                } else if (isRed(sibling.getChild(!last))) {
-                  gp.setChild(dir2, singleRotate(p, last));
-                }
-
-                // ensure correct coloring
-                const gpc = gp.getChild(dir2);
-                assert(gpc);
-                gpc.red = true;
-                node.red = true;
-                assert(gpc.left);
-                gpc.left.red = false;
-                assert(gpc.right);
-                gpc.right.red = false;
-              }
-            }
+      let expiration;
+      while (
+        (expiration = this.#nextExpiration()) !== null &&
+        expiration.due <= now
+      ) {
+        const { level, slot, due } = expiration;
+        this.#time = due;
+        this.#occupied[level] &= ~(1 << slot);
+        timer = this.#levels[level][slot].take();
+        while (timer !== null) {
+          const next = timer.next;
+          timer.list = null;
+          if (timer.due <= due) {
+            this.#size--;
+            fn(timer);
+          } else {
+            this.#place(timer);
           }
+          timer = next;
         }
       }
+      this.#time = MathMax(this.#time, now);
+    }
 
-      // replace and remove if found
-      if (found !== null) {
-        found.data = node.data;
-        assert(p);
-        p.setChild(p.right === node, node.getChild(node.left === null));
+    #place(timer) {
+      const time = this.#time;
+      const due = timer.due;
+      if (due <= time) {
+        this.#expired.push(timer);
+        return;
       }
-
-      // update root and make it black
-      this.#root = head.right;
-      if (this.#root !== null) {
-        this.#root.red = false;
+      let level = 0;
+      let slotRange = 1;
+      while (
+        level < WHEEL_LEVELS - 1 &&
+        MathFloor(due / (slotRange * WHEEL_SLOTS)) !==
+          MathFloor(time / (slotRange * WHEEL_SLOTS))
+      ) {
+        level++;
+        slotRange *= WHEEL_SLOTS;
       }
-
-      return found !== null;
+      const slot = MathFloor(due / slotRange) % WHEEL_SLOTS;
+      timer.level = level;
+      timer.slot = slot;
+      this.#levels[level][slot].push(timer);
+      this.#occupied[level] |= 1 << slot;
     }
-  }
-
-  function isRed(node) {
-    return node !== null && node.red;
-  }
-
-  function singleRotate(root, dir) {
-    const save = root.getChild(!dir);
-    assert(save);
-
-    root.setChild(!dir, save.getChild(dir));
-    save.setChild(dir, root);
 
-    root.red = true;
-    save.red = false;
-
-    return save;
-  }
-
-  function doubleRotate(root, dir) {
-    root.setChild(!dir, singleRotate(root.getChild(!dir), !dir));
-    return singleRotate(root, dir);
+    #nextExpiration() {
+      const time = this.#time;
+      let slotRange = 1;
+      for (let level = 0; level < WHEEL_LEVELS; level++) {
+        const occupied = this.#occupied[level];
+        const levelRange = slotRange * WHEEL_SLOTS;
+        if (occupied !== 0) {
+          const currentSlot = MathFloor(time / slotRange) % WHEEL_SLOTS;
+          const slot =
+            (trailingZeros(rotateRight(occupied, currentSlot)) + currentSlot) %
+            WHEEL_SLOTS;
+          let due = time - (time % levelRange) + slot * slotRange;
+          if (due < time) {
+            // Only possible in the last level, whose rotation can wrap around.
+            due += levelRange;
+          }
+          return { level, slot, due };
+        }
+        slotRange = levelRange;
+      }
+      return null;
+    }
   }
 
   const { console } = globalThis;
@@ -316,7 +273,7 @@
 
   let nextTimerId = 1;
   const idMap = new Map();
-  const dueTree = new RBTree((a, b) => a.due - b.due);
+  const timerWheel = new TimerWheel();
 
   function clearGlobalTimeout() {
     globalTimeoutDue = null;
@@ -370,20 +327,13 @@
     if (globalTimeoutDue === null || pendingEvents > 0) {
       return;
     }
-    // After firing the timers that are due now, this will hold the first timer
-    // list that hasn't fired yet.
-    let nextDueNode;
-    while ((nextDueNode = dueTree.min()) !== null && nextDueNode.due <= now) {
-      dueTree.remove(nextDueNode);
-      // Fire all the timers in the list.
-      for (const timer of nextDueNode.timers) {
-        // With the list dropped, the timer is no longer scheduled.
-        timer.scheduled = false;
-        // Place the callback to pending timers to fire.
-        ArrayPrototypePush(pendingFireTimers, timer);
-      }
-    }
-    setOrClearGlobalTimeout(nextDueNode && nextDueNode.due, now);
+    timerWheel.advance(now, (timer) => {
+      // Out of the wheel, the timer is no longer scheduled.
+      timer.scheduled = false;
+      // Place the callback to pending timers to fire.
+      ArrayPrototypePush(pendingFireTimers, timer);
+    });
+    setOrClearGlobalTimeout(timerWheel.nextDue(now), now);
   }
 
   function setOrClearGlobalTimeout(due, now) {
@@ -397,15 +347,7 @@
   function schedule(timer, now) {
     assert(!timer.scheduled);
     assert(now <= timer.due);
-    // Find or create the list of timers that will fire at point-in-time `due`.
-    const maybeNewDueNode = { due: timer.due, timers: [] };
-    let dueNode = dueTree.find(maybeNewDueNode);
-    if (dueNode === null) {
-      dueTree.insert(maybeNewDueNode);
-      dueNode = maybeNewDueNode;
-    }
-    // Append the newly scheduled timer to the list and mark it as scheduled.
-    ArrayPrototypePush(dueNode.timers, timer);
+    timerWheel.insert(timer, now);
     timer.scheduled = true;
     // If the new timer is scheduled to fire before any timer that existed before,
     // update the global timeout to reflect this.
@@ -415,41 +357,19 @@
   }
 
   function unschedule(timer) {
-    // Check if our timer is pending scheduling or pending firing.
-    // If either is true, they are not in tree, and their idMap entry
-    // will be deleted soon. Remove it from queue.
-    let index = -1;
-    if ((index = ArrayPrototypeIndexOf(pendingFireTimers, timer)) >= 0) {
-      ArrayPrototypeSplice(pendingFireTimers, index);
-      return;
-    }
-    // If timer is not in the 2 pending queues and is unscheduled,
-    // it is not in the tree.
+    // A timer that is pending firing is no longer in the wheel. It won't fire
+    // because its idMap entry is deleted along with it.
     if (!timer.scheduled) {
       return;
     }
-    const searchKey = { due: timer.due, timers: [] };
-    // Find the list of timers that will fire at point-in-time `due`.
-    const list = dueTree.find(searchKey).timers;
-    if (list.length === 1) {
-      // Time timer is the only one in the list. Remove the entire list.
-      assert(list[0] === timer);
-      dueTree.remove(searchKey);
-      // If the unscheduled timer was 'next up', find when the next timer that
-      // still exists is due, and update the global alarm accordingly.
-      if (timer.due === globalTimeoutDue) {
-        const nextDueNode = dueTree.min();
-        setOrClearGlobalTimeout(
-          nextDueNode && nextDueNode.due,
-          DateNow(),
-        );
-      }
-    } else {
-      // Multiple timers that are due at the same point in time.
-      // Remove this timer from the list.
-      const index = ArrayPrototypeIndexOf(list, timer);
-      assert(index > -1);
-      ArrayPrototypeSplice(list, index, 1);
+    timerWheel.remove(timer);
+    timer.scheduled = false;
+    // The global timeout is only cleared once there are no timers left. If
+    // this was the next timer, the global timeout fires without any timer
+    // being due, and is then set for the next one. That is cheaper than
+    // resetting it on every clear.
+    if (timerWheel.size === 0) {
+      clearGlobalTimeout();
     }
   }
 
@@ -525,6 +445,12 @@
       due: now + delay,
       repeat,
       scheduled: false,
+      // The position of the timer in the timer wheel.
+      list: null,
+      prev: null,
+      next: null,
+      level: 0,
+      slot: 0,
     };
     // Register the timer's existence in the id-to-timer map.
     MapPrototypeSet(idMap, timer.id, timer);
@@ -6,6 +6,22 @@ use deno_bench_util::{bench_js_async, bench_js_sync};
 use deno_web::BlobStore;
 
 fn setup() -> Vec<Extension> {
+  setup_with("")
+}
+
+// Like `setup`, but with 100k timers outstanding, like a server that sets a
+// timeout for every request.
+fn setup_outstanding() -> Vec<Extension> {
+  setup_with(
+    r#"
+    for (let i = 0; i < 100000; i++) {
+      setTimeout(() => {}, 60000 + (i * 7919) % 60000);
+    }
+    "#,
+  )
+}
+
+fn setup_with(extra_src: &'static str) -> Vec<Extension> {
   vec![
     deno_webidl::init(),
     deno_url::init(),
@@ -14,10 +30,10 @@ fn setup() -> Vec<Extension> {
     Extension::builder()
     .js(vec![
       ("setup",
-        Box::new(|| Ok(r#"
-        const { opNow, setTimeout, handleTimerMacrotask } = globalThis.__bootstrap.timers;
+        Box::new(move || Ok(r#"
+        const { opNow, setTimeout, clearTimeout, handleTimerMacrotask } = globalThis.__bootstrap.timers;
         Deno.core.setMacrotaskCallback(handleTimerMacrotask);
-        "#.to_owned())),
+        "#.to_owned() + extra_src)),
       ),
     ])
     .state(|state| {
@@ -36,5 +52,33 @@ fn bench_set_timeout(b: &mut Bencher) {
   bench_js_async(b, r#"setTimeout(() => {}, 0);"#, setup);
 }
 
-benchmark_group!(benches, bench_op_now, bench_set_timeout,);
+fn bench_set_clear_timeout(b: &mut Bencher) {
+  bench_js_sync(
+    b,
+    r#"clearTimeout(setTimeout(() => {}, 30000 + i));"#,
+    setup_outstanding,
+  );
+}
+
+fn bench_set_clear_timeout_churn(b: &mut Bencher) {
+  // Clears the timer that was set 100 iterations earlier, so that the earliest
+  // timer keeps changing.
+  bench_js_sync(
+    b,
+    r#"
+    globalThis.churn ??= [];
+    churn.push(setTimeout(() => {}, 1000 + (i % 100)));
+    if (churn.length > 100) clearTimeout(churn.shift());
+    "#,
+    setup_outstanding,
+  );
+}
+
+benchmark_group!(
+  benches,
+  bench_op_now,
+  bench_set_timeout,
+  bench_set_clear_timeout,
+  bench_set_clear_timeout_churn,
+);
 bench_or_profile!(benches);
@@ -16,6 +16,7 @@ use deno_core::futures::TryFutureExt;
 use deno_core::include_js_files;
 use deno_core::op_async;
 use deno_core::op_sync;
+use deno_core::op_sync_fast;
 use deno_core::Extension;
 use deno_core::OpState;
 use std::cell::RefCell;
@@ -51,7 +52,7 @@ pub fn init<P: TimersPermission + 'static>() -> Extension {
       ("op_global_timer_stop", op_sync(op_global_timer_stop)),
       ("op_global_timer_start", op_sync(op_global_timer_start)),
       ("op_global_timer", op_async(op_global_timer)),
-      ("op_now", op_sync(op_now::<P>)),
+      ("op_now", op_sync_fast(op_now::<P>)),
       ("op_sleep_sync", op_sync(op_sleep_sync::<P>)),
     ])
     .state(|state| {
@@ -96,7 +96,25 @@
         context: "Argument 2",
       });
 
-      // TODO(lucacasonato): add fast path for non-streaming decoder & decode
+      if (ArrayBufferIsView(input)) {
+        input = new Uint8Array(
+          input.buffer,
+          input.byteOffset,
+          input.byteLength,
+        );
+      } else {
+        input = new Uint8Array(input);
+      }
+
+      // Fast path for one-shot, lenient UTF-8 decoding, which is what
+      // `core.decode` does: it strips the BOM and replaces invalid sequences
+      // without creating a decoder resource.
+      if (
+        this.#encoding === "utf-8" && !this.#fatal && !this.#ignoreBOM &&
+        !options.stream && this.#rid === null
+      ) {
+        return core.decode(input);
+      }
 
       if (this.#rid === null) {
         this.#rid = core.opSync("op_encoding_new_decoder", {
@@ -107,15 +125,6 @@
       }
 
       try {
-        if (ArrayBufferIsView(input)) {
-          input = new Uint8Array(
-            input.buffer,
-            input.byteOffset,
-            input.byteLength,
-          );
-        } else {
-          input = new Uint8Array(input);
-        }
         return core.opSync("op_encoding_decode", new Uint8Array(input), {
           rid: this.#rid,
           stream: options.stream,
@@ -170,8 +179,8 @@
     encodeInto(source, destination) {
       webidl.assertBranded(this, TextEncoder);
       const prefix = "Failed to execute 'encodeInto' on 'TextEncoder'";
-      // The WebIDL type of `source` is `USVString`, but the ops bindings
-      // already convert lone surrogates to the replacement character.
+      // The WebIDL type of `source` is `USVString`, but `core.encodeInto`
+      // already converts lone surrogates to the replacement character.
       source = webidl.converters.DOMString(source, {
         prefix,
         context: "Argument 1",
@@ -181,7 +190,7 @@
         context: "Argument 2",
         allowShared: true,
       });
-      return core.opSync("op_encoding_encode_into", source, destination);
+      return core.encodeInto(source, destination);
     }
 
     get [SymbolToStringTag]() {
@@ -111,7 +111,10 @@
         throw new DOMException("Can not tranfer self", "DataCloneError");
       }
       const data = serializeJsMessageData(message, transfer);
-      if (this[_id] === null) return;
+      if (this[_id] === null) {
+        core.close(data.data);
+        return;
+      }
       core.opSync("op_message_port_post_message", this[_id], data);
     }
 
@@ -181,6 +184,8 @@
   function deserializeJsMessageData(messageData) {
     /** @type {object[]} */
     const transferables = [];
+    /** @type {number[]} */
+    const transferredArrayBuffers = [];
 
     for (const transferable of messageData.transferables) {
       switch (transferable.kind) {
@@ -189,6 +194,10 @@
           transferables.push(port);
           break;
         }
+        case "arrayBuffer": {
+          transferredArrayBuffers.push(transferable.data);
+          break;
+        }
         default:
           throw new TypeError("Unreachable");
       }
@@ -196,44 +205,97 @@
 
     const data = core.deserialize(messageData.data, {
       hostObjects: transferables,
+      transferredArrayBuffers,
     });
 
     return [data, transferables];
   }
 
   /**
+   * @param {ArrayBuffer} buffer
+   * @returns {boolean}
+   */
+  function isDetached(buffer) {
+    if (buffer.byteLength !== 0) return false;
+    // Only a detached buffer can't be viewed.
+    try {
+      new Uint8Array(buffer);
+      return false;
+    } catch {
+      return true;
+    }
+  }
+
+  /**
+   * ArrayBuffers in the transfer list are detached and handed over to the
+   * receiving side without copying their contents. The serialized message is
+   * kept in a resource, which the op sending it takes.
    * @param {any} data
    * @param {object[]} tranferables
    * @returns {globalThis.__bootstrap.messagePort.MessageData}
    */
   function serializeJsMessageData(data, tranferables) {
-    let serializedData;
-    try {
-      serializedData = core.serialize(data, { hostObjects: tranferables });
-    } catch (err) {
-      throw new DOMException(err.message, "DataCloneError");
-    }
-
-    /** @type {globalThis.__bootstrap.messagePort.Transferable[]} */
-    const serializedTransferables = [];
+    /** @type {MessagePort[]} */
+    const hostObjects = [];
+    /** @type {(ArrayBuffer | number)[]} */
+    const transferredArrayBuffers = [];
 
     for (const transferable of tranferables) {
       if (transferable instanceof MessagePort) {
         webidl.assertBranded(transferable, MessagePort);
-        const id = transferable[_id];
-        if (id === null) {
+        hostObjects.push(transferable);
+      } else if (transferable instanceof ArrayBuffer) {
+        if (transferredArrayBuffers.includes(transferable)) {
           throw new DOMException(
-            "Can not transfer disentangled message port",
+            "ArrayBuffer is in the transfer list more than once",
             "DataCloneError",
           );
         }
-        transferable[_id] = null;
-        serializedTransferables.push({ kind: "messagePort", data: id });
+        if (isDetached(transferable)) {
+          throw new DOMException(
+            "Can not transfer detached ArrayBuffer",
+            "DataCloneError",
+          );
+        }
+        transferredArrayBuffers.push(transferable);
       } else {
         throw new DOMException("Value not transferable", "DataCloneError");
       }
     }
 
+    for (const port of hostObjects) {
+      if (port[_id] === null) {
+        throw new DOMException(
+          "Can not transfer disentangled message port",
+          "DataCloneError",
+        );
+      }
+    }
+
+    let serializedData;
+    try {
+      serializedData = core.serialize(data, {
+        hostObjects,
+        transferredArrayBuffers,
+        intoResource: true,
+      });
+    } catch (err) {
+      throw new DOMException(err.message, "DataCloneError");
+    }
+
+    /** @type {globalThis.__bootstrap.messagePort.Transferable[]} */
+    const serializedTransferables = [];
+
+    for (const port of hostObjects) {
+      serializedTransferables.push({ kind: "messagePort", data: port[_id] });
+      port[_id] = null;
+    }
+    // `core.serialize` replaced the ArrayBuffers with the ids of their
+    // backing stores.
+    for (const id of transferredArrayBuffers) {
+      serializedTransferables.push({ kind: "arrayBuffer", data: id });
+    }
+
     return {
       data: serializedData,
       transferables: serializedTransferables,
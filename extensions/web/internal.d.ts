@@ -86,11 +86,12 @@ declare namespace globalThis {
 
     declare namespace messagePort {
       declare type Transferable = {
-        kind: "messagePort";
+        kind: "messagePort" | "arrayBuffer";
         data: number;
       };
       declare interface MessageData {
-        data: Uint8Array;
+        /** The rid of the serialized message. */
+        data: number;
         transferables: Transferable[];
       }
     }
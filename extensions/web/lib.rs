@@ -21,7 +21,6 @@ use encoding_rs::Decoder;
 use encoding_rs::DecoderResult;
 use encoding_rs::Encoding;
 use serde::Deserialize;
-use serde::Serialize;
 use std::borrow::Cow;
 use std::cell::RefCell;
 use std::fmt;
@@ -76,7 +75,6 @@ pub fn init(blob_store: BlobStore, maybe_location: Option<Url>) -> Extension {
       ),
       ("op_encoding_new_decoder", op_sync(op_encoding_new_decoder)),
       ("op_encoding_decode", op_sync(op_encoding_decode)),
-      ("op_encoding_encode_into", op_sync(op_encoding_encode_into)),
       ("op_blob_create_part", op_sync(op_blob_create_part)),
       ("op_blob_slice_part", op_sync(op_blob_slice_part)),
       ("op_blob_read_part", op_async(op_blob_read_part)),
@@ -292,48 +290,6 @@ impl Resource for TextDecoderResource {
   }
 }
 
-#[derive(Serialize)]
-#[serde(rename_all = "camelCase")]
-struct EncodeIntoResult {
-  read: usize,
-  written: usize,
-}
-
-fn op_encoding_encode_into(
-  _state: &mut OpState,
-  input: String,
-  mut buffer: ZeroCopyBuf,
-) -> Result<EncodeIntoResult, AnyError> {
-  // Since `input` is already UTF-8, we can simply find the last UTF-8 code
-  // point boundary from input that fits in `buffer`, and copy the bytes up to
-  // that point.
-  let boundary = if buffer.len() >= input.len() {
-    input.len()
-  } else {
-    let mut boundary = buffer.len();
-
-    // The maximum length of a UTF-8 code point is 4 bytes.
-    for _ in 0..4 {
-      if input.is_char_boundary(boundary) {
-        break;
-      }
-      debug_assert!(boundary > 0);
-      boundary -= 1;
-    }
-
-    debug_assert!(input.is_char_boundary(boundary));
-    boundary
-  };
-
-  buffer[..boundary].copy_from_slice(input[..boundary].as_bytes());
-
-  Ok(EncodeIntoResult {
-    // The `read` output parameter is measured in UTF-16 code units.
-    read: input[..boundary].encode_utf16().count(),
-    written: boundary,
-  })
-}
-
 pub fn get_declaration() -> PathBuf {
   PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("lib.deno_web.d.ts")
 }
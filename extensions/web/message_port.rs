@@ -5,7 +5,7 @@ use std::rc::Rc;
 use deno_core::error::bad_resource_id;
 use deno_core::error::type_error;
 use deno_core::error::AnyError;
-use deno_core::ZeroCopyBuf;
+use deno_core::SerializedValue;
 use deno_core::{CancelFuture, Resource};
 use deno_core::{CancelHandle, OpState};
 use deno_core::{RcRef, ResourceId};
@@ -17,9 +17,15 @@ use tokio::sync::mpsc::UnboundedSender;
 
 enum Transferable {
   MessagePort(MessagePort),
+  /// The id of the backing store of a transferred ArrayBuffer in the
+  /// `SharedArrayBufferStore`. The `SerializedValue` of the message owns it.
+  ArrayBuffer(u32),
 }
 
-type MessagePortMessage = (Vec<u8>, Vec<Transferable>);
+// A message that is dropped without being received, for example because it
+// is still queued when the receiving port goes away, drops the ArrayBuffers
+// that were transferred with it along with its `SerializedValue`.
+type MessagePortMessage = (SerializedValue, Vec<Transferable>);
 
 pub struct MessagePort {
   rx: RefCell<UnboundedReceiver<MessagePortMessage>>,
@@ -32,13 +38,16 @@ impl MessagePort {
     state: &mut OpState,
     data: JsMessageData,
   ) -> Result<(), AnyError> {
+    // This is taken first, so that its transferred ArrayBuffers are dropped
+    // if anything below fails.
+    let value = SerializedValue::take(state, data.data)?;
     let transferables =
       deserialize_js_transferables(state, data.transferables)?;
 
     // Swallow the failed to send error. It means the channel was disentangled,
     // but not cleaned up.
     if let Some(tx) = &*self.tx.borrow() {
-      tx.send((data.data.to_vec(), transferables)).ok();
+      tx.send((value, transferables)).ok();
     }
 
     Ok(())
@@ -52,11 +61,12 @@ impl MessagePort {
       .rx
       .try_borrow_mut()
       .map_err(|_| type_error("Port receiver is already borrowed"))?;
-    if let Some((data, transferables)) = rx.recv().await {
-      let js_transferables =
-        serialize_transferables(&mut state.borrow_mut(), transferables);
+    if let Some((value, transferables)) = rx.recv().await {
+      let mut state = state.borrow_mut();
+      let js_transferables = serialize_transferables(&mut state, transferables);
+      let data = state.resource_table.add(value);
       return Ok(Some(JsMessageData {
-        data: ZeroCopyBuf::from(data),
+        data,
         transferables: js_transferables,
       }));
     }
@@ -128,6 +138,7 @@ pub fn op_message_port_create_entangled(
 pub enum JsTransferable {
   #[serde(rename_all = "camelCase")]
   MessagePort(ResourceId),
+  ArrayBuffer(u32),
 }
 
 fn deserialize_js_transferables(
@@ -147,6 +158,9 @@ fn deserialize_js_transferables(
           .map_err(|_| type_error("Message port is not ready for transfer"))?;
         transferables.push(Transferable::MessagePort(resource.port));
       }
+      JsTransferable::ArrayBuffer(id) => {
+        transferables.push(Transferable::ArrayBuffer(id));
+      }
     }
   }
   Ok(transferables)
@@ -166,6 +180,9 @@ fn serialize_transferables(
         });
         js_transferables.push(JsTransferable::MessagePort(rid));
       }
+      Transferable::ArrayBuffer(id) => {
+        js_transferables.push(JsTransferable::ArrayBuffer(id));
+      }
     }
   }
   js_transferables
@@ -173,7 +190,8 @@ fn serialize_transferables(
 
 #[derive(Deserialize, Serialize)]
 pub struct JsMessageData {
-  data: ZeroCopyBuf,
+  /// The id of the `SerializedValue` holding the message.
+  data: ResourceId,
   transferables: Vec<JsTransferable>,
 }
 
@@ -183,19 +201,21 @@ pub fn op_message_port_post_message(
   data: JsMessageData,
 ) -> Result<(), AnyError> {
   for js_transferable in &data.transferables {
-    match js_transferable {
-      JsTransferable::MessagePort(id) => {
-        if *id == rid {
-          return Err(type_error("Can not transfer self message port"));
-        }
+    if let JsTransferable::MessagePort(id) = js_transferable {
+      if *id == rid {
+        state.resource_table.close(data.data);
+        return Err(type_error("Can not transfer self message port"));
       }
     }
   }
 
-  let resource = state
-    .resource_table
-    .get::<MessagePortResource>(rid)
-    .ok_or_else(bad_resource_id)?;
+  let resource = match state.resource_table.get::<MessagePortResource>(rid) {
+    Some(resource) => resource,
+    None => {
+      state.resource_table.close(data.data);
+      return Err(bad_resource_id());
+    }
+  };
 
   resource.port.send(state, data)
 }
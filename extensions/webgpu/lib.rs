@@ -111,11 +111,12 @@ impl Resource for WebGpuQuerySet {
 pub fn init(unstable: bool) -> Extension {
   Extension::builder()
     .js(include_js_files!(
-      prefix "deno:extensions/webgpu",
+      embed prefix "deno:extensions/webgpu",
       "01_webgpu.js",
       "02_idl_types.js",
     ))
     .ops(declare_webgpu_ops())
+    .lazy("deno_webgpu")
     .state(move |state| {
       // TODO: check & possibly streamline this
       // Unstable might be able to be OpMiddleware
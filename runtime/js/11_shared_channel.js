@@ -0,0 +1,287 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+"use strict";
+
+((window) => {
+  const core = window.Deno.core;
+  const {
+    AtomicsAdd,
+    AtomicsCompareExchange,
+    AtomicsLoad,
+    AtomicsNotify,
+    AtomicsStore,
+    AtomicsWait,
+    DateNow,
+    Error,
+    Int32Array,
+    MathCeil,
+    MathMax,
+    MathMin,
+    NumberIsInteger,
+    RangeError,
+    SharedArrayBuffer,
+    TypedArrayPrototypeSet,
+    TypedArrayPrototypeSlice,
+    TypedArrayPrototypeSubarray,
+    TypeError,
+    Uint8Array,
+  } = window.__bootstrap.primordials;
+
+  // A shared channel is a ring buffer in a SharedArrayBuffer, preceded by a
+  // header of 32-bit words. Messages are written as a 32-bit length followed
+  // by the bytes of the message, padded to a multiple of 4, so lengths never
+  // wrap around the end of the ring. `HEAD` and `TAIL` count the bytes read
+  // and written so far and are allowed to overflow; their difference is the
+  // number of bytes in use. Senders take turns through `LOCK`. Every change of
+  // state increments `SIGNAL`, which is the only word that is waited on, so a
+  // change can't slip in between checking the state and waiting. `WAITING` is
+  // set while the receiver waits in `op_shared_channel_wait`, which
+  // `Atomics.notify()` doesn't wake, so changes of state notify it with
+  // `op_shared_channel_notify`.
+  const HEAD = 0;
+  const TAIL = 1;
+  const LOCK = 2;
+  const CLOSED = 3;
+  const SIGNAL = 4; // Keep in sync with `runtime/ops/shared_channel.rs`.
+  const WAITING = 5;
+  const HEADER_SIZE = 32;
+  const LENGTH_SIZE = 4;
+
+  const DEFAULT_CAPACITY = 64 * 1024;
+  const MIN_CAPACITY = 16;
+  const MAX_CAPACITY = 2 ** 30;
+
+  function align(length) {
+    return (length + 3) & ~3;
+  }
+
+  function deadlineFor(timeout) {
+    if (typeof timeout !== "number" || !(timeout >= 0)) {
+      throw new TypeError("Timeout must be a non-negative number");
+    }
+    return timeout === Infinity ? Infinity : DateNow() + timeout;
+  }
+
+  function remaining(deadline) {
+    return deadline === Infinity ? Infinity : MathMax(0, deadline - DateNow());
+  }
+
+  class SharedChannel {
+    #buffer;
+    #state;
+    #bytes;
+    #lengths;
+    #capacity;
+
+    constructor(capacityOrBuffer = DEFAULT_CAPACITY) {
+      const isBuffer = capacityOrBuffer instanceof SharedArrayBuffer;
+      const capacity = isBuffer
+        ? capacityOrBuffer.byteLength - HEADER_SIZE
+        : capacityOrBuffer;
+      if (
+        !NumberIsInteger(capacity) || capacity < MIN_CAPACITY ||
+        capacity > MAX_CAPACITY || (capacity & (capacity - 1)) !== 0
+      ) {
+        throw new RangeError(
+          `Shared channel capacity must be a power of two between ${MIN_CAPACITY} and ${MAX_CAPACITY}`,
+        );
+      }
+      this.#buffer = isBuffer
+        ? capacityOrBuffer
+        : new SharedArrayBuffer(HEADER_SIZE + capacity);
+      this.#state = new Int32Array(this.#buffer, 0, HEADER_SIZE / 4);
+      this.#bytes = new Uint8Array(this.#buffer, HEADER_SIZE, capacity);
+      this.#lengths = new Int32Array(this.#buffer, HEADER_SIZE, capacity / 4);
+      this.#capacity = capacity;
+    }
+
+    // The buffer to post to another worker to open the other end.
+    get buffer() {
+      return this.#buffer;
+    }
+
+    get capacity() {
+      return this.#capacity;
+    }
+
+    get closed() {
+      return AtomicsLoad(this.#state, CLOSED) === 1;
+    }
+
+    // Blocks until there is room for `data`, unless `timeout` milliseconds
+    // pass first, in which case it returns `false`.
+    send(data, timeout = Infinity) {
+      if (!(data instanceof Uint8Array)) {
+        throw new TypeError("Shared channel messages must be Uint8Arrays");
+      }
+      const size = LENGTH_SIZE + align(data.byteLength);
+      if (size > this.#capacity) {
+        throw new RangeError(
+          `Message of ${data.byteLength} bytes does not fit in a shared channel of ${this.#capacity} bytes`,
+        );
+      }
+      const deadline = deadlineFor(timeout);
+      const state = this.#state;
+
+      while (AtomicsCompareExchange(state, LOCK, 0, 1) !== 0) {
+        if (AtomicsWait(state, LOCK, 1, remaining(deadline)) === "timed-out") {
+          return false;
+        }
+      }
+      try {
+        const tail = AtomicsLoad(state, TAIL);
+        for (;;) {
+          const signal = AtomicsLoad(state, SIGNAL);
+          if (AtomicsLoad(state, CLOSED) === 1) {
+            throw new Error("Shared channel is closed");
+          }
+          const used = (tail - AtomicsLoad(state, HEAD)) | 0;
+          if (this.#capacity - used >= size) {
+            break;
+          }
+          const result = AtomicsWait(
+            state,
+            SIGNAL,
+            signal,
+            remaining(deadline),
+          );
+          if (result === "timed-out") {
+            return false;
+          }
+        }
+        const offset = tail & (this.#capacity - 1);
+        this.#lengths[offset / 4] = data.byteLength;
+        this.#write((offset + LENGTH_SIZE) & (this.#capacity - 1), data);
+        AtomicsStore(state, TAIL, (tail + size) | 0);
+        this.#signal();
+        return true;
+      } finally {
+        AtomicsStore(state, LOCK, 0);
+        AtomicsNotify(state, LOCK, 1);
+      }
+    }
+
+    trySend(data) {
+      return this.send(data, 0);
+    }
+
+    // Resolves with the next message, or with `null` when the channel is
+    // closed and drained or `timeout` milliseconds pass. The event loop keeps
+    // running while it waits. A channel has a single receiver at a time.
+    async recv(timeout = Infinity) {
+      const deadline = deadlineFor(timeout);
+      const state = this.#state;
+      for (;;) {
+        const signal = AtomicsLoad(state, SIGNAL);
+        const closed = AtomicsLoad(state, CLOSED) === 1;
+        const data = this.recvSync(0);
+        if (data !== null || closed) {
+          return data;
+        }
+        const wait = remaining(deadline);
+        if (wait === 0) {
+          return null;
+        }
+        AtomicsStore(state, WAITING, 1);
+        let changed;
+        try {
+          changed = await core.opAsync("op_shared_channel_wait", {
+            signal,
+            timeout: wait === Infinity ? null : MathCeil(wait),
+          }, state);
+        } finally {
+          AtomicsStore(state, WAITING, 0);
+        }
+        if (!changed) {
+          return null;
+        }
+      }
+    }
+
+    // Like `recv()`, but blocks the worker while it waits.
+    recvSync(timeout = Infinity) {
+      const deadline = deadlineFor(timeout);
+      const state = this.#state;
+      const head = AtomicsLoad(state, HEAD);
+      for (;;) {
+        const signal = AtomicsLoad(state, SIGNAL);
+        if (AtomicsLoad(state, TAIL) !== head) {
+          break;
+        }
+        if (AtomicsLoad(state, CLOSED) === 1) {
+          return null;
+        }
+        const result = AtomicsWait(state, SIGNAL, signal, remaining(deadline));
+        if (result === "timed-out") {
+          return null;
+        }
+      }
+      const offset = head & (this.#capacity - 1);
+      const length = this.#lengths[offset / 4];
+      const data = this.#read(
+        (offset + LENGTH_SIZE) & (this.#capacity - 1),
+        length,
+      );
+      AtomicsStore(state, HEAD, (head + LENGTH_SIZE + align(length)) | 0);
+      this.#signal();
+      return data;
+    }
+
+    tryRecv() {
+      return this.recvSync(0);
+    }
+
+    // Closes the channel for both ends. Blocked senders throw, and the
+    // receiver gets the messages that were already sent, then `null`.
+    close() {
+      AtomicsStore(this.#state, CLOSED, 1);
+      this.#signal();
+    }
+
+    #signal() {
+      AtomicsAdd(this.#state, SIGNAL, 1);
+      AtomicsNotify(this.#state, SIGNAL);
+      if (AtomicsLoad(this.#state, WAITING) === 1) {
+        core.opSync("op_shared_channel_notify", null, this.#state);
+      }
+    }
+
+    #write(offset, data) {
+      const first = MathMin(data.byteLength, this.#capacity - offset);
+      TypedArrayPrototypeSet(
+        this.#bytes,
+        TypedArrayPrototypeSubarray(data, 0, first),
+        offset,
+      );
+      if (first < data.byteLength) {
+        TypedArrayPrototypeSet(
+          this.#bytes,
+          TypedArrayPrototypeSubarray(data, first),
+          0,
+        );
+      }
+    }
+
+    #read(offset, length) {
+      const first = MathMin(length, this.#capacity - offset);
+      if (first === length) {
+        return TypedArrayPrototypeSlice(this.#bytes, offset, offset + length);
+      }
+      const data = new Uint8Array(length);
+      TypedArrayPrototypeSet(
+        data,
+        TypedArrayPrototypeSubarray(this.#bytes, offset, offset + first),
+        0,
+      );
+      TypedArrayPrototypeSet(
+        data,
+        TypedArrayPrototypeSubarray(this.#bytes, 0, length - first),
+        first,
+      );
+      return data;
+    }
+  }
+
+  window.__bootstrap.sharedChannel = {
+    SharedChannel,
+  };
+})(this);
@@ -5,12 +5,20 @@
   const core = window.Deno.core;
   const {
     ArrayIsArray,
+    ArrayPrototypeIndexOf,
     ArrayPrototypeMap,
+    ArrayPrototypePush,
+    ArrayPrototypeShift,
+    ArrayPrototypeSplice,
     Error,
+    NumberIsInteger,
+    Promise,
+    PromiseReject,
     Uint8Array,
     StringPrototypeStartsWith,
     String,
     SymbolIterator,
+    TypeError,
   } = window.__bootstrap.primordials;
   const webidl = window.__bootstrap.webidl;
   const { URL } = window.__bootstrap.url;
@@ -315,7 +323,10 @@
       }
       const { transfer } = options;
       const data = serializeJsMessageData(message, transfer);
-      if (this.#terminated) return;
+      if (this.#terminated) {
+        core.close(data.data);
+        return;
+      }
       hostPostMessage(this.#id, data);
     }
 
@@ -331,8 +342,152 @@
   defineEventHandler(Worker.prototype, "message");
   defineEventHandler(Worker.prototype, "messageerror");
 
+  const DEFAULT_WORKER_POOL_SIZE = 4;
+
+  /**
+   * A fixed number of workers that run the same module and are reused across
+   * tasks, so the cost of creating a worker is only paid once per worker. A
+   * task is a message posted to an idle worker, and its result is the data of
+   * the next message that worker posts back.
+   */
+  class WorkerPool {
+    #specifier = "";
+    #options = {};
+    #size = 0;
+    #workers = [];
+    #idle = [];
+    #queue = [];
+    #terminated = false;
+
+    constructor(specifier, options = {}) {
+      const { size = DEFAULT_WORKER_POOL_SIZE, ...workerOptions } = options;
+      if (!NumberIsInteger(size) || size < 1) {
+        throw new TypeError("Worker pool size must be a positive integer");
+      }
+      this.#specifier = String(specifier);
+      this.#options = workerOptions;
+      this.#size = size;
+      // The workers are created upfront, so they are bootstrapped and have
+      // loaded their module by the time the first tasks are run.
+      for (let i = 0; i < size; i++) {
+        this.#spawn();
+      }
+    }
+
+    get size() {
+      return this.#size;
+    }
+
+    #spawn() {
+      const entry = {
+        worker: new Worker(this.#specifier, this.#options),
+        task: null,
+        completed: 0,
+      };
+      entry.worker.addEventListener("message", (event) => {
+        this.#finish(entry)?.resolve(event.data);
+      });
+      entry.worker.addEventListener("messageerror", (event) => {
+        this.#finish(entry)?.reject(event.data);
+      });
+      entry.worker.addEventListener("error", (event) => {
+        event.preventDefault();
+        this.#fail(entry, new Error(event.message));
+      });
+      ArrayPrototypePush(this.#workers, entry);
+      ArrayPrototypePush(this.#idle, entry);
+    }
+
+    #finish(entry) {
+      const task = entry.task;
+      if (task === null) {
+        // Messages that aren't a response to a task are ignored.
+        return null;
+      }
+      entry.task = null;
+      entry.completed++;
+      ArrayPrototypePush(this.#idle, entry);
+      this.#dispatch();
+      return task;
+    }
+
+    // A worker that threw is discarded. It is replaced unless it threw before
+    // it was ever given a task, which means its module fails to load, so that
+    // such a module doesn't make the pool spawn workers forever.
+    #fail(entry, error) {
+      const workerIndex = ArrayPrototypeIndexOf(this.#workers, entry);
+      if (workerIndex === -1) {
+        // The pool was terminated.
+        return;
+      }
+      ArrayPrototypeSplice(this.#workers, workerIndex, 1);
+      const index = ArrayPrototypeIndexOf(this.#idle, entry);
+      if (index !== -1) {
+        ArrayPrototypeSplice(this.#idle, index, 1);
+      }
+      entry.worker.terminate();
+      const task = entry.task;
+      entry.task = null;
+      task?.reject(error);
+
+      if (task !== null || entry.completed > 0) {
+        this.#spawn();
+        this.#dispatch();
+      } else if (this.#workers.length === 0) {
+        while (this.#queue.length > 0) {
+          ArrayPrototypeShift(this.#queue).reject(error);
+        }
+      }
+    }
+
+    #dispatch() {
+      while (this.#idle.length > 0 && this.#queue.length > 0) {
+        const entry = ArrayPrototypeShift(this.#idle);
+        const task = ArrayPrototypeShift(this.#queue);
+        try {
+          entry.worker.postMessage(task.message, task.transfer);
+          entry.task = task;
+        } catch (err) {
+          ArrayPrototypePush(this.#idle, entry);
+          task.reject(err);
+        }
+      }
+    }
+
+    run(message, transfer = []) {
+      if (this.#terminated) {
+        return PromiseReject(new TypeError("Worker pool is terminated"));
+      }
+      if (this.#workers.length === 0) {
+        return PromiseReject(new Error("All workers of the pool have failed"));
+      }
+      return new Promise((resolve, reject) => {
+        ArrayPrototypePush(this.#queue, { message, transfer, resolve, reject });
+        this.#dispatch();
+      });
+    }
+
+    terminate() {
+      if (this.#terminated) {
+        return;
+      }
+      this.#terminated = true;
+      const error = new Error("Worker pool was terminated");
+      for (const entry of this.#workers) {
+        entry.worker.terminate();
+        entry.task?.reject(error);
+      }
+      while (this.#queue.length > 0) {
+        ArrayPrototypeShift(this.#queue).reject(error);
+      }
+      this.#workers = [];
+      this.#idle = [];
+    }
+  }
+
   window.__bootstrap.worker = {
     parsePermissions,
     Worker,
+    WorkerPool,
   };
 })(this);
@@ -28,11 +28,29 @@
     End: 2,
   };
 
+  // Whether `src` is a file and `dst` a file, stdio or a connection, using
+  // their own `read` and `write`, so that `op_copy_from_file` can copy between
+  // them without the data going through JS.
+  function isFileCopy(src, dst) {
+    const { File, stdout, stderr } = window.__bootstrap.files;
+    const { Conn } = window.__bootstrap.net;
+    if (src.read !== File.prototype.read) {
+      return false;
+    }
+    return dst.write === File.prototype.write ||
+      dst.write === Conn.prototype.write ||
+      dst.write === stdout.write ||
+      dst.write === stderr.write;
+  }
+
   async function copy(
     src,
     dst,
     options,
   ) {
+    if (isFileCopy(src, dst)) {
+      return await core.opAsync("op_copy_from_file", src.rid, dst.rid);
+    }
     let n = 0;
     const bufSize = options?.bufSize ?? DEFAULT_BUFFER_SIZE;
     const b = new Uint8Array(bufSize);
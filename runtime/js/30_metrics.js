@@ -4,11 +4,20 @@
 ((window) => {
   const core = window.Deno.core;
 
-  function metrics() {
-    const { combined, ops } = core.opSync("op_metrics");
+  function metrics({ perOp = false } = {}) {
+    const { combined, ops, perOp: histograms, eventLoop } = core.opSync(
+      "op_metrics",
+      perOp,
+    );
     if (ops) {
       combined.ops = ops;
     }
+    if (eventLoop) {
+      combined.eventLoop = eventLoop;
+    }
+    if (histograms) {
+      combined.perOp = histograms;
+    }
     return combined;
   }
 
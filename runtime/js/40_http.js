@@ -5,9 +5,9 @@
   const core = window.__bootstrap.core;
   const { HttpConn } = window.__bootstrap.http;
 
-  function serveHttp(conn) {
+  function serveHttp(conn, options = {}) {
     const rid = core.opSync("op_http_start", conn.rid);
-    return new HttpConn(rid);
+    return new HttpConn(rid, options);
   }
 
   window.__bootstrap.http.serveHttp = serveHttp;
@@ -3,20 +3,20 @@
 
 ((window) => {
   const core = window.Deno.core;
-  const { open, openSync } = window.__bootstrap.files;
-  const { readAllInner, readAllSync } = window.__bootstrap.io;
+  const { open } = window.__bootstrap.files;
+  const { readAllInner } = window.__bootstrap.io;
+  const { pathFromURL } = window.__bootstrap.util;
 
   function readFileSync(path) {
-    const file = openSync(path);
-    try {
-      const contents = readAllSync(file);
-      return contents;
-    } finally {
-      file.close();
-    }
+    return core.opSync("op_read_file_sync", pathFromURL(path));
   }
 
+  // A read that can be aborted goes through the file in chunks, so it can
+  // stop between them. Otherwise the whole file is read by a single op.
   async function readFile(path, options) {
+    if (!options?.signal) {
+      return await core.opAsync("op_read_file_async", pathFromURL(path));
+    }
     const file = await open(path);
     try {
       const contents = await readAllInner(file, options);
@@ -27,16 +27,13 @@
   }
 
   function readTextFileSync(path) {
-    const file = openSync(path);
-    try {
-      const contents = readAllSync(file);
-      return core.decode(contents);
-    } finally {
-      file.close();
-    }
+    return core.opSync("op_read_text_file_sync", pathFromURL(path));
   }
 
   async function readTextFile(path, options) {
+    if (!options?.signal) {
+      return await core.opAsync("op_read_text_file_async", pathFromURL(path));
+    }
     const file = await open(path);
     try {
       const contents = await readAllInner(file, options);
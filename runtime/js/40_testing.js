@@ -11,6 +11,7 @@
   const {
     ArrayPrototypeFilter,
     ArrayPrototypePush,
+    ArrayPrototypeSplice,
     DateNow,
     JSONStringify,
     Promise,
@@ -227,10 +228,22 @@ finishing test case.`;
     return core.opSync("op_dispatch_test_event", event);
   }
 
+  function startTestQueue(queue, total) {
+    return core.opSync("op_start_test_queue", queue, total);
+  }
+
+  function nextTest(queue) {
+    return core.opSync("op_next_test", queue);
+  }
+
+  // Runs the tests registered since the last call. With `queue`, the test
+  // module is shared with other workers that loaded it as well, and its tests
+  // are taken from a queue, so each of them runs only once.
   async function runTests({
     disableLog = false,
     filter = null,
     shuffle = null,
+    queue = null,
   } = {}) {
     const origin = getTestOrigin();
     const originalConsole = globalThis.console;
@@ -238,20 +251,23 @@ finishing test case.`;
       globalThis.console = new Console(() => {});
     }
 
-    const only = ArrayPrototypeFilter(tests, (test) => test.only);
+    const registered = ArrayPrototypeSplice(tests, 0, tests.length);
+    const only = ArrayPrototypeFilter(registered, (test) => test.only);
     const filtered = ArrayPrototypeFilter(
-      (only.length > 0 ? only : tests),
+      (only.length > 0 ? only : registered),
       createTestFilter(filter),
     );
 
-    dispatchTestEvent({
-      plan: {
-        origin,
-        total: filtered.length,
-        filteredOut: tests.length - filtered.length,
-        usedOnly: only.length > 0,
-      },
-    });
+    if (queue === null || startTestQueue(queue, filtered.length)) {
+      dispatchTestEvent({
+        plan: {
+          origin,
+          total: filtered.length,
+          filteredOut: registered.length - filtered.length,
+          usedOnly: only.length > 0,
+        },
+      });
+    }
 
     if (shuffle !== null) {
       // http://en.wikipedia.org/wiki/Linear_congruential_generator
@@ -271,7 +287,13 @@ finishing test case.`;
       }
     }
 
-    for (const test of filtered) {
+    for (let i = 0; i < filtered.length; i++) {
+      const index = queue === null ? i : nextTest(queue);
+      if (index === null) {
+        break;
+      }
+
+      const test = filtered[index];
       const description = {
         origin,
         name: test.name,
@@ -116,6 +116,8 @@
     DiagnosticCategory: __bootstrap.diagnostics.DiagnosticCategory,
     loadavg: __bootstrap.os.loadavg,
     hostname: __bootstrap.os.hostname,
+    WorkerPool: __bootstrap.worker.WorkerPool,
+    SharedChannel: __bootstrap.sharedChannel.SharedChannel,
     osRelease: __bootstrap.os.osRelease,
     systemMemoryInfo: __bootstrap.os.systemMemoryInfo,
     systemCpuInfo: __bootstrap.os.systemCpuInfo,
@@ -15,6 +15,7 @@ delete Object.prototype.__proto__;
     ObjectDefineProperty,
     ObjectDefineProperties,
     ObjectFreeze,
+    ObjectGetOwnPropertyDescriptor,
     ObjectSetPrototypeOf,
     PromiseResolve,
     Symbol,
@@ -43,7 +44,6 @@ delete Object.prototype.__proto__;
   const headers = window.__bootstrap.headers;
   const streams = window.__bootstrap.streams;
   const fileReader = window.__bootstrap.fileReader;
-  const webgpu = window.__bootstrap.webgpu;
   const webSocket = window.__bootstrap.webSocket;
   const webStorage = window.__bootstrap.webStorage;
   const broadcastChannel = window.__bootstrap.broadcastChannel;
@@ -235,6 +235,71 @@ delete Object.prototype.__proto__;
     );
   }
 
+  // The bootstrapping namespace is removed from the global scope when the
+  // runtime is bootstrapped, but the JS of lazy extensions still expects it.
+  const bootstrapNs = window.__bootstrap;
+
+  /**
+   * Loads the lazy extension `name` if `bootstrapNs[key]`, the namespace it
+   * defines, doesn't exist yet, and returns that namespace.
+   */
+  function loadLazyExtension(name, key) {
+    if (bootstrapNs[key] !== undefined || !hasBootstrapped) {
+      core.loadExtension(name);
+      return bootstrapNs[key];
+    }
+
+    const denoDescriptor = ObjectGetOwnPropertyDescriptor(globalThis, "Deno");
+    const replaceDeno = denoDescriptor === undefined ||
+      denoDescriptor.configurable;
+    if (replaceDeno) {
+      ObjectDefineProperty(globalThis, "Deno", {
+        value: { core },
+        configurable: true,
+      });
+    }
+    ObjectDefineProperty(globalThis, "__bootstrap", {
+      value: bootstrapNs,
+      configurable: true,
+    });
+    try {
+      core.loadExtension(name);
+    } finally {
+      delete globalThis.__bootstrap;
+      if (replaceDeno) {
+        if (denoDescriptor === undefined) {
+          delete globalThis.Deno;
+        } else {
+          ObjectDefineProperty(globalThis, "Deno", denoDescriptor);
+        }
+      }
+    }
+    return bootstrapNs[key];
+  }
+
+  function webgpu() {
+    return loadLazyExtension("deno_webgpu", "webgpu");
+  }
+
+  /**
+   * Like `util.nonEnumerable(webgpu()[name])`, but WebGPU is only loaded when
+   * the global is first accessed.
+   */
+  function webgpuInterface(name) {
+    return {
+      get() {
+        const value = webgpu()[name];
+        ObjectDefineProperty(globalThis, name, util.nonEnumerable(value));
+        return value;
+      },
+      set(value) {
+        ObjectDefineProperty(globalThis, name, util.nonEnumerable(value));
+      },
+      enumerable: false,
+      configurable: true,
+    };
+  }
+
   class Navigator {
     constructor() {
       webidl.illegalConstructor();
@@ -253,7 +318,7 @@ delete Object.prototype.__proto__;
       enumerable: true,
       get() {
         webidl.assertBranded(this, Navigator);
-        return webgpu.gpu;
+        return webgpu().gpu;
       },
     },
   });
@@ -276,7 +341,7 @@ delete Object.prototype.__proto__;
       enumerable: true,
       get() {
         webidl.assertBranded(this, WorkerNavigator);
-        return webgpu.gpu;
+        return webgpu().gpu;
       },
     },
   });
@@ -356,36 +421,36 @@ delete Object.prototype.__proto__;
     setInterval: util.writable(timers.setInterval),
     setTimeout: util.writable(timers.setTimeout),
 
-    GPU: util.nonEnumerable(webgpu.GPU),
-    GPUAdapter: util.nonEnumerable(webgpu.GPUAdapter),
-    GPUSupportedLimits: util.nonEnumerable(webgpu.GPUSupportedLimits),
-    GPUSupportedFeatures: util.nonEnumerable(webgpu.GPUSupportedFeatures),
-    GPUDevice: util.nonEnumerable(webgpu.GPUDevice),
-    GPUQueue: util.nonEnumerable(webgpu.GPUQueue),
-    GPUBuffer: util.nonEnumerable(webgpu.GPUBuffer),
-    GPUBufferUsage: util.nonEnumerable(webgpu.GPUBufferUsage),
-    GPUMapMode: util.nonEnumerable(webgpu.GPUMapMode),
-    GPUTexture: util.nonEnumerable(webgpu.GPUTexture),
-    GPUTextureUsage: util.nonEnumerable(webgpu.GPUTextureUsage),
-    GPUTextureView: util.nonEnumerable(webgpu.GPUTextureView),
-    GPUSampler: util.nonEnumerable(webgpu.GPUSampler),
-    GPUBindGroupLayout: util.nonEnumerable(webgpu.GPUBindGroupLayout),
-    GPUPipelineLayout: util.nonEnumerable(webgpu.GPUPipelineLayout),
-    GPUBindGroup: util.nonEnumerable(webgpu.GPUBindGroup),
-    GPUShaderModule: util.nonEnumerable(webgpu.GPUShaderModule),
-    GPUShaderStage: util.nonEnumerable(webgpu.GPUShaderStage),
-    GPUComputePipeline: util.nonEnumerable(webgpu.GPUComputePipeline),
-    GPURenderPipeline: util.nonEnumerable(webgpu.GPURenderPipeline),
-    GPUColorWrite: util.nonEnumerable(webgpu.GPUColorWrite),
-    GPUCommandEncoder: util.nonEnumerable(webgpu.GPUCommandEncoder),
-    GPURenderPassEncoder: util.nonEnumerable(webgpu.GPURenderPassEncoder),
-    GPUComputePassEncoder: util.nonEnumerable(webgpu.GPUComputePassEncoder),
-    GPUCommandBuffer: util.nonEnumerable(webgpu.GPUCommandBuffer),
-    GPURenderBundleEncoder: util.nonEnumerable(webgpu.GPURenderBundleEncoder),
-    GPURenderBundle: util.nonEnumerable(webgpu.GPURenderBundle),
-    GPUQuerySet: util.nonEnumerable(webgpu.GPUQuerySet),
-    GPUOutOfMemoryError: util.nonEnumerable(webgpu.GPUOutOfMemoryError),
-    GPUValidationError: util.nonEnumerable(webgpu.GPUValidationError),
+    GPU: webgpuInterface("GPU"),
+    GPUAdapter: webgpuInterface("GPUAdapter"),
+    GPUSupportedLimits: webgpuInterface("GPUSupportedLimits"),
+    GPUSupportedFeatures: webgpuInterface("GPUSupportedFeatures"),
+    GPUDevice: webgpuInterface("GPUDevice"),
+    GPUQueue: webgpuInterface("GPUQueue"),
+    GPUBuffer: webgpuInterface("GPUBuffer"),
+    GPUBufferUsage: webgpuInterface("GPUBufferUsage"),
+    GPUMapMode: webgpuInterface("GPUMapMode"),
+    GPUTexture: webgpuInterface("GPUTexture"),
+    GPUTextureUsage: webgpuInterface("GPUTextureUsage"),
+    GPUTextureView: webgpuInterface("GPUTextureView"),
+    GPUSampler: webgpuInterface("GPUSampler"),
+    GPUBindGroupLayout: webgpuInterface("GPUBindGroupLayout"),
+    GPUPipelineLayout: webgpuInterface("GPUPipelineLayout"),
+    GPUBindGroup: webgpuInterface("GPUBindGroup"),
+    GPUShaderModule: webgpuInterface("GPUShaderModule"),
+    GPUShaderStage: webgpuInterface("GPUShaderStage"),
+    GPUComputePipeline: webgpuInterface("GPUComputePipeline"),
+    GPURenderPipeline: webgpuInterface("GPURenderPipeline"),
+    GPUColorWrite: webgpuInterface("GPUColorWrite"),
+    GPUCommandEncoder: webgpuInterface("GPUCommandEncoder"),
+    GPURenderPassEncoder: webgpuInterface("GPURenderPassEncoder"),
+    GPUComputePassEncoder: webgpuInterface("GPUComputePassEncoder"),
+    GPUCommandBuffer: webgpuInterface("GPUCommandBuffer"),
+    GPURenderBundleEncoder: webgpuInterface("GPURenderBundleEncoder"),
+    GPURenderBundle: webgpuInterface("GPURenderBundle"),
+    GPUQuerySet: webgpuInterface("GPUQuerySet"),
+    GPUOutOfMemoryError: webgpuInterface("GPUOutOfMemoryError"),
+    GPUValidationError: webgpuInterface("GPUValidationError"),
   };
 
   // The console seems to be the only one that should be writable and non-enumerable
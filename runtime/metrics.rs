@@ -1,12 +1,18 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+use crate::ops::check_unstable;
 use crate::ops::UnstableChecker;
 use deno_core::error::AnyError;
 use deno_core::op_sync;
 use deno_core::serde::Serialize;
 use deno_core::serde_json::json;
 use deno_core::serde_json::Value;
+use deno_core::EventLoopTurn;
 use deno_core::Extension;
+use deno_core::JsRuntime;
 use deno_core::OpState;
+use std::cell::Cell;
+use std::time::Duration;
+use std::time::Instant;
 
 pub fn init() -> Extension {
   Extension::builder()
@@ -19,36 +25,106 @@ pub fn init() -> Extension {
     .build()
 }
 
+thread_local! {
+  /// Whether per-op histograms are being recorded. Kept outside of `OpState`
+  /// so that `metrics_op` can check it before dispatching an op without
+  /// borrowing the state; each isolate runs on its own thread. It is set by
+  /// the first `Deno.metrics({ perOp: true })` call and never turns off, so
+  /// the histograms keep covering every op from then on.
+  static PER_OP_ENABLED: Cell<bool> = Cell::new(false);
+}
+
 #[derive(serde::Serialize)]
+#[serde(rename_all = "camelCase")]
 struct MetricsReturn {
   combined: OpMetrics,
   ops: Value,
+  per_op: Value,
+  event_loop: Value,
 }
 
 fn op_metrics(
   state: &mut OpState,
-  _args: (),
+  per_op: Option<bool>,
   _: (),
 ) -> Result<MetricsReturn, AnyError> {
+  let unstable = state.borrow::<UnstableChecker>().unstable;
+  let per_op = per_op.unwrap_or(false);
+  if per_op {
+    check_unstable(state, "Deno.metrics({ perOp: true })");
+    PER_OP_ENABLED.with(|enabled| enabled.set(true));
+  }
   let m = state.borrow::<RuntimeMetrics>();
   let combined = m.combined_metrics();
-  let unstable_checker = state.borrow::<UnstableChecker>();
-  let maybe_ops = if unstable_checker.unstable {
-    Some(&m.ops)
-  } else {
-    None
-  };
+  let maybe_ops = if unstable { Some(&m.ops) } else { None };
+  let maybe_per_op = if per_op { Some(&m.per_op) } else { None };
+  let maybe_event_loop = if unstable { Some(&m.event_loop) } else { None };
   Ok(MetricsReturn {
     combined,
     ops: json!(maybe_ops),
+    per_op: json!(maybe_per_op),
+    event_loop: json!(maybe_event_loop),
   })
 }
+
+/// Records the timings of every turn of `js_runtime`'s event loop in its
+/// `RuntimeMetrics`.
+pub fn observe_event_loop(js_runtime: &mut JsRuntime) {
+  let op_state = js_runtime.op_state();
+  js_runtime.set_event_loop_observer(Box::new(move |turn| {
+    let mut state = op_state.borrow_mut();
+    state.borrow_mut::<RuntimeMetrics>().event_loop.record(turn);
+  }));
+}
+
 #[derive(Default, Debug)]
 pub struct RuntimeMetrics {
   pub ops: HashMap<&'static str, OpMetrics>,
+  /// Only recorded once per-op metrics have been requested, see
+  /// `op_metrics`.
+  pub per_op: HashMap<&'static str, OpHistograms>,
+  pub event_loop: EventLoopMetrics,
 }
 
 impl RuntimeMetrics {
+  fn op_metrics(&mut self, name: &'static str) -> &mut OpMetrics {
+    self.ops.entry(name).or_default()
+  }
+
+  /// `maybe_start` is when the op was dispatched, if per-op histograms were
+  /// being recorded then.
+  fn op_completed_async(
+    &mut self,
+    name: &'static str,
+    maybe_start: Option<Instant>,
+  ) {
+    self.ops.get_mut(name).unwrap().op_completed_async(0);
+    if let Some(start) = maybe_start {
+      self.record_async_time(name, start);
+    }
+  }
+
+  fn op_completed_async_unref(
+    &mut self,
+    name: &'static str,
+    maybe_start: Option<Instant>,
+  ) {
+    self.ops.get_mut(name).unwrap().op_completed_async_unref(0);
+    if let Some(start) = maybe_start {
+      self.record_async_time(name, start);
+    }
+  }
+
+  fn record_async_time(&mut self, name: &'static str, start: Instant) {
+    let elapsed = start.elapsed().as_nanos() as u64;
+    self
+      .per_op
+      .entry(name)
+      .or_default()
+      .async_time
+      .record(elapsed);
+  }
+
   pub fn combined_metrics(&self) -> OpMetrics {
     let mut total = OpMetrics::default();
 
@@ -143,6 +219,181 @@ impl OpMetrics {
   }
 }
 
+/// Where the event loop spends its time. Times are in nanoseconds.
+#[derive(Default, Debug, Serialize)]
+#[serde(rename_all = "camelCase")]
+pub struct EventLoopMetrics {
+  pub turns: u64,
+  /// The duration of each turn, which is how long anything that becomes
+  /// ready during a turn waits before the loop gets to it.
+  pub lag: Histogram,
+  /// The total time spent in each phase of the turns.
+  pub phases: EventLoopPhases,
+  /// The number of async op completions delivered to JS per turn, for the
+  /// turns that delivered any.
+  pub ops_per_turn: Histogram,
+  /// The number of turns that left completions for later because they ran
+  /// out of op budget. If this is high, the budget is too small to keep up;
+  /// if it is zero and `lag` is high, it may be too large.
+  pub op_budget_exhausted_turns: u64,
+}
+
+#[derive(Default, Debug, Serialize)]
+#[serde(rename_all = "camelCase")]
+pub struct EventLoopPhases {
+  pub v8_message_loop: u64,
+  pub poll_ops: u64,
+  pub op_responses: u64,
+  pub macrotasks: u64,
+  pub promise_exceptions: u64,
+  pub dyn_imports: u64,
+  pub module_evaluation: u64,
+}
+
+impl EventLoopMetrics {
+  fn record(&mut self, turn: &EventLoopTurn) {
+    fn nanos(duration: Duration) -> u64 {
+      duration.as_nanos() as u64
+    }
+    self.turns += 1;
+    self.lag.record(nanos(turn.total));
+    if turn.ops_completed > 0 {
+      self.ops_per_turn.record(turn.ops_completed as u64);
+    }
+    if turn.op_budget_exhausted {
+      self.op_budget_exhausted_turns += 1;
+    }
+    let phases = &mut self.phases;
+    phases.v8_message_loop += nanos(turn.v8_message_loop);
+    phases.poll_ops += nanos(turn.poll_ops);
+    phases.op_responses += nanos(turn.op_responses);
+    phases.macrotasks += nanos(turn.macrotasks);
+    phases.promise_exceptions += nanos(turn.promise_exceptions);
+    phases.dyn_imports += nanos(turn.dyn_imports);
+    phases.module_evaluation += nanos(turn.module_evaluation);
+  }
+}
+
+/// Latency and size distributions of a single op. Times are in nanoseconds.
+#[derive(Default, Debug, Serialize)]
+#[serde(rename_all = "camelCase")]
+pub struct OpHistograms {
+  pub sync_time: Histogram,
+  pub async_time: Histogram,
+  pub bytes_sent: Histogram,
+}
+
+/// A histogram with HDR-style logarithmic buckets: values are grouped by their
+/// power of two, and each power of two is split into `SUB_BUCKETS` linear
+/// sub-buckets, so any recorded value is off by less than 1 / `SUB_BUCKETS`.
+#[derive(Default, Debug, Clone)]
+pub struct Histogram {
+  counts: Vec<u64>,
+  count: u64,
+  sum: u64,
+  min: u64,
+  max: u64,
+}
+
+const SUB_BUCKET_BITS: u32 = 3;
+const SUB_BUCKETS: u64 = 1 << SUB_BUCKET_BITS;
+
+impl Histogram {
+  pub fn record(&mut self, value: u64) {
+    let index = Self::bucket_index(value);
+    if index >= self.counts.len() {
+      self.counts.resize(index + 1, 0);
+    }
+    self.counts[index] += 1;
+    if self.count == 0 || value < self.min {
+      self.min = value;
+    }
+    self.max = self.max.max(value);
+    self.count += 1;
+    self.sum = self.sum.saturating_add(value);
+  }
+
+  /// Returns the lower bound of the bucket that holds the `quantile` (between
+  /// 0 and 1) of the recorded values.
+  pub fn value_at_quantile(&self, quantile: f64) -> u64 {
+    let rank = ((self.count as f64) * quantile).ceil().max(1.0) as u64;
+    let mut seen = 0;
+    for (index, count) in self.counts.iter().enumerate() {
+      seen += count;
+      if seen >= rank {
+        return Self::bucket_lower_bound(index).max(self.min);
+      }
+    }
+    self.max
+  }
+
+  fn bucket_index(value: u64) -> usize {
+    if value < SUB_BUCKETS {
+      return value as usize;
+    }
+    let magnitude = 63 - value.leading_zeros();
+    let shift = magnitude - SUB_BUCKET_BITS;
+    let sub_bucket = (value >> shift) & (SUB_BUCKETS - 1);
+    ((shift + 1) as u64 * SUB_BUCKETS + sub_bucket) as usize
+  }
+
+  fn bucket_lower_bound(index: usize) -> u64 {
+    let index = index as u64;
+    if index < SUB_BUCKETS {
+      return index;
+    }
+    let shift = index / SUB_BUCKETS - 1;
+    let sub_bucket = index % SUB_BUCKETS;
+    (SUB_BUCKETS + sub_bucket) << shift
+  }
+}
+
+impl Serialize for Histogram {
+  fn serialize<S>(&self, serializer: S) -> Result<S::Ok, S::Error>
+  where
+    S: deno_core::serde::Serializer,
+  {
+    #[derive(Serialize)]
+    struct HistogramSummary {
+      count: u64,
+      min: u64,
+      max: u64,
+      mean: f64,
+      p50: u64,
+      p90: u64,
+      p99: u64,
+      p999: u64,
+      /// Non-empty buckets as `[lowerBound, count]` pairs.
+      buckets: Vec<(u64, u64)>,
+    }
+
+    let mean = if self.count == 0 {
+      0.0
+    } else {
+      self.sum as f64 / self.count as f64
+    };
+    let buckets = self
+      .counts
+      .iter()
+      .enumerate()
+      .filter(|(_, count)| **count > 0)
+      .map(|(index, count)| (Self::bucket_lower_bound(index), *count))
+      .collect();
+    HistogramSummary {
+      count: self.count,
+      min: self.min,
+      max: self.max,
+      mean,
+      p50: self.value_at_quantile(0.5),
+      p90: self.value_at_quantile(0.9),
+      p99: self.value_at_quantile(0.99),
+      p999: self.value_at_quantile(0.999),
+      buckets,
+    }
+    .serialize(serializer)
+  }
+}
+
 use deno_core::Op;
 use deno_core::OpFn;
 use std::collections::HashMap;
@@ -160,18 +411,30 @@ pub fn metrics_op(name: &'static str, op_fn: Box<OpFn>) -> Box<OpFn> {
     let bytes_sent_control = 0;
     let bytes_sent_data = 0;
 
+    // The op is only measured when per-op histograms are being recorded.
+    let per_op = PER_OP_ENABLED.with(|enabled| enabled.get());
+    let bytes_sent = if per_op {
+      payload.byte_length() as u64
+    } else {
+      0
+    };
+    let maybe_start = if per_op { Some(Instant::now()) } else { None };
     let op = (op_fn)(op_state.clone(), payload);
+    let maybe_sync_time = maybe_start.map(|start| start.elapsed());
 
     let op_state_ = op_state.clone();
     let mut s = op_state.borrow_mut();
     let runtime_metrics = s.borrow_mut::<RuntimeMetrics>();
 
-    let metrics = if let Some(metrics) = runtime_metrics.ops.get_mut(name) {
-      metrics
-    } else {
-      runtime_metrics.ops.insert(name, OpMetrics::default());
-      runtime_metrics.ops.get_mut(name).unwrap()
-    };
+    if per_op {
+      let histograms = runtime_metrics.per_op.entry(name).or_default();
+      histograms.bytes_sent.record(bytes_sent);
+      if let (Op::Sync(_), Some(sync_time)) = (&op, maybe_sync_time) {
+        histograms.sync_time.record(sync_time.as_nanos() as u64);
+      }
+    }
+
+    let metrics = runtime_metrics.op_metrics(name);
 
     use deno_core::futures::future::FutureExt;
 
@@ -186,8 +449,7 @@ pub fn metrics_op(name: &'static str, op_fn: Box<OpFn>) -> Box<OpFn> {
           .inspect(move |_resp| {
             let mut s = op_state_.borrow_mut();
             let runtime_metrics = s.borrow_mut::<RuntimeMetrics>();
-            let metrics = runtime_metrics.ops.get_mut(name).unwrap();
-            metrics.op_completed_async(0);
+            runtime_metrics.op_completed_async(name, maybe_start);
           })
           .boxed_local();
         Op::Async(fut)
@@ -198,8 +460,7 @@ pub fn metrics_op(name: &'static str, op_fn: Box<OpFn>) -> Box<OpFn> {
           .inspect(move |_resp| {
             let mut s = op_state_.borrow_mut();
             let runtime_metrics = s.borrow_mut::<RuntimeMetrics>();
-            let metrics = runtime_metrics.ops.get_mut(name).unwrap();
-            metrics.op_completed_async_unref(0);
+            runtime_metrics.op_completed_async_unref(name, maybe_start);
           })
           .boxed_local();
         Op::AsyncUnref(fut)
@@ -208,3 +469,35 @@ pub fn metrics_op(name: &'static str, op_fn: Box<OpFn>) -> Box<OpFn> {
     }
   })
 }
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+
+  #[test]
+  fn histogram_buckets() {
+    for value in (0..10_000).chain(vec![u64::MAX / 3, u64::MAX]) {
+      let index = Histogram::bucket_index(value);
+      let lower_bound = Histogram::bucket_lower_bound(index);
+      assert!(lower_bound <= value);
+      assert!(value - lower_bound <= lower_bound / SUB_BUCKETS);
+      assert_eq!(Histogram::bucket_index(lower_bound), index);
+    }
+  }
+
+  #[test]
+  fn histogram_quantiles() {
+    let mut histogram = Histogram::default();
+    for value in 1..=1000 {
+      histogram.record(value);
+    }
+    assert_eq!(histogram.count, 1000);
+    assert_eq!(histogram.min, 1);
+    assert_eq!(histogram.max, 1000);
+    let p50 = histogram.value_at_quantile(0.5);
+    assert!((448..=500).contains(&p50), "p50 = {}", p50);
+    let p99 = histogram.value_at_quantile(0.99);
+    assert!((896..=990).contains(&p99), "p99 = {}", p99);
+    assert_eq!(histogram.value_at_quantile(0.0), 1);
+  }
+}
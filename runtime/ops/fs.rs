@@ -14,6 +14,7 @@ use deno_core::Extension;
 use deno_core::OpState;
 use deno_core::RcRef;
 use deno_core::ResourceId;
+use deno_core::ZeroCopyBuf;
 use deno_crypto::rand::thread_rng;
 use deno_crypto::rand::Rng;
 use log::debug;
@@ -82,6 +83,10 @@ pub fn init() -> Extension {
       ("op_make_temp_dir_async", op_async(op_make_temp_dir_async)),
       ("op_make_temp_file_sync", op_sync(op_make_temp_file_sync)),
       ("op_make_temp_file_async", op_async(op_make_temp_file_async)),
+      ("op_read_file_sync", op_sync(op_read_file_sync)),
+      ("op_read_file_async", op_async(op_read_file_async)),
+      ("op_read_text_file_sync", op_sync(op_read_text_file_sync)),
+      ("op_read_text_file_async", op_async(op_read_text_file_async)),
       ("op_cwd", op_sync(op_cwd)),
       ("op_futime_sync", op_sync(op_futime_sync)),
       ("op_futime_async", op_async(op_futime_async)),
@@ -1657,6 +1662,78 @@ async fn op_utime_async(
   .unwrap()
 }
 
+/// Decodes the contents of a file the same way `Deno.core.decode` does, so
+/// `Deno.readTextFile` keeps stripping the BOM and replacing invalid UTF-8.
+fn decode_text_file(mut buf: Vec<u8>) -> String {
+  if buf.starts_with(b"\xef\xbb\xbf") {
+    buf.drain(..3);
+  }
+  String::from_utf8(buf)
+    .unwrap_or_else(|err| String::from_utf8_lossy(err.as_bytes()).into_owned())
+}
+
+// `std::fs::read` sizes its buffer from the metadata of the file, so files
+// are read into a single allocation without being copied as they grow.
+fn op_read_file_sync(
+  state: &mut OpState,
+  path: String,
+  _: (),
+) -> Result<ZeroCopyBuf, AnyError> {
+  let path = PathBuf::from(&path);
+  state.borrow_mut::<Permissions>().read.check(&path)?;
+  debug!("op_read_file_sync {}", path.display());
+  Ok(std::fs::read(&path)?.into())
+}
+
+async fn op_read_file_async(
+  state: Rc<RefCell<OpState>>,
+  path: String,
+  _: (),
+) -> Result<ZeroCopyBuf, AnyError> {
+  let path = PathBuf::from(&path);
+  state
+    .borrow_mut()
+    .borrow_mut::<Permissions>()
+    .read
+    .check(&path)?;
+  tokio::task::spawn_blocking(move || {
+    debug!("op_read_file_async {}", path.display());
+    Ok(std::fs::read(&path)?.into())
+  })
+  .await
+  .unwrap()
+}
+
+fn op_read_text_file_sync(
+  state: &mut OpState,
+  path: String,
+  _: (),
+) -> Result<String, AnyError> {
+  let path = PathBuf::from(&path);
+  state.borrow_mut::<Permissions>().read.check(&path)?;
+  debug!("op_read_text_file_sync {}", path.display());
+  Ok(decode_text_file(std::fs::read(&path)?))
+}
+
+async fn op_read_text_file_async(
+  state: Rc<RefCell<OpState>>,
+  path: String,
+  _: (),
+) -> Result<String, AnyError> {
+  let path = PathBuf::from(&path);
+  state
+    .borrow_mut()
+    .borrow_mut::<Permissions>()
+    .read
+    .check(&path)?;
+  tokio::task::spawn_blocking(move || {
+    debug!("op_read_text_file_async {}", path.display());
+    Ok(decode_text_file(std::fs::read(&path)?))
+  })
+  .await
+  .unwrap()
+}
+
 fn op_cwd(state: &mut OpState, _args: (), _: ()) -> Result<String, AnyError> {
   let path = current_dir()?;
   state
@@ -1,11 +1,12 @@
 // Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
 
+use deno_core::error::generic_error;
 use deno_core::error::null_opbuf;
 use deno_core::error::resource_unavailable;
 use deno_core::error::AnyError;
 use deno_core::error::{bad_resource_id, not_supported};
 use deno_core::op_async;
-use deno_core::op_sync;
+use deno_core::op_sync_fast;
 use deno_core::AsyncMutFuture;
 use deno_core::AsyncRefCell;
 use deno_core::CancelHandle;
@@ -28,10 +29,22 @@ use tokio::io::AsyncRead;
 use tokio::io::AsyncReadExt;
 use tokio::io::AsyncWrite;
 use tokio::io::AsyncWriteExt;
+use tokio::net::tcp;
 use tokio::process;
 
 #[cfg(unix)]
 use std::os::unix::io::FromRawFd;
+#[cfg(unix)]
+use tokio::net::unix;
+
+#[cfg(target_os = "linux")]
+use std::os::unix::io::AsRawFd;
+#[cfg(target_os = "linux")]
+use std::os::unix::io::RawFd;
+#[cfg(target_os = "linux")]
+use tokio::io::unix::AsyncFd;
+#[cfg(target_os = "linux")]
+use tokio::io::Interest;
 
 #[cfg(windows)]
 use std::os::windows::io::FromRawHandle;
@@ -97,9 +110,10 @@ pub fn init() -> Extension {
     .ops(vec![
       ("op_read_async", op_async(op_read_async)),
       ("op_write_async", op_async(op_write_async)),
-      ("op_read_sync", op_sync(op_read_sync)),
-      ("op_write_sync", op_sync(op_write_sync)),
+      ("op_read_sync", op_sync_fast(op_read_sync)),
+      ("op_write_sync", op_sync_fast(op_write_sync)),
       ("op_shutdown", op_async(op_shutdown)),
+      ("op_copy_from_file", op_async(op_copy_from_file)),
     ])
     .build()
 }
@@ -312,6 +326,20 @@ impl StdFileResource {
     }
   }
 
+  fn borrow_file(
+    self: &Rc<Self>,
+  ) -> Result<
+    AsyncMutFuture<(Option<tokio::fs::File>, Option<FileMetadata>)>,
+    AnyError,
+  > {
+    match self.fs_file {
+      Some(_) => {
+        Ok(RcRef::map(self, |r| r.fs_file.as_ref().unwrap()).borrow_mut())
+      }
+      None => Err(resource_unavailable()),
+    }
+  }
+
   async fn write(self: &Rc<Self>, buf: &[u8]) -> Result<usize, AnyError> {
     if self.fs_file.is_some() {
       let mut fs_file = RcRef::map(&*self, |r| r.fs_file.as_ref().unwrap())
@@ -496,3 +524,262 @@ async fn op_shutdown(
   }
   Ok(())
 }
+
+/// A writer that `op_copy_from_file` can copy to with `sendfile`.
+trait CopyTarget: AsyncWrite + Unpin {
+  #[cfg(target_os = "linux")]
+  fn raw_fd(&self) -> RawFd;
+
+  /// Whether `raw_fd` is a non-blocking socket that tokio polls. `sendfile`
+  /// is called on those from the event loop, and waits for them to become
+  /// writable with the reactor. Other targets block, so their `sendfile`
+  /// calls run on the blocking pool.
+  #[cfg(target_os = "linux")]
+  const IS_SOCKET: bool;
+}
+
+impl CopyTarget for tokio::fs::File {
+  #[cfg(target_os = "linux")]
+  fn raw_fd(&self) -> RawFd {
+    self.as_raw_fd()
+  }
+
+  #[cfg(target_os = "linux")]
+  const IS_SOCKET: bool = false;
+}
+
+impl CopyTarget for tcp::OwnedWriteHalf {
+  #[cfg(target_os = "linux")]
+  fn raw_fd(&self) -> RawFd {
+    self.as_ref().as_raw_fd()
+  }
+
+  #[cfg(target_os = "linux")]
+  const IS_SOCKET: bool = true;
+}
+
+#[cfg(unix)]
+impl CopyTarget for unix::OwnedWriteHalf {
+  #[cfg(target_os = "linux")]
+  fn raw_fd(&self) -> RawFd {
+    self.as_ref().as_raw_fd()
+  }
+
+  #[cfg(target_os = "linux")]
+  const IS_SOCKET: bool = true;
+}
+
+/// Copies the rest of the file `src_rid` to `dst_rid`, which may be a file,
+/// stdio or a connection, without moving the data through JS. This is what
+/// `Deno.copy` does when it is given a file to read from.
+///
+/// Closing `dst_rid` aborts the copy.
+async fn op_copy_from_file(
+  state: Rc<RefCell<OpState>>,
+  src_rid: ResourceId,
+  dst_rid: ResourceId,
+) -> Result<u64, AnyError> {
+  if src_rid == dst_rid {
+    return Err(generic_error("Cannot copy a file to itself"));
+  }
+  let (src, dst) = {
+    let state = state.borrow();
+    let src = state
+      .resource_table
+      .get::<StdFileResource>(src_rid)
+      .ok_or_else(bad_resource_id)?;
+    let dst = state
+      .resource_table
+      .get_any(dst_rid)
+      .ok_or_else(bad_resource_id)?;
+    (src, dst)
+  };
+  let mut src_file = src.borrow_file()?.await;
+  let src_file = src_file.0.as_mut().unwrap();
+
+  // Connections only cancel their reads when they are closed, but a copy to
+  // one can take arbitrarily long, so it is canceled too.
+  if let Some(s) = dst.downcast_rc::<TcpStreamResource>() {
+    let mut wr = s.wr_borrow_mut().await;
+    copy_from_file(src_file, &mut *wr)
+      .try_or_cancel(s.cancel_handle())
+      .await
+  } else if let Some(s) = dst.downcast_rc::<TlsStreamResource>() {
+    // The data has to be encrypted, so it can't stay in the kernel.
+    let mut wr = s.wr_borrow_mut().await;
+    async {
+      let n = tokio::io::copy(src_file, &mut *wr).await?;
+      wr.flush().await?;
+      Ok::<_, AnyError>(n)
+    }
+    .try_or_cancel(s.cancel_handle())
+    .await
+  } else if let Some(s) = dst.downcast_rc::<StdFileResource>() {
+    let mut dst_file = s.borrow_file()?.await;
+    copy_from_file(src_file, dst_file.0.as_mut().unwrap())
+      .try_or_cancel(RcRef::map(&s, |r| &r.cancel))
+      .await
+  } else {
+    #[cfg(unix)]
+    if let Some(s) = dst.downcast_rc::<UnixStreamResource>() {
+      let mut wr = s.wr_borrow_mut().await;
+      return copy_from_file(src_file, &mut *wr)
+        .try_or_cancel(s.cancel_handle())
+        .await;
+    }
+    Err(not_supported())
+  }
+}
+
+async fn copy_from_file<W: CopyTarget>(
+  src: &mut tokio::fs::File,
+  dst: &mut W,
+) -> Result<u64, AnyError> {
+  #[cfg(target_os = "linux")]
+  let copied = if W::IS_SOCKET {
+    sendfile_to_socket(src.as_raw_fd(), dst.raw_fd()).await?
+  } else {
+    sendfile_to_file(src.as_raw_fd(), dst.raw_fd()).await?
+  };
+  #[cfg(not(target_os = "linux"))]
+  let copied = 0;
+  // Copies whatever `sendfile` left, which is nothing unless it doesn't
+  // support the pair of file descriptors. It stops at the offset `sendfile`
+  // reached, since the two share the file position of `src`.
+  let n = tokio::io::copy(src, dst).await?;
+  dst.flush().await?;
+  Ok(copied + n)
+}
+
+/// The most that `sendfile` copies in one call to a socket.
+#[cfg(target_os = "linux")]
+const SENDFILE_MAX: usize = 0x7fff_f000;
+
+/// The most that `sendfile` copies in one call to a file. The op can only be
+/// canceled between calls, so this is kept much smaller than `SENDFILE_MAX`.
+#[cfg(target_os = "linux")]
+const SENDFILE_FILE_CHUNK: usize = 1 << 24;
+
+/// A duplicate of a file descriptor, which is closed when it is dropped.
+#[cfg(target_os = "linux")]
+struct DupFd(RawFd);
+
+#[cfg(target_os = "linux")]
+impl DupFd {
+  fn new(fd: RawFd) -> std::io::Result<Self> {
+    let fd = unsafe { libc::fcntl(fd, libc::F_DUPFD_CLOEXEC, 0) };
+    if fd < 0 {
+      return Err(std::io::Error::last_os_error());
+    }
+    Ok(Self(fd))
+  }
+}
+
+#[cfg(target_os = "linux")]
+impl AsRawFd for DupFd {
+  fn as_raw_fd(&self) -> RawFd {
+    self.0
+  }
+}
+
+#[cfg(target_os = "linux")]
+impl Drop for DupFd {
+  fn drop(&mut self) {
+    unsafe { libc::close(self.0) };
+  }
+}
+
+/// Calls `sendfile` once, retrying it if it is interrupted. Returns 0 at the
+/// end of the file.
+#[cfg(target_os = "linux")]
+fn sendfile_once(
+  src: RawFd,
+  dst: RawFd,
+  count: usize,
+) -> std::io::Result<usize> {
+  loop {
+    let n = unsafe { libc::sendfile(dst, src, std::ptr::null_mut(), count) };
+    if n >= 0 {
+      return Ok(n as usize);
+    }
+    let err = std::io::Error::last_os_error();
+    if err.kind() != std::io::ErrorKind::Interrupted {
+      return Err(err);
+    }
+  }
+}
+
+/// Whether `sendfile` failed because it doesn't support the pair of file
+/// descriptors, rather than because the copy failed.
+#[cfg(target_os = "linux")]
+fn is_sendfile_unsupported(err: &std::io::Error) -> bool {
+  matches!(err.raw_os_error(), Some(libc::EINVAL) | Some(libc::ENOSYS))
+}
+
+/// Copies the rest of the file `src` to the non-blocking socket `dst` with
+/// `sendfile`, so the data never leaves the kernel. Returns how much was
+/// copied, which is less than the rest of the file only if `sendfile`
+/// doesn't support the pair of file descriptors.
+#[cfg(target_os = "linux")]
+async fn sendfile_to_socket(src: RawFd, dst: RawFd) -> Result<u64, AnyError> {
+  // tokio already polls `dst` for the stream it belongs to, and a file
+  // descriptor can only be registered with the reactor once, so a duplicate
+  // of it is registered the first time the socket is full.
+  let mut writable: Option<AsyncFd<DupFd>> = None;
+  let mut total = 0;
+  loop {
+    let result = match &writable {
+      None => sendfile_once(src, dst, SENDFILE_MAX),
+      Some(fd) => {
+        let mut guard = fd.writable().await?;
+        match guard.try_io(|_| sendfile_once(src, dst, SENDFILE_MAX)) {
+          Ok(result) => result,
+          // Still full. The guard cleared the readiness, so the next
+          // `writable()` waits for the socket to drain.
+          Err(_would_block) => continue,
+        }
+      }
+    };
+    match result {
+      Ok(0) => return Ok(total),
+      Ok(n) => total += n as u64,
+      Err(err) if err.kind() == std::io::ErrorKind::WouldBlock => {
+        writable = Some(AsyncFd::with_interest(
+          DupFd::new(dst)?,
+          Interest::WRITABLE,
+        )?);
+      }
+      Err(err) if total == 0 && is_sendfile_unsupported(&err) => return Ok(0),
+      Err(err) => return Err(err.into()),
+    }
+  }
+}
+
+/// Like `sendfile_to_socket`, but for a blocking destination like a file or
+/// a pipe, so every call runs on the blocking pool.
+#[cfg(target_os = "linux")]
+async fn sendfile_to_file(src: RawFd, dst: RawFd) -> Result<u64, AnyError> {
+  let mut total = 0;
+  loop {
+    // If the op is canceled, the resources that own `src` and `dst` may be
+    // closed while the call is still running, so it gets its own duplicates.
+    let src = DupFd::new(src)?;
+    let dst = DupFd::new(dst)?;
+    let result = tokio::task::spawn_blocking(move || {
+      sendfile_once(src.0, dst.0, SENDFILE_FILE_CHUNK)
+    })
+    .await
+    .unwrap();
+    match result {
+      Ok(0) => return Ok(total),
+      Ok(n) => total += n as u64,
+      // A non-blocking pipe that is full is left to the plain copy, like
+      // descriptors that `sendfile` doesn't support.
+      Err(err) if err.kind() == std::io::ErrorKind::WouldBlock => {
+        return Ok(total)
+      }
+      Err(err) if total == 0 && is_sendfile_unsupported(&err) => return Ok(0),
+      Err(err) => return Err(err.into()),
+    }
+  }
+}
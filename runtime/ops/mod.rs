@@ -9,6 +9,7 @@ pub mod permissions;
 pub mod plugin;
 pub mod process;
 pub mod runtime;
+pub mod shared_channel;
 pub mod signal;
 pub mod tty;
 mod utils;
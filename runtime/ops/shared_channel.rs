@@ -0,0 +1,135 @@
+// Copyright 2018-2021 the Deno authors. All rights reserved. MIT license.
+
+//! Lets the receiver of a `Deno.SharedChannel` wait for a message without
+//! blocking its event loop. `Atomics.notify()` only wakes the threads that
+//! block in `Atomics.wait()`, so senders wake the receivers that wait here
+//! with `op_shared_channel_notify`, see `runtime/js/11_shared_channel.js`.
+
+use deno_core::error::null_opbuf;
+use deno_core::error::type_error;
+use deno_core::error::AnyError;
+use deno_core::futures::channel::oneshot;
+use deno_core::op_async;
+use deno_core::op_sync;
+use deno_core::Extension;
+use deno_core::OpState;
+use deno_core::ZeroCopyBuf;
+use serde::Deserialize;
+use std::cell::RefCell;
+use std::collections::HashMap;
+use std::rc::Rc;
+use std::sync::atomic::AtomicI32;
+use std::sync::atomic::Ordering;
+use std::sync::Mutex;
+use std::time::Duration;
+
+/// The index of the word of the header of a channel that is incremented on
+/// every change of its state. Keep in sync with `11_shared_channel.js`.
+const SIGNAL: usize = 4;
+
+lazy_static::lazy_static! {
+  /// The receivers that wait for a change of state of a channel, by the
+  /// address of its header, which is the same in every worker.
+  static ref WAITERS: Mutex<HashMap<usize, Vec<oneshot::Sender<()>>>> =
+    Mutex::new(HashMap::new());
+}
+
+pub fn init() -> Extension {
+  Extension::builder()
+    .ops(vec![
+      ("op_shared_channel_wait", op_async(op_shared_channel_wait)),
+      (
+        "op_shared_channel_notify",
+        op_sync(op_shared_channel_notify),
+      ),
+    ])
+    .build()
+}
+
+/// Returns the key of the channel whose header is `header` in `WAITERS`.
+fn channel_key(header: &ZeroCopyBuf) -> Result<usize, AnyError> {
+  let address = header.as_ptr() as usize;
+  if header.len() < (SIGNAL + 1) * 4 || address % 4 != 0 {
+    return Err(type_error("Invalid shared channel header"));
+  }
+  Ok(address)
+}
+
+fn load_signal(header: &ZeroCopyBuf) -> i32 {
+  // SAFETY: `channel_key()` checked that the word is in bounds and aligned,
+  // and `header` keeps the shared memory alive.
+  let signal =
+    unsafe { &*(header.as_ptr().add(SIGNAL * 4) as *const AtomicI32) };
+  signal.load(Ordering::SeqCst)
+}
+
+/// Drops the waiters of `key` whose receiver is gone.
+fn forget_waiters(key: usize) {
+  let mut waiters = WAITERS.lock().unwrap();
+  if let Some(senders) = waiters.get_mut(&key) {
+    senders.retain(|sender| !sender.is_canceled());
+    if senders.is_empty() {
+      waiters.remove(&key);
+    }
+  }
+}
+
+#[derive(Deserialize)]
+pub struct WaitArgs {
+  signal: i32,
+  timeout: Option<u64>,
+}
+
+/// Waits until the signal word of the channel is no longer `args.signal`, or
+/// until `args.timeout` milliseconds pass, in which case it returns `false`.
+async fn op_shared_channel_wait(
+  state: Rc<RefCell<OpState>>,
+  args: WaitArgs,
+  header: Option<ZeroCopyBuf>,
+) -> Result<bool, AnyError> {
+  super::check_unstable2(&state, "Deno.SharedChannel");
+  let header = header.ok_or_else(null_opbuf)?;
+  let key = channel_key(&header)?;
+
+  let (sender, receiver) = oneshot::channel();
+  WAITERS.lock().unwrap().entry(key).or_default().push(sender);
+  // A change of state that happened before the waiter was registered didn't
+  // notify it.
+  if load_signal(&header) != args.signal {
+    drop(receiver);
+    forget_waiters(key);
+    return Ok(true);
+  }
+
+  let changed = match args.timeout {
+    Some(timeout) => {
+      tokio::time::timeout(Duration::from_millis(timeout), receiver)
+        .await
+        .is_ok()
+    }
+    None => {
+      let _ = receiver.await;
+      true
+    }
+  };
+  if !changed {
+    forget_waiters(key);
+  }
+  Ok(changed)
+}
+
+/// Wakes the receivers that wait for a change of state of the channel.
+fn op_shared_channel_notify(
+  state: &mut OpState,
+  _: (),
+  header: Option<ZeroCopyBuf>,
+) -> Result<(), AnyError> {
+  super::check_unstable(state, "Deno.SharedChannel");
+  let header = header.ok_or_else(null_opbuf)?;
+  let key = channel_key(&header)?;
+  let maybe_senders = WAITERS.lock().unwrap().remove(&key);
+  for sender in maybe_senders.into_iter().flatten() {
+    let _ = sender.send(());
+  }
+  Ok(())
+}
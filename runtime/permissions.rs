@@ -551,6 +551,17 @@ impl UnaryPermission<NetDescriptor> {
     result
   }
 
+  /// Like `check_url`, but only reports whether access to the host of `url`
+  /// is granted, and never prompts.
+  pub fn query_url(&self, url: &url::Url) -> PermissionState {
+    match url.host_str() {
+      Some(hostname) => {
+        self.query(Some(&(hostname, url.port_or_known_default())))
+      }
+      None => PermissionState::Denied,
+    }
+  }
+
   pub fn check_url(&mut self, url: &url::Url) -> Result<(), AnyError> {
     let hostname = url
       .host_str()
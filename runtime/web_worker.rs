@@ -337,6 +337,7 @@ impl WebWorker {
         ops::permissions::init(),
         ops::plugin::init(),
         ops::process::init(),
+        ops::shared_channel::init(),
         ops::signal::init(),
         ops::tty::init(),
         deno_http::init(),
@@ -360,6 +361,7 @@ impl WebWorker {
       extensions,
       ..Default::default()
     });
+    metrics::observe_event_loop(&mut js_runtime);
 
     if let Some(server) = options.maybe_inspector_server.clone() {
       let inspector = js_runtime.inspector();
@@ -128,6 +128,7 @@ impl MainWorker {
       ops::permissions::init(),
       ops::plugin::init(),
       ops::process::init(),
+      ops::shared_channel::init(),
       ops::signal::init(),
       ops::tty::init(),
       deno_http::init(),
@@ -145,6 +146,7 @@ impl MainWorker {
       extensions,
       ..Default::default()
     });
+    metrics::observe_event_loop(&mut js_runtime);
 
     if let Some(server) = options.maybe_inspector_server.clone() {
       let inspector = js_runtime.inspector();